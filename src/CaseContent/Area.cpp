@@ -35,7 +35,6 @@
 
 Area::Area(XmlReader *pReader)
 {
-    pStartLocation = NULL;
     pCurrentLocation = NULL;
     pTargetLocation = NULL;
     shouldSwapLocations = false;
@@ -55,12 +54,7 @@ Area::~Area()
 
 Location * Area::GetStartLocation()
 {
-    if (pStartLocation == NULL)
-    {
-        pStartLocation = Case::GetInstance()->GetContentManager()->GetLocationFromId(GetStartLocationId());
-    }
-
-    return pStartLocation;
+    return Case::GetInstance()->GetContentManager()->GetLocationFromId(GetStartLocationId());
 }
 
 void Area::Begin()
@@ -174,6 +168,8 @@ void Area::SwapLocations(Location *pNewLocation, const string &transitionId, boo
 
     if (pCurrentLocation != NULL)
     {
+        // This is also our cue to release any locations we haven't been to in a while.
+        Case::GetInstance()->GetContentManager()->EnterLocation(pCurrentLocation);
         EventProviders::GetLocationEventProvider()->RegisterListener(this);
         swappedLocations = !isLoadingFromSaveFile;
     }
@@ -41,7 +41,6 @@ class Area : public LocationEventListener
 public:
     Area()
     {
-        pStartLocation = NULL;
         pCurrentLocation = NULL;
         pTargetLocation = NULL;
         shouldSwapLocations = false;
@@ -62,6 +61,7 @@ public:
     void SetStartLocationId(const string &startLocationId) { this->startLocationId = startLocationId; }
 
     bool GetIsFinished() const { return pCurrentLocation == NULL; }
+    bool GetCanQuickSave() const { return pCurrentLocation != NULL && !shouldSwapLocations && pCurrentLocation->GetCanQuickSave(); }
 
     void Begin();
     void Begin(const string &startLocationId, bool isLoadingFromSaveFile);
@@ -80,7 +80,6 @@ private:
     void SwapLocations(Location *pNewLocation, const string &transitionId, bool isLoadingFromSaveFile);
     void LoadFromSaveFile(XmlReader *pReader);
 
-    Location *pStartLocation;
     Location *pCurrentLocation;
     string transitionId;
 
@@ -32,6 +32,7 @@
 #include "../mli_audio.h"
 #include "../MouseHelper.h"
 #include "../KeyboardHelper.h"
+#include "../Profiler.h"
 #include "../globals.h"
 #include "../State.h"
 #include "../XmlReader.h"
@@ -93,7 +94,7 @@ void Conversation::UnlockCondition::LoadFromXmlCore(XmlReader *pReader)
 
 bool Conversation::FlagSetUnlockCondition::GetIsConditionMet()
 {
-    return Case::GetInstance()->GetFlagManager()->IsFlagSet(flagId);
+    return Case::GetInstance()->GetFlagManager()->IsFlagSet(flagIndex);
 }
 
 bool Conversation::FlagSetUnlockCondition::Equals(UnlockCondition *pOtherCondition)
@@ -105,7 +106,7 @@ bool Conversation::FlagSetUnlockCondition::Equals(UnlockCondition *pOtherConditi
         return false;
     }
 
-    return this->flagId == pOtherFlagSetUnlockCondition->flagId;
+    return this->flagIndex == pOtherFlagSetUnlockCondition->flagIndex;
 }
 
 void Conversation::FlagSetUnlockCondition::SaveToXml(XmlWriter *pWriter)
@@ -126,6 +127,7 @@ Conversation::UnlockCondition * Conversation::FlagSetUnlockCondition::Clone()
 Conversation::FlagSetUnlockCondition::FlagSetUnlockCondition(const string &flagId)
 {
     this->flagId = flagId;
+    this->flagIndex = Case::GetInstance()->GetFlagManager()->GetFlagIndex(flagId);
 }
 
 Conversation::FlagSetUnlockCondition::FlagSetUnlockCondition(XmlReader *pReader)
@@ -136,6 +138,8 @@ Conversation::FlagSetUnlockCondition::FlagSetUnlockCondition(XmlReader *pReader)
 
     flagId = pReader->ReadTextElement("FlagId");
     pReader->EndElement();
+
+    flagIndex = Case::GetInstance()->GetFlagManager()->GetFlagIndex(flagId);
 }
 
 bool Conversation::PartnerPresentUnlockCondition::GetIsConditionMet()
@@ -239,8 +243,8 @@ bool Conversation::GetHasBeenUnlocked() const
 bool Conversation::GetIsNotificationNext()
 {
     return
-        (int)actionList.size() > pState->GetActionIndex() + 1 &&
-        dynamic_cast<NotificationAction *>(actionList[pState->GetActionIndex() + 1]) != NULL;
+        (int)compiledActionList.size() > pState->GetActionIndex() + 1 &&
+        compiledActionList[pState->GetActionIndex() + 1].isNotification;
 }
 
 void Conversation::Begin(State *pState)
@@ -269,10 +273,24 @@ void Conversation::Begin(State *pState)
 
     Case::GetInstance()->GetAudioManager()->LowerMusicVolumeForDialog();
     Case::GetInstance()->GetAudioManager()->LowerAmbianceVolumeForDialog();
+
+    // If this conversation moves the player somewhere else, then we'll want
+    // that location's resources ahead of anything else we might prefetch.
+    for (unsigned int i = 0; i < actionList.size(); i++)
+    {
+        MoveToLocationAction *pMoveToLocationAction = dynamic_cast<MoveToLocationAction *>(actionList[i]);
+
+        if (pMoveToLocationAction != NULL)
+        {
+            Case::GetInstance()->GetResidencyManager()->PrioritizeLocation(pMoveToLocationAction->newLocationId);
+        }
+    }
 }
 
 void Conversation::Update(int delta)
 {
+    Profiler::Zone zone("Conversation::Update");
+
     if (GetIsFinished())
     {
         if (pLastContinuousAction != NULL)
@@ -339,18 +357,25 @@ void Conversation::Update(int delta)
             pState->ClearActionIndexSet();
         }
 
-        while (pState->GetActionIndex() < (int)actionList.size())
+        while (pState->GetActionIndex() < (int)compiledActionList.size())
         {
-            Action *pCurrentAction = actionList[pState->GetActionIndex()];
+            const CompiledAction &currentAction = compiledActionList[pState->GetActionIndex()];
 
-            if (pCurrentAction->GetIsSingleAction())
+            if (currentAction.opcode == ActionOpcodeNoOp)
+            {
+                // Nothing to do - just move on to the next action.
+            }
+            else if (currentAction.opcode == ActionOpcodeJump)
             {
-                SingleAction *pSingleAction = dynamic_cast<SingleAction *>(pCurrentAction);
-                pSingleAction->Execute(pState);
+                pState->SetActionIndex(currentAction.jumpIndex);
+            }
+            else if (currentAction.opcode == ActionOpcodeExecute)
+            {
+                currentAction.pSingleAction->Execute(pState);
             }
             else
             {
-                pCurrentContinuousAction = dynamic_cast<ContinuousAction *>(pCurrentAction);
+                pCurrentContinuousAction = currentAction.pContinuousAction;
 
                 if (pCurrentContinuousAction->GetShouldSkip())
                 {
@@ -553,6 +578,44 @@ void Conversation::LoadFromXmlCore(XmlReader *pReader)
     }
 
     pReader->EndElement();
+
+    CompileActionList();
+}
+
+void Conversation::CompileActionList()
+{
+    compiledActionList.clear();
+    compiledActionList.resize(actionList.size());
+
+    for (unsigned int i = 0; i < actionList.size(); i++)
+    {
+        CompiledAction *pCompiledAction = &compiledActionList[i];
+
+        if (actionList[i]->GetIsSingleAction())
+        {
+            pCompiledAction->pSingleAction = dynamic_cast<SingleAction *>(actionList[i]);
+
+            if (pCompiledAction->pSingleAction->GetIsNoOp())
+            {
+                pCompiledAction->opcode = ActionOpcodeNoOp;
+            }
+            else if (pCompiledAction->pSingleAction->GetUnconditionalJumpIndex() >= 0)
+            {
+                pCompiledAction->opcode = ActionOpcodeJump;
+                pCompiledAction->jumpIndex = pCompiledAction->pSingleAction->GetUnconditionalJumpIndex();
+            }
+            else
+            {
+                pCompiledAction->opcode = ActionOpcodeExecute;
+            }
+        }
+        else
+        {
+            pCompiledAction->opcode = ActionOpcodeContinuous;
+            pCompiledAction->pContinuousAction = dynamic_cast<ContinuousAction *>(actionList[i]);
+            pCompiledAction->isNotification = dynamic_cast<NotificationAction *>(actionList[i]) != NULL;
+        }
+    }
 }
 
 Conversation::Action * Conversation::GetActionForNextElement(XmlReader *pReader)
@@ -1002,9 +1065,9 @@ void Conversation::CharacterChangeAction::SwapCharacters()
 
 void Conversation::SetFlagAction::Execute(State *pState)
 {
-    if (!Case::GetInstance()->GetFlagManager()->IsFlagSet(flagId))
+    if (!Case::GetInstance()->GetFlagManager()->IsFlagSet(flagIndex))
     {
-        Case::GetInstance()->GetFlagManager()->SetFlag(flagId);
+        Case::GetInstance()->GetFlagManager()->SetFlag(flagIndex);
     }
     else if (pState->GetCurrentConversation()->GetIsNotificationNext())
     {
@@ -1019,6 +1082,8 @@ Conversation::SetFlagAction::SetFlagAction(XmlReader *pReader)
     pReader->StartElement("SetFlagAction");
     flagId = pReader->ReadTextElement("FlagId");
     pReader->EndElement();
+
+    flagIndex = Case::GetInstance()->GetFlagManager()->GetFlagIndex(flagId);
 }
 
 void Conversation::BranchOnConditionAction::Execute(State *pState)
@@ -1285,7 +1350,7 @@ void Conversation::ShowDialogAction::SetIsFinished(bool isFinished)
 
         if (!hasBeenSeen)
         {
-            gDialogsSeenList.push_back(id);
+            MarkDialogSeen(id);
 
             // Multiple ShowDialogActions can have the same ID if they're effectively the same as the others (same speaker, same dialog, same file path, etc.),
             // so we want to set *all* of those as having been seen, not just this one.
@@ -1513,18 +1578,7 @@ void Conversation::ShowDialogAction::LoadFromXmlCore(XmlReader *pReader)
 
     id = pReader->ReadTextElement("Id");
 
-    bool dialogHasBeenSeen = false;
-
-    for (unsigned int i = 0; i < gDialogsSeenList.size(); i++)
-    {
-        if (gDialogsSeenList[i] == id)
-        {
-            dialogHasBeenSeen = true;
-            break;
-        }
-    }
-
-    hasBeenSeen = dialogHasBeenSeen;
+    hasBeenSeen = IsDialogSeen(id);
 
     speakerPosition = StringToCharacterPosition(pReader->ReadTextElement("SpeakerPosition"));
     rawDialog = pReader->ReadTextElement("RawDialog");
@@ -1768,7 +1822,7 @@ Conversation::EndMustPresentEvidenceAction::EndMustPresentEvidenceAction(XmlRead
 
 void Conversation::EnableConversationAction::Execute(State *pState)
 {
-    Conversation *pConversation = Case::GetInstance()->GetContentManager()->GetConversationFromId(conversationId);
+    Conversation *pConversation = Case::GetInstance()->GetContentManager()->GetConversationFromId(conversationHandle);
 
     if (!pConversation->GetIsEnabled())
     {
@@ -1786,6 +1840,7 @@ Conversation::EnableConversationAction::EnableConversationAction(XmlReader *pRea
 {
     pReader->StartElement("EnableConversationAction");
     conversationId = pReader->ReadTextElement("ConversationId");
+    conversationHandle = SymbolTable::Intern(conversationId);
     pReader->EndElement();
 }
 
@@ -2573,7 +2628,7 @@ Interrogation::BeginInterrogationRepeatAction::~BeginInterrogationRepeatAction()
 
 bool Interrogation::ShowInterrogationAction::GetShouldSkip()
 {
-    return this->conditionFlag.length() > 0 && !Case::GetInstance()->GetFlagManager()->IsFlagSet(this->conditionFlag);
+    return this->conditionFlag.length() > 0 && !Case::GetInstance()->GetFlagManager()->IsFlagSet(this->conditionFlagIndex);
 }
 
 void Interrogation::ShowInterrogationAction::GoToNext(State *pState)
@@ -2796,6 +2851,7 @@ void Interrogation::ShowInterrogationAction::LoadFromXmlCore(XmlReader *pReader)
     if (pReader->ElementExists("ConditionFlag"))
     {
         conditionFlag = pReader->ReadTextElement("ConditionFlag");
+        conditionFlagIndex = Case::GetInstance()->GetFlagManager()->GetFlagIndex(conditionFlag);
     }
 
     previousInterrogationIndex = pReader->ReadIntElement("PreviousInterrogationIndex");
@@ -34,6 +34,7 @@
 #include "Notification.h"
 #include "../Condition.h"
 #include "../enums.h"
+#include "../SymbolTable.h"
 #include "../Events/DialogEventProvider.h"
 #include "../Events/ButtonArrayEventProvider.h"
 #include "../UserInterface/SkipArrow.h"
@@ -54,6 +55,7 @@ friend class ContentManager;
 
 protected:
     class Action;
+    class SingleAction;
     class ContinuousAction;
     class ShowDialogAction;
 
@@ -99,6 +101,7 @@ public:
         FlagSetUnlockCondition(XmlReader *pReader);
 
         string flagId;
+        unsigned int flagIndex;
     };
 
     class PartnerPresentUnlockCondition : public UnlockCondition
@@ -182,8 +185,39 @@ protected:
     void Initialize();
     void LoadFromXmlCore(XmlReader *pReader);
     virtual Action * GetActionForNextElement(XmlReader *pReader);
+    void CompileActionList();
+
+    enum ActionOpcode
+    {
+        ActionOpcodeNoOp,
+        ActionOpcodeJump,
+        ActionOpcodeExecute,
+        ActionOpcodeContinuous,
+    };
+
+    // The action list, flattened at load time so that running it needs
+    // neither RTTI nor virtual calls for actions that only move the action index.
+    class CompiledAction
+    {
+    public:
+        CompiledAction()
+        {
+            opcode = ActionOpcodeNoOp;
+            jumpIndex = -1;
+            isNotification = false;
+            pSingleAction = NULL;
+            pContinuousAction = NULL;
+        }
+
+        ActionOpcode opcode;
+        int jumpIndex;
+        bool isNotification;
+        SingleAction *pSingleAction;
+        ContinuousAction *pContinuousAction;
+    };
 
     vector<Action *> actionList;
+    vector<CompiledAction> compiledActionList;
     ContinuousAction *pCurrentContinuousAction;
 
     string id;
@@ -229,6 +263,9 @@ protected:
         }
 
         virtual void Execute(State *pState) = 0;
+
+        virtual bool GetIsNoOp() { return false; }
+        virtual int GetUnconditionalJumpIndex() { return -1; }
     };
 
     class ContinuousAction : public Action
@@ -323,6 +360,7 @@ protected:
         SetFlagAction(XmlReader *pReader);
 
         string flagId;
+        unsigned int flagIndex;
     };
 
     class BranchOnConditionAction : public SingleAction
@@ -361,6 +399,7 @@ protected:
         void SetEndIndex(int endIndex) { this->endIndex = endIndex; }
 
         virtual void Execute(State *pState);
+        virtual int GetUnconditionalJumpIndex() { return GetEndIndex(); }
 
     private:
         BranchIfTrueAction(XmlReader *pReader);
@@ -379,6 +418,7 @@ protected:
         void SetEndIndex(int endIndex) { this->endIndex = endIndex; }
 
         virtual void Execute(State *pState);
+        virtual int GetUnconditionalJumpIndex() { return GetEndIndex(); }
 
     private:
         BranchIfFalseAction(XmlReader *pReader);
@@ -394,6 +434,7 @@ protected:
 
     public:
         virtual void Execute(State *pState);
+        virtual bool GetIsNoOp() { return true; }
 
     private:
         EndBranchOnConditionAction(XmlReader *pReader);
@@ -589,6 +630,7 @@ protected:
         void SetAfterWrongEvidencePresentedIndex(int afterWrongEvidencePresentedIndex) { this->afterWrongEvidencePresentedIndex = afterWrongEvidencePresentedIndex; }
 
         virtual void Execute(State *pState);
+        virtual int GetUnconditionalJumpIndex() { return GetAfterWrongEvidencePresentedIndex(); }
 
     private:
         SkipWrongEvidencePresentedAction(XmlReader *pReader);
@@ -627,6 +669,7 @@ protected:
         void SetAfterEndRequestedIndex(int afterEndRequestedIndex) { this->afterEndRequestedIndex = afterEndRequestedIndex; }
 
         virtual void Execute(State *pState);
+        virtual int GetUnconditionalJumpIndex() { return GetAfterEndRequestedIndex(); }
 
     private:
         SkipEndRequestedAction(XmlReader *pReader);
@@ -640,6 +683,7 @@ protected:
 
     public:
         virtual void Execute(State *pState);
+        virtual bool GetIsNoOp() { return true; }
 
     private:
         BeginEndRequestedAction(XmlReader *pReader);
@@ -662,6 +706,7 @@ protected:
 
     public:
         virtual void Execute(State *pState);
+        virtual bool GetIsNoOp() { return true; }
 
     private:
         EndMustPresentEvidenceAction(XmlReader *pReader);
@@ -678,6 +723,7 @@ protected:
         EnableConversationAction(XmlReader *pReader);
 
         string conversationId;
+        IdHandle conversationHandle;
     };
 
     class EnableEvidenceAction : public SingleAction
@@ -1033,6 +1079,7 @@ protected:
 
     public:
         virtual void Execute(State *pState);
+        virtual int GetUnconditionalJumpIndex() { return exitIndex; }
 
     private:
         ExitMultipleChoiceAction(XmlReader *pReader);
@@ -1046,6 +1093,7 @@ protected:
 
     public:
         virtual void Execute(State *pState);
+        virtual int GetUnconditionalJumpIndex() { return startIndex; }
 
     private:
         EndMultipleChoiceOptionAction(XmlReader *pReader);
@@ -1236,6 +1284,7 @@ protected:
         bool nextIndexSet;
         State *pCachedState;
         string conditionFlag;
+        unsigned int conditionFlagIndex;
 
         int previousInterrogationIndex;
         int nextInterrogationIndex;
@@ -1347,6 +1396,7 @@ protected:
         void SetAfterEndInterrogationRepeatIndex(int afterEndInterrogationRepeatIndex) { this->afterEndInterrogationRepeatIndex = afterEndInterrogationRepeatIndex; }
 
         virtual void Execute(State *pState);
+        virtual int GetUnconditionalJumpIndex() { return GetAfterEndInterrogationRepeatIndex(); }
 
     private:
         ExitInterrogationRepeatAction(XmlReader *pReader);
@@ -1363,6 +1413,7 @@ protected:
         void SetAfterWrongPartnerUsedIndex(int afterWrongPartnerUsedIndex) { this->afterWrongPartnerUsedIndex = afterWrongPartnerUsedIndex; }
 
         virtual void Execute(State *pState);
+        virtual int GetUnconditionalJumpIndex() { return GetAfterWrongPartnerUsedIndex(); }
 
     private:
         SkipWrongPartnerUsedAction(XmlReader *pReader);
@@ -1734,6 +1785,7 @@ protected:
         void SetSkipToIndex(int skipToIndex) { this->skipToIndex = skipToIndex; }
 
         virtual void Execute(State *pState);
+        virtual int GetUnconditionalJumpIndex() { return GetSkipToIndex(); }
 
     private:
         SkipPlayerDefeatedAction(XmlReader *pReader);
@@ -31,6 +31,7 @@
 #include "../globals.h"
 #include "../MouseHelper.h"
 #include "../KeyboardHelper.h"
+#include "../Profiler.h"
 #include "../ResourceLoader.h"
 #include "../CaseInformation/Case.h"
 
@@ -460,6 +461,8 @@ void Dialog::Begin(State *pState)
 
 void Dialog::Update(int delta)
 {
+    Profiler::Zone zone("Dialog::Update");
+
     bool newCharacterDrawn = false;
 
     double lastCurrentTime = currentTime;
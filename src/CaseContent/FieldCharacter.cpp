@@ -34,8 +34,13 @@
 #include "../KeyboardHelper.h"
 #include "../SharedUtils.h"
 #include "../XmlReader.h"
+#include "../globals.h"
 #include "../CaseInformation/Case.h"
 
+#include <math.h>
+
+const double MaxInterpolatedDistance = 100.0; // px
+
 FieldCharacter::FieldCharacter()
 {
     for (int i = 0; i < FieldCharacterDirectionCount; i++)
@@ -61,6 +66,8 @@ FieldCharacter::FieldCharacter()
     id = "";
     name = "";
     position = Vector2(0, 0);
+    previousPosition = Vector2(0, 0);
+    interpolationStepCount = 0;
     pHitBox = NULL;
     direction = CharacterDirectionLeft;
     spriteDirection = FieldCharacterDirectionSide;
@@ -98,6 +105,8 @@ FieldCharacter::FieldCharacter(const string &characterId, const string &characte
     id = characterId;
     name = characterName;
     position = Vector2(0, 0);
+    previousPosition = Vector2(0, 0);
+    interpolationStepCount = 0;
     pHitBox = NULL;
     direction = CharacterDirectionLeft;
     spriteDirection = FieldCharacterDirectionSide;
@@ -135,6 +144,8 @@ FieldCharacter::FieldCharacter(XmlReader *pReader)
     id = "";
     name = "";
     position = Vector2(0, 0);
+    previousPosition = Vector2(0, 0);
+    interpolationStepCount = 0;
     pHitBox = NULL;
     direction = CharacterDirectionLeft;
     spriteDirection = FieldCharacterDirectionSide;
@@ -383,12 +394,30 @@ void FieldCharacter::UpdateClickState(RectangleWH adjustedClickRect)
 
 void FieldCharacter::Draw()
 {
-    pCurrentAnimation->Draw(GetPosition() - Vector2(0, extraHeight), GetDirection() == CharacterDirectionRight, 1.0);
+    pCurrentAnimation->Draw(GetInterpolatedPosition() - Vector2(0, extraHeight), GetDirection() == CharacterDirectionRight, 1.0);
 }
 
 void FieldCharacter::Draw(Vector2 offsetVector)
 {
-    pCurrentAnimation->Draw(GetPosition() - offsetVector - Vector2(0, extraHeight), GetDirection() == CharacterDirectionRight, 1.0);
+    pCurrentAnimation->Draw(GetInterpolatedPosition() - offsetVector - Vector2(0, extraHeight), GetDirection() == CharacterDirectionRight, 1.0);
+}
+
+void FieldCharacter::SaveInterpolationState()
+{
+    previousPosition = position;
+    interpolationStepCount = gUpdateStepCount;
+}
+
+Vector2 FieldCharacter::GetInterpolatedPosition() const
+{
+    // If we didn't record where we were at the start of the most recent update,
+    // or if we jumped somewhere rather than moving there, then we'll just draw ourselves where we are.
+    if (interpolationStepCount != gUpdateStepCount || (position - previousPosition).Length() > MaxInterpolatedDistance)
+    {
+        return position;
+    }
+
+    return previousPosition + (position - previousPosition) * gUpdateInterpolation;
 }
 
 void FieldCharacter::Reset()
@@ -425,7 +454,14 @@ Vector2 FieldCharacter::GetMidPoint()
 void FieldCharacter::SetExtraHeightFromHeightMaps(vector<HeightMap *> *pHeightMapList)
 {
     extraHeight = 0;
-    Vector2 characterPosition = GetVectorAnchorPosition();
+
+    // This runs every frame, so we round to the nearest pixel in order to read heights
+    // from the height maps' rasters rather than computing them directly.  This means that
+    // the height can be off from the exact one by however much the height map changes
+    // over half a pixel in each direction, and that a character within half a pixel
+    // of a height map's edge can land on either side of it.
+    Vector2 anchorPosition = GetVectorAnchorPosition();
+    Vector2 characterPosition = Vector2(floor(anchorPosition.GetX() + 0.5), floor(anchorPosition.GetY() + 0.5));
 
     for (unsigned int i = 0; i < pHeightMapList->size(); i++)
     {
@@ -438,6 +474,11 @@ void FieldCharacter::SetExtraHeightFromHeightMaps(vector<HeightMap *> *pHeightMa
     }
 }
 
+RectangleWH FieldCharacter::GetClickBounds()
+{
+    return RectangleWH(GetPosition().GetX() + GetClickRect().GetX(), GetPosition().GetY() + GetClickRect().GetY() - extraHeight, GetClickRect().GetWidth(), GetClickRect().GetHeight());
+}
+
 RectangleWH FieldCharacter::GetBoundsForInteraction()
 {
     if (IsInteractionPointExact())
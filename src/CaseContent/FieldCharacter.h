@@ -64,6 +64,11 @@ public:
     Vector2 GetPosition() const { return this->position; }
     void SetPosition(Vector2 position) { this->position = position; }
 
+    // Records where this character was at the start of the current update,
+    // so that it can be drawn partway between there and where it ends up.
+    void SaveInterpolationState();
+    Vector2 GetInterpolatedPosition() const;
+
     HitBox * GetHitBox() { return this->pHitBox; }
     void SetHitBox(HitBox *pHitBox) { this->pHitBox = pHitBox; }
 
@@ -136,6 +141,8 @@ public:
 
     void SetExtraHeightFromHeightMaps(vector<HeightMap *> *pHeightMapList);
 
+    RectangleWH GetClickBounds();
+
     RectangleWH GetBoundsForInteraction();
     bool IsInteractionPointExact();
     void BeginInteraction(Location *pLocation);
@@ -201,6 +208,8 @@ private:
     string id;
     string name;
     Vector2 position;
+    Vector2 previousPosition;
+    Uint32 interpolationStepCount;
     HitBox *pHitBox;
     CharacterDirection direction;
     FieldCharacterDirection spriteDirection;
@@ -242,6 +242,12 @@ void FieldCutscene::UpdateCharacters(int delta, vector<HeightMap *> *pHeightMapL
 {
     vector<PositionalSound> soundsToPlayList;
 
+    // Phases move characters after this, so this is where each of them started this update.
+    for (map<string, FieldCharacter *>::iterator iter = idToCharacterMap.begin(); iter != idToCharacterMap.end(); ++iter)
+    {
+        iter->second->SaveInterpolationState();
+    }
+
     if (GetIsFinished() || (pCurrentPhase != NULL && pCurrentPhase->GetAllowsCharacterUpdates()))
     {
         for (map<string, FieldCharacter *>::iterator iter = idToCharacterMap.begin(); iter != idToCharacterMap.end(); ++iter)
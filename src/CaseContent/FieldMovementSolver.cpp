@@ -0,0 +1,349 @@
+/**
+ * Resolves collisions between characters moving around the field and everything they can bump into.
+ *
+ * @author GabuEx, dawnmew
+ * @since 1.0.7
+ *
+ * Licensed under the MIT License.
+ *
+ * Copyright (c) 2014 Equestrian Dreamers
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "FieldMovementSolver.h"
+#include "Crowd.h"
+#include "FieldCharacter.h"
+#include "ForegroundElement.h"
+#include "../Profiler.h"
+
+#include <algorithm>
+#include <limits>
+
+#ifdef MLI_DEBUG
+#include <iostream>
+#endif
+
+FieldMovementSolver::FieldMovementSolver()
+{
+    isObstacleListBuilt = false;
+}
+
+void FieldMovementSolver::BeginFrame(const vector<FieldCharacter *> &obstacleCharacterList, const vector<ForegroundElement *> &foregroundElementList, const vector<Crowd *> &crowdList)
+{
+    obstacleList.clear();
+
+    // The priority of each obstacle is the order in which we used to test against them,
+    // which we need to keep, since pushing a character out of one obstacle can push it into another.
+    for (unsigned int i = 0; i < obstacleCharacterList.size(); i++)
+    {
+        obstacleList.push_back(Obstacle(obstacleList.size(), obstacleCharacterList[i], NULL, NULL));
+    }
+
+    for (unsigned int i = 0; i < foregroundElementList.size(); i++)
+    {
+        obstacleList.push_back(Obstacle(obstacleList.size(), NULL, foregroundElementList[i], NULL));
+    }
+
+    for (unsigned int i = 0; i < crowdList.size(); i++)
+    {
+        obstacleList.push_back(Obstacle(obstacleList.size(), NULL, NULL, crowdList[i]));
+    }
+
+    isObstacleListBuilt = false;
+}
+
+void FieldMovementSolver::ResolveCollisions(FieldCharacter *pCharacter, HitBox *pAreaHitBox)
+{
+    #ifdef MLI_DEBUG
+        #ifdef MLI_DEBUG_VALIDATE_FIELD_MOVEMENT
+            Vector2 startPosition = pCharacter->GetPosition();
+        #endif
+    #endif
+
+    CollisionParameter param;
+
+    if (pAreaHitBox != NULL)
+    {
+        bool isCollision = pCharacter->IsCollision(pAreaHitBox, &param);
+        Profiler::NotifyCollisionTest(isCollision);
+
+        if (isCollision)
+        {
+            PushOutOfCollision(pCharacter, &param);
+        }
+    }
+
+    EnsureObstacleListBuilt();
+
+    RectangleWH characterBoundingBox = pCharacter->GetHitBox()->GetCollisionBoundingBox();
+    unsigned int nextPriority = 0;
+    bool wasPushed = true;
+
+    // Every time the character gets pushed, its bounding box moves,
+    // so we need to find which of the remaining obstacles it overlaps all over again.
+    while (wasPushed)
+    {
+        wasPushed = false;
+
+        Vector2 position = pCharacter->GetPosition();
+        double left = position.GetX() + characterBoundingBox.GetX();
+        double top = position.GetY() + characterBoundingBox.GetY();
+        double right = left + characterBoundingBox.GetWidth();
+        double bottom = top + characterBoundingBox.GetHeight();
+
+        candidateObstacleList.clear();
+
+        for (unsigned int i = 0; i < obstacleList.size() && obstacleList[i].left <= right; i++)
+        {
+            const Obstacle &obstacle = obstacleList[i];
+
+            if (obstacle.priority >= nextPriority &&
+                obstacle.pCharacter != pCharacter &&
+                obstacle.right >= left &&
+                obstacle.top <= bottom &&
+                obstacle.bottom >= top)
+            {
+                candidateObstacleList.push_back(&obstacle);
+            }
+        }
+
+        sort(candidateObstacleList.begin(), candidateObstacleList.end(), CompareObstaclesByPriority);
+
+        for (unsigned int i = 0; i < candidateObstacleList.size(); i++)
+        {
+            const Obstacle *pObstacle = candidateObstacleList[i];
+            nextPriority = pObstacle->priority + 1;
+
+            if (!pObstacle->GetIsPresent())
+            {
+                continue;
+            }
+
+            bool isCollision = pObstacle->IsCollision(pCharacter, &param);
+            Profiler::NotifyCollisionTest(isCollision);
+
+            if (isCollision)
+            {
+                PushOutOfCollision(pCharacter, &param);
+                wasPushed = true;
+                break;
+            }
+        }
+    }
+
+    #ifdef MLI_DEBUG
+        #ifdef MLI_DEBUG_VALIDATE_FIELD_MOVEMENT
+            ValidateCollisionResolution(pCharacter, pAreaHitBox, startPosition);
+        #endif
+    #endif
+}
+
+void FieldMovementSolver::NotifyCharacterMoved(FieldCharacter *pCharacter)
+{
+    if (!isObstacleListBuilt)
+    {
+        return;
+    }
+
+    for (unsigned int i = 0; i < obstacleList.size(); i++)
+    {
+        if (obstacleList[i].pCharacter == pCharacter)
+        {
+            obstacleList[i].UpdateBounds();
+
+            // Characters only move a little bit each frame,
+            // so an insertion sort from where this one was is all that's needed to keep the list sorted.
+            unsigned int j = i;
+
+            while (j > 0 && CompareObstaclesByLeft(obstacleList[j], obstacleList[j - 1]))
+            {
+                swap(obstacleList[j], obstacleList[j - 1]);
+                j--;
+            }
+
+            while (j + 1 < obstacleList.size() && CompareObstaclesByLeft(obstacleList[j + 1], obstacleList[j]))
+            {
+                swap(obstacleList[j], obstacleList[j + 1]);
+                j++;
+            }
+
+            break;
+        }
+    }
+}
+
+FieldMovementSolver::Obstacle::Obstacle(unsigned int priority, FieldCharacter *pCharacter, ForegroundElement *pElement, Crowd *pCrowd)
+{
+    this->priority = priority;
+    this->pCharacter = pCharacter;
+    this->pElement = pElement;
+    this->pCrowd = pCrowd;
+
+    left = numeric_limits<double>::infinity();
+    top = numeric_limits<double>::infinity();
+    right = -numeric_limits<double>::infinity();
+    bottom = -numeric_limits<double>::infinity();
+}
+
+void FieldMovementSolver::Obstacle::UpdateBounds()
+{
+    HitBox *pHitBox = NULL;
+    Vector2 offset = Vector2(0, 0);
+
+    if (pCharacter != NULL)
+    {
+        pHitBox = pCharacter->GetHitBox();
+        offset = pCharacter->GetPosition();
+    }
+    else if (pElement != NULL)
+    {
+        pHitBox = pElement->GetHitBox();
+    }
+    else if (pCrowd != NULL)
+    {
+        pHitBox = pCrowd->GetHitBox();
+    }
+
+    // Obstacles without a hit box keep their empty bounds,
+    // which sort to the end of the list and never overlap anything.
+    if (pHitBox == NULL)
+    {
+        return;
+    }
+
+    RectangleWH boundingBox = pHitBox->GetCollisionBoundingBox();
+
+    left = offset.GetX() + boundingBox.GetX();
+    top = offset.GetY() + boundingBox.GetY();
+    right = left + boundingBox.GetWidth();
+    bottom = top + boundingBox.GetHeight();
+}
+
+bool FieldMovementSolver::Obstacle::GetIsPresent() const
+{
+    if (pCharacter != NULL)
+    {
+        return pCharacter->GetIsPresent();
+    }
+    else if (pElement != NULL)
+    {
+        return pElement->IsPresent();
+    }
+    else
+    {
+        return true;
+    }
+}
+
+bool FieldMovementSolver::Obstacle::IsCollision(FieldCharacter *pCharacter, CollisionParameter *pParam) const
+{
+    if (this->pCharacter != NULL)
+    {
+        return pCharacter->IsCollision(this->pCharacter, pParam);
+    }
+    else if (pElement != NULL)
+    {
+        return pCharacter->IsCollision(pElement, pParam);
+    }
+    else
+    {
+        return pCharacter->IsCollision(pCrowd, pParam);
+    }
+}
+
+bool FieldMovementSolver::CompareObstaclesByLeft(const Obstacle &obstacle1, const Obstacle &obstacle2)
+{
+    return obstacle1.left < obstacle2.left;
+}
+
+bool FieldMovementSolver::CompareObstaclesByPriority(const Obstacle *pObstacle1, const Obstacle *pObstacle2)
+{
+    return pObstacle1->priority < pObstacle2->priority;
+}
+
+void FieldMovementSolver::PushOutOfCollision(FieldCharacter *pCharacter, CollisionParameter *pParam)
+{
+    pParam->OverlapAxis = pParam->OverlapAxis.Normalize();
+    pCharacter->SetPosition(
+        Vector2(pCharacter->GetPosition().GetX() + pParam->OverlapAxis.GetX() * pParam->OverlapDistance,
+                pCharacter->GetPosition().GetY() + pParam->OverlapAxis.GetY() * pParam->OverlapDistance));
+}
+
+#ifdef MLI_DEBUG
+void FieldMovementSolver::ValidateCollisionResolution(FieldCharacter *pCharacter, HitBox *pAreaHitBox, Vector2 startPosition)
+{
+    // We test against every obstacle in order, the way we did before we had the solver,
+    // and report anywhere that the two end up putting the character in different places.
+    Vector2 solvedPosition = pCharacter->GetPosition();
+    CollisionParameter param;
+
+    pCharacter->SetPosition(startPosition);
+
+    if (pAreaHitBox != NULL && pCharacter->IsCollision(pAreaHitBox, &param))
+    {
+        PushOutOfCollision(pCharacter, &param);
+    }
+
+    vector<const Obstacle *> obstacleByPriorityList;
+
+    for (unsigned int i = 0; i < obstacleList.size(); i++)
+    {
+        obstacleByPriorityList.push_back(&obstacleList[i]);
+    }
+
+    sort(obstacleByPriorityList.begin(), obstacleByPriorityList.end(), CompareObstaclesByPriority);
+
+    for (unsigned int i = 0; i < obstacleByPriorityList.size(); i++)
+    {
+        const Obstacle *pObstacle = obstacleByPriorityList[i];
+
+        if (pObstacle->pCharacter != pCharacter && pObstacle->GetIsPresent() && pObstacle->IsCollision(pCharacter, &param))
+        {
+            PushOutOfCollision(pCharacter, &param);
+        }
+    }
+
+    Vector2 directPosition = pCharacter->GetPosition();
+
+    if ((directPosition - solvedPosition).Length() > 0.0001)
+    {
+        cout << "Field movement mismatch: solver moved the character to (" << solvedPosition.GetX() << ", " << solvedPosition.GetY() << "), "
+             << "testing every obstacle moved it to (" << directPosition.GetX() << ", " << directPosition.GetY() << ")." << endl;
+    }
+
+    pCharacter->SetPosition(solvedPosition);
+}
+#endif
+
+void FieldMovementSolver::EnsureObstacleListBuilt()
+{
+    if (isObstacleListBuilt)
+    {
+        return;
+    }
+
+    for (unsigned int i = 0; i < obstacleList.size(); i++)
+    {
+        obstacleList[i].UpdateBounds();
+    }
+
+    sort(obstacleList.begin(), obstacleList.end(), CompareObstaclesByLeft);
+    isObstacleListBuilt = true;
+}
@@ -0,0 +1,104 @@
+/**
+ * Basic header/include file for FieldMovementSolver.cpp.
+ *
+ * @author GabuEx, dawnmew
+ * @since 1.0.7
+ *
+ * Licensed under the MIT License.
+ *
+ * Copyright (c) 2014 Equestrian Dreamers
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef FIELDMOVEMENTSOLVER_H
+#define FIELDMOVEMENTSOLVER_H
+
+#include "../Collisions.h"
+
+#include <vector>
+
+using namespace std;
+
+class Crowd;
+class FieldCharacter;
+class ForegroundElement;
+
+// Pushes characters out of anything they've walked into after they move.
+// Everything a character can collide with is kept in a list sorted by its left edge,
+// so each moving character only has to do the full hit box test against the obstacles
+// whose bounding boxes actually overlap its own (a one-axis sweep and prune).
+class FieldMovementSolver
+{
+public:
+    FieldMovementSolver();
+
+    // Should be called once per frame before any characters are moved.
+    // The obstacles' bounding boxes aren't computed until something actually moves,
+    // so frames where everyone is standing still cost nothing.
+    void BeginFrame(const vector<FieldCharacter *> &obstacleCharacterList, const vector<ForegroundElement *> &foregroundElementList, const vector<Crowd *> &crowdList);
+
+    // Pushes the character out of the area bounds, then out of every obstacle it overlaps.
+    // Obstacles are resolved in the same order as they were given to BeginFrame(),
+    // since each push can change what the character overlaps afterwards.
+    void ResolveCollisions(FieldCharacter *pCharacter, HitBox *pAreaHitBox);
+
+    // Should be called whenever a character that's also an obstacle changes position,
+    // so that characters moving after it collide with where it is now.
+    void NotifyCharacterMoved(FieldCharacter *pCharacter);
+
+private:
+    class Obstacle
+    {
+    public:
+        Obstacle(unsigned int priority, FieldCharacter *pCharacter, ForegroundElement *pElement, Crowd *pCrowd);
+
+        void UpdateBounds();
+        bool GetIsPresent() const;
+        bool IsCollision(FieldCharacter *pCharacter, CollisionParameter *pParam) const;
+
+        unsigned int priority;
+        FieldCharacter *pCharacter;
+        ForegroundElement *pElement;
+        Crowd *pCrowd;
+
+        double left;
+        double top;
+        double right;
+        double bottom;
+    };
+
+    static bool CompareObstaclesByLeft(const Obstacle &obstacle1, const Obstacle &obstacle2);
+    static bool CompareObstaclesByPriority(const Obstacle *pObstacle1, const Obstacle *pObstacle2);
+    static void PushOutOfCollision(FieldCharacter *pCharacter, CollisionParameter *pParam);
+
+    void EnsureObstacleListBuilt();
+
+#ifdef MLI_DEBUG
+    // Defining MLI_DEBUG_VALIDATE_FIELD_MOVEMENT checks every resolution against
+    // the full test against every obstacle that this replaced.
+    void ValidateCollisionResolution(FieldCharacter *pCharacter, HitBox *pAreaHitBox, Vector2 startPosition);
+#endif
+
+    vector<Obstacle> obstacleList;
+    vector<const Obstacle *> candidateObstacleList;
+    bool isObstacleListBuilt;
+};
+
+#endif
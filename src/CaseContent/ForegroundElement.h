@@ -92,6 +92,8 @@ public:
     void UpdateClickState(Vector2 offsetVector);
     void UpdateClickState(GeometricPolygon adjustedClickPolygon);
 
+    RectangleWH GetClickBounds() const { return this->clickPolygon.GetBoundingBox(); }
+
     void Draw();
     void Draw(Vector2 offsetVector);
 
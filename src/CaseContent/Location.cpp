@@ -35,6 +35,7 @@
 #include "../MouseHelper.h"
 #include "../KeyboardHelper.h"
 #include "../PositionalSound.h"
+#include "../Profiler.h"
 #include "../TransitionRequest.h"
 #include "../XmlReader.h"
 #include "../XmlWriter.h"
@@ -62,10 +63,15 @@ const int CursorLowThreshold = 300; // px
 const int WalkingSpeed = 300; // px / s
 const int RunningSpeed = 600; // px / s
 
+const double MaxInterpolatedCameraDistance = 100.0; // px
+
 const bool bSkipIntroCutscene = false;
 
 const double KeyboardMovementVectorLength = 50.0;   //In this case, fairly arbitrary, as we're moving the player directly
 
+const int HitTestGridCellSize = 128; // px
+const double HitTestBoundsPadding = 1; // px
+
 Image *Location::pFadeSprite = NULL;
 FieldCharacter *Location::pCurrentPlayerCharacter = NULL;
 string Location::pendingTransitionEndSfxId = "";
@@ -82,12 +88,9 @@ Location::PathfindingThreadParameters::PathfindingThreadParameters(Location *pLo
 
 Location * Location::Transition::GetTargetLocation()
 {
-    if (pTargetLocation == NULL)
-    {
-        pTargetLocation = Case::GetInstance()->GetContentManager()->GetLocationFromId(targetLocationId);
-    }
-
-    return pTargetLocation;
+    // We don't hold onto this, since the content manager can release locations
+    // that haven't been visited recently and recreate them later.
+    return Case::GetInstance()->GetContentManager()->GetLocationFromId(targetLocationId);
 }
 
 void Location::Transition::BeginInteraction(Location *pLocation)
@@ -117,7 +120,6 @@ void Location::Transition::BeginInteraction(Location *pLocation)
 
 Location::Transition::Transition(XmlReader *pReader)
 {
-    pTargetLocation = NULL;
     pHitBox = NULL;
     pCondition = NULL;
     pEncounter = NULL;
@@ -177,7 +179,6 @@ Location::Transition::Transition(const Location::Transition &other)
     : targetLocationId(other.targetLocationId)
     , targetLocationName(other.targetLocationName)
 {
-    this->pTargetLocation = NULL;
     this->pHitBox = other.pHitBox != NULL ? other.pHitBox->Clone() : NULL;
     this->transitionDirection = other.transitionDirection;
     this->hideWhenLocked = other.hideWhenLocked;
@@ -212,6 +213,7 @@ Location::LoopingSound::LoopingSound(XmlReader *pReader)
 
 Location::Location(XmlReader *pReader)
     : bounds(RectangleWH(0, 0, 0, 0))
+    , hitTestGrid(HitTestGridCellSize)
 {
     pBackgroundSprite = NULL;
     pPlayerCharacter = NULL;
@@ -232,6 +234,8 @@ Location::Location(XmlReader *pReader)
     movingDirectly = false;
     pPathfindingValuesSemaphore = SDL_CreateSemaphore(1);
     lastPathfindingThreadId = 0;
+    activePathfindingThreadCount = 0;
+    lastHitTestGridVersion = 0;
 
     pEvidenceTab = new Tab(gScreenWidth - 3 * (TabWidth + 7), true /* isClickable */, gpLocalizableContent->GetText("Location/EvidenceText"), false /* useCancelClickSoundEffect */, TabRowBottom, true /* canPulse */);
     pEvidenceSelector = new EvidenceSelector(true /* isCancelable */, true /* isForCombination */);
@@ -433,6 +437,7 @@ Location::Location(XmlReader *pReader)
 
 Location::Location(const Location &other)
     : bounds(RectangleWH(0, 0, 0, 0))
+    , hitTestGrid(HitTestGridCellSize)
 {
     pBackgroundSprite = NULL;
     pPlayerCharacter = NULL;
@@ -453,6 +458,8 @@ Location::Location(const Location &other)
     movingDirectly = false;
     pPathfindingValuesSemaphore = SDL_CreateSemaphore(1);
     lastPathfindingThreadId = 0;
+    activePathfindingThreadCount = 0;
+    lastHitTestGridVersion = 0;
 
     pEvidenceTab = new Tab(gScreenWidth - 3 * (TabWidth + 7), true /* isClickable */, gpLocalizableContent->GetText("Location/EvidenceText"), false /* useCancelClickSoundEffect */, TabRowBottom, true /* canPulse */);
     pEvidenceSelector = new EvidenceSelector(true /* isCancelable */, true /* isForCombination */);
@@ -681,6 +688,15 @@ void Location::UpdateLoadedTextures(bool waitUntilLoaded)
     Case::GetInstance()->UpdateLoadedTextures(GetId(), waitUntilLoaded);
 }
 
+bool Location::GetIsPathfinding()
+{
+    SDL_SemWait(pPathfindingValuesSemaphore);
+    bool isPathfinding = activePathfindingThreadCount > 0;
+    SDL_SemPost(pPathfindingValuesSemaphore);
+
+    return isPathfinding;
+}
+
 void Location::Begin(const string &transitionId)
 {
     if (pPlayerCharacter == NULL)
@@ -692,13 +708,11 @@ void Location::Begin(const string &transitionId)
 
     if (Case::GetInstance()->GetPartnerManager()->GetCurrentPartnerId().length() == 0)
     {
-        delete pPartnerCharacter;
-        pPartnerCharacter = NULL;
+        SetPartnerCharacter(NULL);
     }
     else
     {
-        delete pPartnerCharacter;
-        pPartnerCharacter = Case::GetInstance()->GetFieldCharacterManager()->GetCharacterFromId(Case::GetInstance()->GetPartnerManager()->GetCurrentPartnerId());
+        SetPartnerCharacter(Case::GetInstance()->GetFieldCharacterManager()->GetCharacterFromId(Case::GetInstance()->GetPartnerManager()->GetCurrentPartnerId()));
     }
 
     previousPartnerCharacterId = Case::GetInstance()->GetPartnerManager()->GetCurrentPartnerId();
@@ -886,6 +900,23 @@ void Location::Begin(const string &transitionId)
 
 void Location::Update(int delta)
 {
+    Profiler::Zone zone("Location::Update");
+
+    // We draw partway between where things were at the start of this update
+    // and where they end up, so we'll note the former before anything moves.
+    previousDrawingOffsetVector = drawingOffsetVector;
+    pPlayerCharacter->SaveInterpolationState();
+
+    if (pPartnerCharacter != NULL)
+    {
+        pPartnerCharacter->SaveInterpolationState();
+    }
+
+    for (unsigned int i = 0; i < characterList.size(); i++)
+    {
+        characterList[i]->SaveInterpolationState();
+    }
+
     if (gIsQuitting)
     {
         SaveDialogsSeenListForCase(Case::GetInstance()->GetUuid());
@@ -1398,8 +1429,7 @@ void Location::Update(int delta)
             characterTargetPositionQueueMap.erase(pPartnerCharacter);
             characterTargetPositionMap.erase(pPartnerCharacter);
 
-            delete pPartnerCharacter;
-            pPartnerCharacter = NULL;
+            SetPartnerCharacter(NULL);
         }
         else
         {
@@ -1408,11 +1438,9 @@ void Location::Update(int delta)
                 characterStateMap.erase(pPartnerCharacter);
                 characterTargetPositionQueueMap.erase(pPartnerCharacter);
                 characterTargetPositionMap.erase(pPartnerCharacter);
-
-                delete pPartnerCharacter;
             }
 
-            pPartnerCharacter = Case::GetInstance()->GetFieldCharacterManager()->GetCharacterFromId(currentPartnerId);
+            SetPartnerCharacter(Case::GetInstance()->GetFieldCharacterManager()->GetCharacterFromId(currentPartnerId));
 
             // If this partner character came from this scene, then make its starting position
             // where the field character used to be.  Otherwise, start it at the player character.
@@ -1631,6 +1659,8 @@ void Location::Update(int delta)
 
     interactiveElementsByZOrder.sort(CompareByZOrderDescending);
 
+    UpdateHitTestGrid();
+
     bool elementWithMouseOverFound = false;
     int minDistanceToHiddenElement = numeric_limits<int>::max();
     HiddenForegroundElement *pClosestHiddenForegroundElement = NULL;
@@ -1735,7 +1765,7 @@ void Location::Update(int delta)
             if ((Case::GetInstance()->GetPartnerManager()->GetCurrentPartnerId().length() == 0 || !Case::GetInstance()->GetPartnerManager()->GetCurrentPartner()->GetIsUsingFieldAbility()) &&
                 !elementWithMouseOverFound)
             {
-                pPartnerCharacter->UpdateClickState(drawingOffsetVector);
+                UpdateClickState(pPartnerCharacter);
                 elementWithMouseOverFound = pPartnerCharacter->GetIsMouseOver();
 
                 if (acceptsUserInput)
@@ -1764,7 +1794,7 @@ void Location::Update(int delta)
                 if ((Case::GetInstance()->GetPartnerManager()->GetCurrentPartnerId().length() == 0 || !Case::GetInstance()->GetPartnerManager()->GetCurrentPartner()->GetIsUsingFieldAbility()) &&
                     !elementWithMouseOverFound)
                 {
-                    pFieldCharacter->UpdateClickState(drawingOffsetVector);
+                    UpdateClickState(pFieldCharacter);
                     elementWithMouseOverFound = pFieldCharacter->GetIsMouseOver();
                 }
 
@@ -1785,7 +1815,7 @@ void Location::Update(int delta)
             if ((Case::GetInstance()->GetPartnerManager()->GetCurrentPartnerId().length() == 0 || !Case::GetInstance()->GetPartnerManager()->GetCurrentPartner()->GetIsUsingFieldAbility()) &&
                 !elementWithMouseOverFound)
             {
-                pCrowd->UpdateClickState(drawingOffsetVector);
+                UpdateClickState(pCrowd);
                 elementWithMouseOverFound = pCrowd->GetIsMouseOver();
 
                 if (acceptsUserInput)
@@ -1811,7 +1841,7 @@ void Location::Update(int delta)
 
                 if (!elementWithMouseOverFound)
                 {
-                    pHiddenForegroundElement->UpdateClickState(drawingOffsetVector);
+                    UpdateClickState(pHiddenForegroundElement);
                     elementWithMouseOverFound = pHiddenForegroundElement->GetIsMouseOver();
 
                     if (pHiddenForegroundElement->GetIsClicked() && pHiddenForegroundElement->GetIsInteractive())
@@ -1844,7 +1874,7 @@ void Location::Update(int delta)
             if ((Case::GetInstance()->GetPartnerManager()->GetCurrentPartnerId().length() == 0 || !Case::GetInstance()->GetPartnerManager()->GetCurrentPartner()->GetIsUsingFieldAbility()) &&
                 !elementWithMouseOverFound)
             {
-                pForegroundElement->UpdateClickState(drawingOffsetVector);
+                UpdateClickState(pForegroundElement);
                 elementWithMouseOverFound = pForegroundElement->GetIsMouseOver();
 
                 if (acceptsUserInput)
@@ -2142,6 +2172,22 @@ void Location::Update(int delta)
         }
     }
 
+    // Nobody collides with the player and partner characters,
+    // but everyone collides with everyone else.
+    vector<FieldCharacter *> obstacleCharacterList;
+
+    for (unsigned int i = 0; i < fieldCharacterList.size(); i++)
+    {
+        FieldCharacter *pCharacter = fieldCharacterList[i];
+
+        if (pCharacter != pPlayerCharacter && pCharacter != pPartnerCharacter)
+        {
+            obstacleCharacterList.push_back(pCharacter);
+        }
+    }
+
+    movementSolver.BeginFrame(obstacleCharacterList, foregroundElementList, crowdList);
+
     for (unsigned int i = 0; i < fieldCharacterList.size(); i++)
     {
         FieldCharacter *pCharacter = fieldCharacterList[i];
@@ -2163,67 +2209,7 @@ void Location::Update(int delta)
                 pCharacter->SetPosition(newPosition);
                 pCharacter->SetState(characterStateMap[pCharacter]);
 
-                CollisionParameter param;
-
-                if (pCharacter->IsCollision(GetAreaHitBox(), &param))
-                {
-                    param.OverlapAxis = param.OverlapAxis.Normalize();
-                    newPosition =
-                        Vector2(pCharacter->GetPosition().GetX() + param.OverlapAxis.GetX() * param.OverlapDistance,
-                                pCharacter->GetPosition().GetY() + param.OverlapAxis.GetY() * param.OverlapDistance);
-                    pCharacter->SetPosition(newPosition);
-                }
-
-                for (unsigned int j = 0; j < fieldCharacterList.size(); j++)
-                {
-                    FieldCharacter *pOtherCharacter = fieldCharacterList[j];
-
-                    // Don't collide characters with themselves, or anyone with the partner and player characters,
-                    // or anyone with someone else who's moving.
-                    if (pCharacter != pOtherCharacter &&
-                        pOtherCharacter != pPlayerCharacter &&
-                        pOtherCharacter != pPartnerCharacter &&
-                        pOtherCharacter->GetIsPresent())
-                    {
-                        if (pCharacter->IsCollision(pOtherCharacter, &param))
-                        {
-                            param.OverlapAxis = param.OverlapAxis.Normalize();
-                            newPosition =
-                                Vector2(pCharacter->GetPosition().GetX() + param.OverlapAxis.GetX() * param.OverlapDistance,
-                                        pCharacter->GetPosition().GetY() + param.OverlapAxis.GetY() * param.OverlapDistance);
-                            pCharacter->SetPosition(newPosition);
-                        }
-                    }
-                }
-
-                for (unsigned int j = 0; j < foregroundElementList.size(); j++)
-                {
-                    ForegroundElement *pElement = foregroundElementList[j];
-
-                    if (pElement->IsPresent() &&
-                        pCharacter->IsCollision(pElement, &param))
-                    {
-                        param.OverlapAxis = param.OverlapAxis.Normalize();
-                        newPosition =
-                            Vector2(pCharacter->GetPosition().GetX() + param.OverlapAxis.GetX() * param.OverlapDistance,
-                                    pCharacter->GetPosition().GetY() + param.OverlapAxis.GetY() * param.OverlapDistance);
-                        pCharacter->SetPosition(newPosition);
-                    }
-                }
-
-                for (unsigned int i = 0; i < crowdList.size(); i++)
-                {
-                    Crowd *pCrowd = crowdList[i];
-
-                    if (pCharacter->IsCollision(pCrowd, &param))
-                    {
-                        param.OverlapAxis = param.OverlapAxis.Normalize();
-                        newPosition =
-                            Vector2(pCharacter->GetPosition().GetX() + param.OverlapAxis.GetX() * param.OverlapDistance,
-                                    pCharacter->GetPosition().GetY() + param.OverlapAxis.GetY() * param.OverlapDistance);
-                        pCharacter->SetPosition(newPosition);
-                    }
-                }
+                movementSolver.ResolveCollisions(pCharacter, GetAreaHitBox());
 
                 Vector2 directionVector = (targetPosition - pCharacter->GetVectorAnchorPosition()).Normalize();
 
@@ -2319,6 +2305,8 @@ void Location::Update(int delta)
 
             characterTargetPositionMap[pCharacter] = Vector2(-1, -1);
         }
+
+        movementSolver.NotifyCharacterMoved(pCharacter);
     }
 
     pPlayerCharacter->Update(delta);
@@ -2376,68 +2364,7 @@ void Location::Update(int delta)
                 pPartnerCharacter->SetPosition(pPartnerCharacter->GetPosition() + movementDisplacement);
                 pPartnerCharacter->UpdateDirection(movementDisplacement.Normalize());
 
-                CollisionParameter param;
-                Vector2 newPosition = pPartnerCharacter->GetPosition();
-
-                if (pPartnerCharacter->IsCollision(GetAreaHitBox(), &param))
-                {
-                    param.OverlapAxis = param.OverlapAxis.Normalize();
-                    newPosition =
-                        Vector2(pPartnerCharacter->GetPosition().GetX() + param.OverlapAxis.GetX() * param.OverlapDistance,
-                                pPartnerCharacter->GetPosition().GetY() + param.OverlapAxis.GetY() * param.OverlapDistance);
-                    pPartnerCharacter->SetPosition(newPosition);
-                }
-
-                for (unsigned int i = 0; i < fieldCharacterList.size(); i++)
-                {
-                    FieldCharacter *pOtherCharacter = fieldCharacterList[i];
-
-                    // Don't collide characters with themselves, or anyone with the partner and player characters,
-                    // or anyone with someone else who's moving.
-                    if (pPartnerCharacter != pOtherCharacter &&
-                        pOtherCharacter != pPlayerCharacter &&
-                        pOtherCharacter != pPartnerCharacter &&
-                        pOtherCharacter->GetIsPresent())
-                    {
-                        if (pPartnerCharacter->IsCollision(pOtherCharacter, &param))
-                        {
-                            param.OverlapAxis = param.OverlapAxis.Normalize();
-                            newPosition =
-                                Vector2(pPartnerCharacter->GetPosition().GetX() + param.OverlapAxis.GetX() * param.OverlapDistance,
-                                        pPartnerCharacter->GetPosition().GetY() + param.OverlapAxis.GetY() * param.OverlapDistance);
-                            pPartnerCharacter->SetPosition(newPosition);
-                        }
-                    }
-                }
-
-                for (unsigned int j = 0; j < foregroundElementList.size(); j++)
-                {
-                    ForegroundElement *pElement = foregroundElementList[j];
-
-                    if (pElement->IsPresent() &&
-                        pPartnerCharacter->IsCollision(pElement, &param))
-                    {
-                        param.OverlapAxis = param.OverlapAxis.Normalize();
-                        newPosition =
-                            Vector2(pPartnerCharacter->GetPosition().GetX() + param.OverlapAxis.GetX() * param.OverlapDistance,
-                                    pPartnerCharacter->GetPosition().GetY() + param.OverlapAxis.GetY() * param.OverlapDistance);
-                        pPartnerCharacter->SetPosition(newPosition);
-                    }
-                }
-
-                for (unsigned int i = 0; i < crowdList.size(); i++)
-                {
-                    Crowd *pCrowd = crowdList[i];
-
-                    if (pPartnerCharacter->IsCollision(pCrowd, &param))
-                    {
-                        param.OverlapAxis = param.OverlapAxis.Normalize();
-                        newPosition =
-                            Vector2(pPartnerCharacter->GetPosition().GetX() + param.OverlapAxis.GetX() * param.OverlapDistance,
-                                    pPartnerCharacter->GetPosition().GetY() + param.OverlapAxis.GetY() * param.OverlapDistance);
-                        pPartnerCharacter->SetPosition(newPosition);
-                    }
-                }
+                movementSolver.ResolveCollisions(pPartnerCharacter, GetAreaHitBox());
 
                 Vector2 newPartnerCharacterAnchorPoint = pPartnerCharacter->GetVectorAnchorPosition();
 
@@ -2571,9 +2498,130 @@ void Location::Update(int delta)
     }
 }
 
-void Location::UpdateTabPositions(int delta)
+RectangleWH Location::PadHitTestBounds(const RectangleWH &bounds)
+{
+    // Click states are computed with points and shapes that are rounded slightly differently
+    // from the bounds we index, so we pad the bounds to make sure we never miss an element.
+    return RectangleWH(
+        bounds.GetX() - HitTestBoundsPadding,
+        bounds.GetY() - HitTestBoundsPadding,
+        bounds.GetWidth() + 2 * HitTestBoundsPadding,
+        bounds.GetHeight() + 2 * HitTestBoundsPadding);
+}
+
+void Location::SetPartnerCharacter(FieldCharacter *pPartnerCharacter)
 {
-    bool shouldShowTabs =
+    // The hit-test grid holds onto the partner character's pointer,
+    // so we need to take the old one out before it's deleted.
+    if (this->pPartnerCharacter != NULL)
+    {
+        hitTestGrid.Remove(this->pPartnerCharacter);
+        delete this->pPartnerCharacter;
+    }
+
+    this->pPartnerCharacter = pPartnerCharacter;
+}
+
+void Location::UpdateHitTestGrid()
+{
+    // Foreground elements and crowds never move, so we only need to add them once.
+    for (unsigned int i = 0; i < foregroundElementList.size(); i++)
+    {
+        if (!hitTestGrid.Contains(foregroundElementList[i]))
+        {
+            hitTestGrid.Update(foregroundElementList[i], PadHitTestBounds(foregroundElementList[i]->GetClickBounds()));
+        }
+    }
+
+    for (unsigned int i = 0; i < hiddenForegroundElementList.size(); i++)
+    {
+        if (!hitTestGrid.Contains(hiddenForegroundElementList[i]))
+        {
+            hitTestGrid.Update(hiddenForegroundElementList[i], PadHitTestBounds(hiddenForegroundElementList[i]->GetClickBounds()));
+        }
+    }
+
+    for (unsigned int i = 0; i < crowdList.size(); i++)
+    {
+        if (!hitTestGrid.Contains(crowdList[i]))
+        {
+            hitTestGrid.Update(crowdList[i], PadHitTestBounds(crowdList[i]->GetClickBounds()));
+        }
+    }
+
+    // Characters can move, though, so we'll update them every time.
+    // The grid leaves characters that haven't moved alone.
+    for (unsigned int i = 0; i < characterList.size(); i++)
+    {
+        hitTestGrid.Update(characterList[i], PadHitTestBounds(characterList[i]->GetClickBounds()));
+    }
+
+    if (pPartnerCharacter != NULL)
+    {
+        hitTestGrid.Update(pPartnerCharacter, PadHitTestBounds(pPartnerCharacter->GetClickBounds()));
+    }
+
+    // If neither the cursor nor anything in the scene has moved since last time,
+    // then whatever was under the cursor then is still under it now.
+    Vector2 hitTestPoint = MouseHelper::GetMousePosition() + drawingOffsetVector;
+
+    if (hitTestPoint != lastHitTestPoint || hitTestGrid.GetVersion() != lastHitTestGridVersion)
+    {
+        hitTestGrid.GetItemsAtPoint(hitTestPoint, &hitTestCandidateList);
+        lastHitTestPoint = hitTestPoint;
+        lastHitTestGridVersion = hitTestGrid.GetVersion();
+    }
+}
+
+bool Location::IsHitTestCandidate(ZOrderableObject *pObject)
+{
+    return find(hitTestCandidateList.begin(), hitTestCandidateList.end(), pObject) != hitTestCandidateList.end();
+}
+
+void Location::UpdateClickState(FieldCharacter *pCharacter)
+{
+    // The mouse can't be over or clicking on anything that isn't under the cursor,
+    // so for everything else, we can skip straight to the answer.
+    if (IsHitTestCandidate(pCharacter))
+    {
+        pCharacter->UpdateClickState(drawingOffsetVector);
+    }
+    else
+    {
+        pCharacter->SetIsMouseOver(false);
+        pCharacter->SetIsClicked(false);
+    }
+}
+
+void Location::UpdateClickState(Crowd *pCrowd)
+{
+    if (IsHitTestCandidate(pCrowd))
+    {
+        pCrowd->UpdateClickState(drawingOffsetVector);
+    }
+    else
+    {
+        pCrowd->SetIsMouseOver(false);
+        pCrowd->SetIsClicked(false);
+    }
+}
+
+void Location::UpdateClickState(ForegroundElement *pForegroundElement)
+{
+    if (IsHitTestCandidate(pForegroundElement))
+    {
+        pForegroundElement->UpdateClickState(drawingOffsetVector);
+    }
+    else
+    {
+        pForegroundElement->SetIsMouseOver(false);
+        pForegroundElement->SetIsClicked(false);
+    }
+}
+
+bool Location::GetShouldShowTabs()
+{
+    return
         GetAcceptsUserInput() &&
         pCurrentEncounter == NULL &&
         pCurrentCutscene == NULL &&
@@ -2583,6 +2631,18 @@ void Location::UpdateTabPositions(int delta)
         pCurrentInteractiveCrowd == NULL &&
         !pInEasePartner->GetIsStarted() &&
         !isTransitioning;
+}
+
+bool Location::GetCanQuickSave()
+{
+    // Quick saving and loading are allowed whenever saving and loading from the tabs are,
+    // as long as we aren't already fading out to another screen.
+    return GetShouldShowTabs() && !pFadeOutEase->GetIsStarted();
+}
+
+void Location::UpdateTabPositions(int delta)
+{
+    bool shouldShowTabs = GetShouldShowTabs();
 
     pEvidenceTab->SetIsHidden(!shouldShowTabs);
     pPartnerTab->SetIsHidden(!shouldShowTabs);
@@ -2603,8 +2663,21 @@ void Location::UpdateTabPositions(int delta)
     pQuitTab->UpdatePosition(delta);
 }
 
+Vector2 Location::GetInterpolatedDrawingOffsetVector() const
+{
+    // If the camera cut somewhere rather than panning there, we'll just draw from where it is now.
+    if ((drawingOffsetVector - previousDrawingOffsetVector).Length() > MaxInterpolatedCameraDistance)
+    {
+        return drawingOffsetVector;
+    }
+
+    return previousDrawingOffsetVector + (drawingOffsetVector - previousDrawingOffsetVector) * gUpdateInterpolation;
+}
+
 void Location::Draw()
 {
+    Profiler::Zone zone("Location::Draw");
+
     if (fadeOpacity == 1)
     {
         return;
@@ -2612,7 +2685,9 @@ void Location::Draw()
 
     if (pCurrentZoomedView == NULL)
     {
-        GetBackgroundSprite()->DrawClipped(Vector2(0, 0), RectangleWH(drawingOffsetVector.GetX(), drawingOffsetVector.GetY(), gScreenWidth, gScreenHeight));
+        Vector2 interpolatedDrawingOffsetVector = GetInterpolatedDrawingOffsetVector();
+
+        GetBackgroundSprite()->DrawClipped(Vector2(0, 0), RectangleWH(interpolatedDrawingOffsetVector.GetX(), interpolatedDrawingOffsetVector.GetY(), gScreenWidth, gScreenHeight));
 
         list<ZOrderableObject *> objectsInZOrder;
 
@@ -2638,7 +2713,7 @@ void Location::Draw()
 
         if (pCurrentCutscene != NULL && pCurrentCutscene->GetHasBegun())
         {
-            pCurrentCutscene->Draw(drawingOffsetVector, &objectsInZOrder);
+            pCurrentCutscene->Draw(interpolatedDrawingOffsetVector, &objectsInZOrder);
             pFadeSprite->Draw(Vector2(0, 0), Color(fadeOpacity, 1.0, 1.0, 1.0));
             return;
         }
@@ -2669,12 +2744,12 @@ void Location::Draw()
 
         for (list<ZOrderableObject *>::iterator iter = objectsInZOrder.begin(); iter != objectsInZOrder.end(); ++iter)
         {
-            (*iter)->Draw(drawingOffsetVector);
+            (*iter)->Draw(interpolatedDrawingOffsetVector);
         }
 
         #ifdef MLI_DEBUG
             #ifdef MLI_DEBUG_DRAW_HITBOXES
-                pAreaHitBox->Draw(Vector2(0, 0) - drawingOffsetVector);
+                pAreaHitBox->Draw(Vector2(0, 0) - interpolatedDrawingOffsetVector);
 
                 for (unsigned int i = 0; i < objectsInZOrder.size(); i++)
                 {
@@ -2682,12 +2757,15 @@ void Location::Draw()
 
                     if (pCharacter != NULL)
                     {
-                        pCharacter->GetHitBox()->Draw(pCharacter->GetPosition() - drawingOffsetVector);
+                        pCharacter->GetHitBox()->Draw(pCharacter->GetInterpolatedPosition() - interpolatedDrawingOffsetVector);
                     }
                 }
             #endif
         #endif
 
+        // The tabs all share the same few textures, so we'll send them out together.
+        Image::BeginBatch();
+
         if (pEvidenceSelector->GetIsShowing())
         {
             pEvidenceSelector->Draw();
@@ -2714,6 +2792,8 @@ void Location::Draw()
 
         pEvidenceTab->Draw();
 
+        Image::EndBatch();
+
         if (pQuitConfirmOverlay->GetIsShowing())
         {
             pQuitConfirmOverlay->Draw();
@@ -2912,13 +2992,11 @@ void Location::LoadFromSaveFile(XmlReader *pReader)
 
     if (Case::GetInstance()->GetPartnerManager()->GetCurrentPartnerId().length() == 0)
     {
-        delete pPartnerCharacter;
-        pPartnerCharacter = NULL;
+        SetPartnerCharacter(NULL);
     }
     else
     {
-        delete pPartnerCharacter;
-        pPartnerCharacter = Case::GetInstance()->GetFieldCharacterManager()->GetCharacterFromId(Case::GetInstance()->GetPartnerManager()->GetCurrentPartnerId());
+        SetPartnerCharacter(Case::GetInstance()->GetFieldCharacterManager()->GetCharacterFromId(Case::GetInstance()->GetPartnerManager()->GetCurrentPartnerId()));
 
         // If the player is loading, it's unlikely that we'd want to maintain using the field ability,
         // so we'll disable it in that circumstance.
@@ -3213,6 +3291,11 @@ void Location::StartCharacterOnPath(FieldCharacter *pCharacter, Vector2 endPosit
 {
     Vector2 currentPosition = pCharacter->GetVectorAnchorPosition();
 
+#ifdef HEADLESS
+    // Headless runs find paths on this thread so that characters start moving on the same frame every time.
+    doAsync = false;
+#endif
+
     if (doAsync)
     {
         SDL_SemWait(pPathfindingValuesSemaphore);
@@ -3228,6 +3311,12 @@ void Location::StartCharacterOnPath(FieldCharacter *pCharacter, Vector2 endPosit
     if (doAsync)
     {
         SDL_Thread *pThread = SDL_CreateThread(Location::PerformPathfindingStatic, "PathfindingThread", new PathfindingThreadParameters(this, pCharacter, currentPosition, endPosition, characterStateIfMoving, lastPathfindingThreadId));
+
+        if (pThread != NULL)
+        {
+            activePathfindingThreadCount++;
+        }
+
         SDL_DetachThread(pThread);
         SDL_SemPost(pPathfindingValuesSemaphore);
     }
@@ -3260,11 +3349,18 @@ int Location::PerformPathfindingStatic(void *pData)
 
     pThis->PerformPathfinding(pCharacter, startPosition, endPosition, characterStateIfMoving, threadId);
 
+    // Until this is decremented, the content manager won't release this location.
+    SDL_SemWait(pThis->pPathfindingValuesSemaphore);
+    pThis->activePathfindingThreadCount--;
+    SDL_SemPost(pThis->pPathfindingValuesSemaphore);
+
     return 0;
 }
 
 void Location::PerformPathfinding(FieldCharacter *pCharacter, Vector2 startPosition, Vector2 endPosition, FieldCharacterState characterStateIfMoving, int threadId)
 {
+    Profiler::Zone zone("Location::PerformPathfinding");
+
     queue<Vector2> targetPositionQueue;
     Vector2 targetPosition;
 
@@ -33,9 +33,11 @@
 #include "Crowd.h"
 #include "FieldCharacter.h"
 #include "FieldCutscene.h"
+#include "FieldMovementSolver.h"
 #include "ForegroundElement.h"
 #include "ZoomedView.h"
 #include "../enums.h"
+#include "../SpatialGrid.h"
 #include "../Vector2.h"
 #include "../Events/PromptOverlayEventProvider.h"
 #include "../UserInterface/PromptOverlay.h"
@@ -77,7 +79,6 @@ public:
         {
             this->targetLocationId = targetLocationId;
             this->targetLocationName = targetLocationName;
-            this->pTargetLocation = NULL;
             this->pHitBox = NULL;
             this->transitionDirection = TransitionDirectionNorth;
             this->interactionLocation = Vector2(-1, -1);
@@ -133,7 +134,6 @@ public:
 
         string targetLocationId;
         string targetLocationName;
-        Location *pTargetLocation;
         HitBox *pHitBox;
         TransitionDirection transitionDirection;
         Vector2 interactionLocation;
@@ -216,12 +216,16 @@ public:
     vector<HiddenForegroundElement *> * GetHiddenForegroundElementList() { return &hiddenForegroundElementList; }
 
     bool GetAcceptsUserInput();
+    bool GetShouldShowTabs();
+    bool GetCanQuickSave();
 
     void UpdateLoadedTextures(bool waitUntilLoaded = true);
+    bool GetIsPathfinding();
 
     void Begin(const string &transitionId);
     void Update(int delta);
     void UpdateTabPositions(int delta);
+    Vector2 GetInterpolatedDrawingOffsetVector() const;
     void Draw();
     void DrawForScreenshot();
     void Reset();
@@ -261,6 +265,14 @@ private:
         return CompareByZOrder(pObject2, pObject1);
     }
 
+    static RectangleWH PadHitTestBounds(const RectangleWH &bounds);
+    void SetPartnerCharacter(FieldCharacter *pPartnerCharacter);
+    void UpdateHitTestGrid();
+    bool IsHitTestCandidate(ZOrderableObject *pObject);
+    void UpdateClickState(FieldCharacter *pCharacter);
+    void UpdateClickState(Crowd *pCrowd);
+    void UpdateClickState(ForegroundElement *pForegroundElement);
+
     queue<Vector2> RemoveUnnecessaryStepsFromPath(FieldCharacter *pCharacter, Vector2 startPosition, queue<Vector2> pathPositionQueue);
     bool IsCollisionBetweenTwoPositions(FieldCharacter *pCharacter, Vector2 startPosition, Vector2 endPosition);
     Vector2 FindClosestPassablePositionForCharacter(FieldCharacter *pCharacter, Vector2 position);
@@ -348,11 +360,21 @@ private:
     map<FieldCharacter *, Vector2> characterTargetPositionMap;
 
     bool movingDirectly;
+    FieldMovementSolver movementSolver;
 
     SDL_sem *pPathfindingValuesSemaphore;
     int lastPathfindingThreadId;
+    int activePathfindingThreadCount;
 
     Vector2 drawingOffsetVector;
+    Vector2 previousDrawingOffsetVector;
+
+    // Everything that can be moused over, indexed by where it can be moused over,
+    // so that we only need to hit-test the elements that are actually under the cursor.
+    SpatialGrid<ZOrderableObject *> hitTestGrid;
+    Vector2 lastHitTestPoint;
+    unsigned int lastHitTestGridVersion;
+    vector<ZOrderableObject *> hitTestCandidateList;
 
     string id;
     string backgroundSpriteId;
@@ -128,13 +128,17 @@ void CaseContent::SaveToProjectFile()
     projectFileWriter.EndElement();
 }
 
-void CaseContent::CompileToCaseFile(QString filePath)
+bool CaseContent::CompileToCaseFile(QString filePath, bool isIncremental, bool isParallel)
 {
     ArchiveWriter caseArchiveWriter;
 
-    if (!caseArchiveWriter.Init(projectFileDir.absolutePath() + "/" + filePath))
+    // When building incrementally, the archive writer reuses the compressed data
+    // for any file whose contents haven't changed since the last build,
+    // so only what's actually been edited gets compressed again.
+    // In parallel mode, files are compressed on the thread pool as they're added.
+    if (!caseArchiveWriter.Init(projectFileDir.absolutePath() + "/" + filePath, isIncremental, isParallel))
     {
-        return;
+        return false;
     }
 
     int spriteIndex = 0;
@@ -147,7 +151,7 @@ void CaseContent::CompileToCaseFile(QString filePath)
 
         if (!caseArchiveWriter.SaveFile(iter.value()->GetBackgroundFilePath(), filename))
         {
-            return;
+            return false;
         }
     }
 
@@ -170,7 +174,7 @@ void CaseContent::CompileToCaseFile(QString filePath)
 
     caseFileWriter.EndElement();
     caseArchiveWriter.SaveToFile(caseFileWriter.GetXmlString(), "case.xml");
-    caseArchiveWriter.Close();
+    return caseArchiveWriter.Close();
 }
 
 void CaseContent::WriteAnimationManager(XmlWriter *pWriter)
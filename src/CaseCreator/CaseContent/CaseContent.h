@@ -95,7 +95,7 @@ public:
     static void ReplaceInstanceFromProjectFile(QString filePath);
 
     void SaveToProjectFile();
-    void CompileToCaseFile(QString filePath);
+    bool CompileToCaseFile(QString filePath, bool isIncremental, bool isParallel);
 
     void WriteAnimationManager(XmlWriter *pWriter);
     void WriteAudioManager(XmlWriter *pWriter);
@@ -29,10 +29,14 @@ CaseContentLoaderProgressDialog::CaseContentLoaderProgressDialog(QWidget *parent
 
     pMainLayout->addWidget(pCurrentActionLabel);
 
+    pThroughputLabel = new QLabel();
+    pThroughputLabel->setAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    pMainLayout->addWidget(pThroughputLabel);
+
     setLayout(pMainLayout);
     setWindowTitle("Creating project...");
 
-    setFixedSize(600, 100);
+    setFixedSize(600, 120);
 }
 
 void CaseContentLoaderProgressDialog::Run(QString caseFilePath)
@@ -58,6 +62,7 @@ int CaseContentLoaderProgressDialog::exec()
     QObject::connect(CaseContentLoadingStager::GetCurrent(), SIGNAL(ProgressStageUpdated(QString)), this, SLOT(HandleProgressStageUpdated(QString)), Qt::QueuedConnection);
     QObject::connect(CaseContentLoadingStager::GetCurrent(), SIGNAL(ProgressPercentUpdated(int)), this, SLOT(HandleProgressPercentUpdated(int)), Qt::QueuedConnection);
     QObject::connect(CaseContentLoadingStager::GetCurrent(), SIGNAL(ProgressCurrentFileUpdated(QString)), this, SLOT(HandleProgressCurrentFileUpdated(QString)), Qt::QueuedConnection);
+    QObject::connect(CaseContentLoadingStager::GetCurrent(), SIGNAL(ProgressThroughputUpdated(QString)), this, SLOT(HandleProgressThroughputUpdated(QString)), Qt::QueuedConnection);
     return QDialog::exec();
 }
 
@@ -67,12 +72,16 @@ void CaseContentLoaderProgressDialog::accept()
     QObject::disconnect(CaseContentLoadingStager::GetCurrent(), SIGNAL(ProgressStageUpdated(QString)), this, SLOT(HandleProgressStageUpdated(QString)));
     QObject::disconnect(CaseContentLoadingStager::GetCurrent(), SIGNAL(ProgressPercentUpdated(int)), this, SLOT(HandleProgressPercentUpdated(int)));
     QObject::disconnect(CaseContentLoadingStager::GetCurrent(), SIGNAL(ProgressCurrentFileUpdated(QString)), this, SLOT(HandleProgressCurrentFileUpdated(QString)));
+    QObject::disconnect(CaseContentLoadingStager::GetCurrent(), SIGNAL(ProgressThroughputUpdated(QString)), this, SLOT(HandleProgressThroughputUpdated(QString)));
 }
 
 void CaseContentLoaderProgressDialog::HandleProgressStageUpdated(QString currentStage)
 {
     pStageLabel->setText(currentStage);
     pStageLabel->update();
+
+    pThroughputLabel->setText("");
+    pThroughputLabel->update();
 }
 
 void CaseContentLoaderProgressDialog::HandleProgressPercentUpdated(int percentDone)
@@ -93,3 +102,9 @@ void CaseContentLoaderProgressDialog::HandleProgressCurrentFileUpdated(QString c
     pCurrentActionLabel->setText("Writing " + currentActionLabelFontMetric.elidedText(currentFile, Qt::ElideLeft, originalCurrentActionLabelWidth - currentActionLabelFontMetric.width("Writing ")));
     pCurrentActionLabel->update();
 }
+
+void CaseContentLoaderProgressDialog::HandleProgressThroughputUpdated(QString throughput)
+{
+    pThroughputLabel->setText(throughput);
+    pThroughputLabel->update();
+}
@@ -28,12 +28,14 @@ public slots:
     void HandleProgressStageUpdated(QString currentStage);
     void HandleProgressPercentUpdated(int percentDone);
     void HandleProgressCurrentFileUpdated(QString currentFile);
+    void HandleProgressThroughputUpdated(QString throughput);
 
 private:
     QLabel *pStageLabel;
     QProgressBar *pProgressBar;
     QLabel *pCurrentActionLabel;
     int originalCurrentActionLabelWidth;
+    QLabel *pThroughputLabel;
 
     QFutureWatcher<void> caseLoadWatcher;
     ICaseLoadedCallback *pCallback;
@@ -8,6 +8,8 @@
 #include "XmlReader.h"
 
 #include <QPainter>
+#include <QSet>
+#include <QtConcurrent/QtConcurrent>
 
 #define DECLARE_STAGING_HELPER_LOAD_FROM_XAML_ENTRY(TYPE) \
     STAGING_HELPER_LOAD_METHOD_NAME(TYPE)(&caseFileReader);
@@ -405,12 +407,10 @@ void CaseContentLoadingStager::LoadSpriteSheets(XmlReader *pReader)
 
 void CaseContentLoadingStager::SaveSprites(ArchiveReader *pReader)
 {
-    QMap<QString, QString> spriteIdToSpriteSheetIdMap;
-    QStringList neededSpriteSheetIds;
+    QSet<QString> neededSpriteSheetIdSet;
+    QList<SpriteSheetLoadJob> spriteSheetLoadJobList;
     QMap<QString, QImage> spriteSheetIdToImageMap;
-
-    int totalImageCount = SpriteIdToFilePathMap.count();
-    int currentImageCount = 0;
+    QList<SpriteSaveJob> spriteSaveJobList;
 
     ProgressStageUpdated("Writing sprites to disk...");
     UpdateProgressPercent(0);
@@ -419,23 +419,30 @@ void CaseContentLoadingStager::SaveSprites(ArchiveReader *pReader)
     {
         if (!SpriteIdToSpriteMap.contains(iter.key()))
         {
-            totalImageCount--;
             continue;
         }
 
         QString spriteSheetId = SpriteIdToSpriteMap[iter.key()]->SpriteSheetImageId;
 
-        spriteIdToSpriteSheetIdMap[iter.key()] = spriteSheetId;
-
-        if (!neededSpriteSheetIds.contains(spriteSheetId))
+        if (!neededSpriteSheetIdSet.contains(spriteSheetId))
         {
-            neededSpriteSheetIds.push_back(spriteSheetId);
+            neededSpriteSheetIdSet.insert(spriteSheetId);
+
+            SpriteSheetLoadJob spriteSheetLoadJob;
+            spriteSheetLoadJob.pReader = pReader;
+            spriteSheetLoadJob.SpriteSheetId = spriteSheetId;
+            spriteSheetLoadJob.FilePath = spriteSheetIdToFilePathMap[spriteSheetId];
+            spriteSheetLoadJobList.push_back(spriteSheetLoadJob);
         }
     }
 
-    for (QString neededSpriteSheetId : neededSpriteSheetIds)
+    // Only extracting the sprite sheets from the archive is serialized -
+    // decoding the PNGs happens in parallel.
+    QtConcurrent::blockingMap(spriteSheetLoadJobList, CaseContentLoadingStager::LoadSpriteSheet);
+
+    for (QList<SpriteSheetLoadJob>::iterator iter = spriteSheetLoadJobList.begin(); iter != spriteSheetLoadJobList.end(); iter++)
     {
-        spriteSheetIdToImageMap[neededSpriteSheetId] = pReader->LoadImage(spriteSheetIdToFilePathMap[neededSpriteSheetId]);
+        spriteSheetIdToImageMap[iter->SpriteSheetId] = iter->Image;
     }
 
     for (QMap<QString, QString>::iterator iter = SpriteIdToFilePathMap.begin(); iter != SpriteIdToFilePathMap.end(); iter++)
@@ -445,44 +452,58 @@ void CaseContentLoadingStager::SaveSprites(ArchiveReader *pReader)
             continue;
         }
 
-        Staging::Sprite *pSprite = SpriteIdToSpriteMap[iter.key()];
-        QImage sourceSpriteSheet = spriteSheetIdToImageMap[pSprite->SpriteSheetImageId];
-        QImage fullSpriteSheetImage;
+        SpriteSaveJob spriteSaveJob;
+        spriteSaveJob.pStager = this;
+        spriteSaveJob.pSprite = SpriteIdToSpriteMap[iter.key()];
+        spriteSaveJob.SpriteSheetImage = spriteSheetIdToImageMap[spriteSaveJob.pSprite->SpriteSheetImageId];
+        spriteSaveJob.SpriteId = iter.key();
 
-        // If the original size is zero, that means that this sprite was entirely transparent.
-        // We'll just create a dummy 1x1 transparent image for that.
-        if (pSprite->OriginalSize.GetX() == 0 && pSprite->OriginalSize.GetY() == 0)
-        {
-            fullSpriteSheetImage = QImage(QSize(1, 1), sourceSpriteSheet.format());
-            fullSpriteSheetImage.fill(Qt::transparent);
-        }
-        else
-        {
-            fullSpriteSheetImage = QImage(pSprite->OriginalSize.ToQSize(), sourceSpriteSheet.format());
-            fullSpriteSheetImage.fill(Qt::transparent);
-
-            QPainter spriteSheetPainter(&fullSpriteSheetImage);
-            spriteSheetPainter.drawImage(pSprite->SpriteDrawOffset.ToQPoint(), sourceSpriteSheet.copy(pSprite->SpriteClipRect.ToQRect()));
-        }
+        GetSaveFilePaths(projectImagesFileDir, iter.value(), &spriteSaveJob.AbsoluteFilePath, &spriteSaveJob.RelativeFilePath);
+        spriteSaveJobList.push_back(spriteSaveJob);
+    }
 
-        {
-            QDir saveDir(projectImagesFileDir);
-            QString saveDirString = iter.value().left(iter.value().lastIndexOf('/'));
-            QString saveNameString = iter.value().right(iter.value().length() - iter.value().lastIndexOf('/'));
+    BeginSavingFiles(spriteSaveJobList.count());
+    QtConcurrent::blockingMap(spriteSaveJobList, CaseContentLoadingStager::SaveSprite);
 
-            saveDir.mkpath(saveDirString);
-            saveDir.cd(saveDirString);
+    for (QList<SpriteSaveJob>::iterator iter = spriteSaveJobList.begin(); iter != spriteSaveJobList.end(); iter++)
+    {
+        SpriteIdToFilePathMap[iter->SpriteId] = iter->RelativeFilePath;
+    }
+}
 
-            ProgressCurrentFileUpdated(saveDir.absolutePath().right(saveDir.absolutePath().length() - ProjectFileDir.absolutePath().length() - 1) + saveNameString + QString("..."));
+void CaseContentLoadingStager::LoadSpriteSheet(SpriteSheetLoadJob &job)
+{
+    job.Image = job.pReader->LoadImage(job.FilePath);
+}
 
-            fullSpriteSheetImage.save(saveDir.absolutePath() + saveNameString, "png");
+void CaseContentLoadingStager::SaveSprite(SpriteSaveJob &job)
+{
+    Staging::Sprite *pSprite = job.pSprite;
+    QImage spriteImage;
 
-            SpriteIdToFilePathMap[iter.key()] = saveDir.absolutePath().right(saveDir.absolutePath().length() - ProjectFileDir.absolutePath().length() - 1) + saveNameString;
-        }
+    // If the original size is zero, that means that this sprite was entirely transparent.
+    // We'll just create a dummy 1x1 transparent image for that.
+    if (pSprite->OriginalSize.GetX() == 0 && pSprite->OriginalSize.GetY() == 0)
+    {
+        spriteImage = QImage(QSize(1, 1), job.SpriteSheetImage.format());
+        spriteImage.fill(Qt::transparent);
+    }
+    else
+    {
+        spriteImage = QImage(pSprite->OriginalSize.ToQSize(), job.SpriteSheetImage.format());
+        spriteImage.fill(Qt::transparent);
 
-        currentImageCount++;
-        UpdateProgressPercent(100 * currentImageCount / totalImageCount);
+        // Drawing straight from the clip rect saves us from copying it out of the sprite sheet first.
+        QPainter spritePainter(&spriteImage);
+        spritePainter.drawImage(pSprite->SpriteDrawOffset.ToQPoint(), job.SpriteSheetImage, pSprite->SpriteClipRect.ToQRect());
+        spritePainter.end();
     }
+
+    job.pStager->ProgressCurrentFileUpdated(job.RelativeFilePath + QString("..."));
+
+    spriteImage.save(job.AbsoluteFilePath, "png");
+
+    job.pStager->NotifyFileSaved(QFileInfo(job.AbsoluteFilePath).size());
 }
 
 void CaseContentLoadingStager::LoadAudio(XmlReader *pReader)
@@ -544,106 +565,137 @@ void CaseContentLoadingStager::LoadAudio(XmlReader *pReader)
 
 void CaseContentLoadingStager::SaveAudio(ArchiveReader *pReader)
 {
+    QList<AudioSaveJob> audioSaveJobList;
+
     ProgressStageUpdated("Writing audio to disk...");
     UpdateProgressPercent(0);
 
-    int totalAudioCount = BgmIdToBgmFilePathMap.count() + SfxIdToSfxFilePathMap.count() + DialogIdToDialogFilePathMap.count();
-    int currentAudioCount = 0;
+    AddAudioSaveJobs(&audioSaveJobList, BgmIdToBgmFilePathMap, AudioTypeBgm, pReader);
+    AddAudioSaveJobs(&audioSaveJobList, SfxIdToSfxFilePathMap, AudioTypeSfx, pReader);
+    AddAudioSaveJobs(&audioSaveJobList, DialogIdToDialogFilePathMap, AudioTypeDialog, pReader);
 
-    for (QMap<QString, QString>::iterator iter = BgmIdToBgmFilePathMap.begin(); iter != BgmIdToBgmFilePathMap.end(); iter++)
+    // Each BGM consists of two files, the intro and the loop.
+    BeginSavingFiles(audioSaveJobList.count() + BgmIdToBgmFilePathMap.count());
+    QtConcurrent::blockingMap(audioSaveJobList, CaseContentLoadingStager::SaveAudioFile);
+
+    for (QList<AudioSaveJob>::iterator iter = audioSaveJobList.begin(); iter != audioSaveJobList.end(); iter++)
     {
-        SaveBGM(iter.key(), iter.value(), pReader);
+        switch (iter->Type)
+        {
+        case AudioTypeBgm:
+            BgmIdToBgmFilePathMap[iter->Id] = iter->RelativeFilePathBase;
+            break;
 
-        currentAudioCount++;
-        UpdateProgressPercent(100 * currentAudioCount / totalAudioCount);
+        case AudioTypeSfx:
+            SfxIdToSfxFilePathMap[iter->Id] = iter->RelativeFilePathBase;
+            break;
+
+        case AudioTypeDialog:
+            DialogIdToDialogFilePathMap[iter->Id] = iter->RelativeFilePathBase;
+            break;
+        }
     }
+}
 
-    for (QMap<QString, QString>::iterator iter = SfxIdToSfxFilePathMap.begin(); iter != SfxIdToSfxFilePathMap.end(); iter++)
+void CaseContentLoadingStager::AddAudioSaveJobs(QList<AudioSaveJob> *pJobList, const QMap<QString, QString> &filePathBaseMap, AudioType type, ArchiveReader *pReader)
+{
+    for (QMap<QString, QString>::const_iterator iter = filePathBaseMap.begin(); iter != filePathBaseMap.end(); iter++)
     {
-        SaveSFXOrDialog(iter.key(), iter.value(), pReader, false /* isDialog */);
+        AudioSaveJob audioSaveJob;
+        audioSaveJob.pStager = this;
+        audioSaveJob.pReader = pReader;
+        audioSaveJob.Type = type;
+        audioSaveJob.Id = iter.key();
+        audioSaveJob.ArchiveFilePathBase = iter.value();
 
-        currentAudioCount++;
-        UpdateProgressPercent(100 * currentAudioCount / totalAudioCount);
+        GetSaveFilePaths(projectAudioFileDir, iter.value(), &audioSaveJob.AbsoluteFilePathBase, &audioSaveJob.RelativeFilePathBase);
+        pJobList->push_back(audioSaveJob);
     }
+}
 
-    for (QMap<QString, QString>::iterator iter = DialogIdToDialogFilePathMap.begin(); iter != DialogIdToDialogFilePathMap.end(); iter++)
+void CaseContentLoadingStager::SaveAudioFile(AudioSaveJob &job)
+{
+    if (job.Type == AudioTypeBgm)
     {
-        SaveSFXOrDialog(iter.key(), iter.value(), pReader, true /* isDialog */);
-
-        currentAudioCount++;
-        UpdateProgressPercent(100 * currentAudioCount / totalAudioCount);
+        SaveArchiveFile(job, "A.ogg");
+        SaveArchiveFile(job, "B.ogg");
+    }
+    else
+    {
+        SaveArchiveFile(job, ".ogg");
     }
 }
 
-void CaseContentLoadingStager::SaveBGM(QString id, QString filePathBase, ArchiveReader *pReader)
+void CaseContentLoadingStager::SaveArchiveFile(AudioSaveJob &job, const QString &suffix)
 {
-    QDir saveDir(projectAudioFileDir);
-
-    QString saveDirString = filePathBase.left(filePathBase.lastIndexOf('/'));
-    QString saveNameStringBase = filePathBase.right(filePathBase.length() - filePathBase.lastIndexOf('/'));
-
-    saveDir.mkpath(saveDirString);
-    saveDir.cd(saveDirString);
-
-    unsigned int fileSizeA = 0;
-    char *pFileContentsA = reinterpret_cast<char *>(pReader->LoadFile(filePathBase + "A.ogg", &fileSizeA));
-
-    QFile savedFileA(saveDir.absolutePath() + saveNameStringBase + "A.ogg");
-
-    ProgressCurrentFileUpdated(saveDir.absolutePath().right(saveDir.absolutePath().length() - ProjectFileDir.absolutePath().length() - 1) + saveNameStringBase + "A.ogg" + QString("..."));
-
-    savedFileA.open(QIODevice::WriteOnly);
-    savedFileA.write(pFileContentsA, (qint64)fileSizeA);
-    savedFileA.close();
-
-    free(pFileContentsA);
-
-    unsigned int fileSizeB = 0;
-    char *pFileContentsB = reinterpret_cast<char *>(pReader->LoadFile(filePathBase + "B.ogg", &fileSizeB));
+    unsigned int fileSize = 0;
+    char *pFileContents = reinterpret_cast<char *>(job.pReader->LoadFile(job.ArchiveFilePathBase + suffix, &fileSize));
 
-    QFile savedFileB(saveDir.absolutePath() + saveNameStringBase + "B.ogg");
+    QFile savedFile(job.AbsoluteFilePathBase + suffix);
 
-    ProgressCurrentFileUpdated(saveDir.absolutePath().right(saveDir.absolutePath().length() - ProjectFileDir.absolutePath().length() - 1) + saveNameStringBase + "B.ogg" + QString("..."));
+    job.pStager->ProgressCurrentFileUpdated(job.RelativeFilePathBase + suffix + QString("..."));
 
-    savedFileB.open(QIODevice::WriteOnly);
-    savedFileB.write(pFileContentsB, (qint64)fileSizeB);
-    savedFileB.close();
+    savedFile.open(QIODevice::WriteOnly);
+    savedFile.write(pFileContents, (qint64)fileSize);
+    savedFile.close();
 
-    free(pFileContentsB);
+    free(pFileContents);
 
-    BgmIdToBgmFilePathMap[id] = saveDir.absolutePath().right(saveDir.absolutePath().length() - ProjectFileDir.absolutePath().length() - 1) + saveNameStringBase;
+    job.pStager->NotifyFileSaved((qint64)fileSize);
 }
 
-void CaseContentLoadingStager::SaveSFXOrDialog(QString id, QString filePathBase, ArchiveReader *pReader, bool isDialog)
+void CaseContentLoadingStager::GetSaveFilePaths(const QDir &baseDir, const QString &filePath, QString *pAbsoluteFilePath, QString *pRelativeFilePath)
 {
-    QDir saveDir(projectAudioFileDir);
-
-    QString saveDirString = filePathBase.left(filePathBase.lastIndexOf('/'));
-    QString saveNameStringBase = filePathBase.right(filePathBase.length() - filePathBase.lastIndexOf('/'));
+    QDir saveDir(baseDir);
+    QString saveDirString = filePath.left(filePath.lastIndexOf('/'));
+    QString saveNameString = filePath.right(filePath.length() - filePath.lastIndexOf('/'));
 
+    // We create the directories up front so that the jobs writing into them
+    // never race each other to do so.
     saveDir.mkpath(saveDirString);
     saveDir.cd(saveDirString);
 
-    unsigned int fileSize = 0;
-    char *pFileContents = reinterpret_cast<char *>(pReader->LoadFile(filePathBase + ".ogg", &fileSize));
+    *pAbsoluteFilePath = saveDir.absolutePath() + saveNameString;
+    *pRelativeFilePath = saveDir.absolutePath().right(saveDir.absolutePath().length() - ProjectFileDir.absolutePath().length() - 1) + saveNameString;
+}
 
-    QFile savedFile(saveDir.absolutePath() + saveNameStringBase + ".ogg");
+void CaseContentLoadingStager::BeginSavingFiles(int totalFileCount)
+{
+    QMutexLocker progressLocker(&progressMutex);
 
-    ProgressCurrentFileUpdated(saveDir.absolutePath().right(saveDir.absolutePath().length() - ProjectFileDir.absolutePath().length() - 1) + saveNameStringBase + ".ogg" + QString("..."));
+    this->totalFileCount = totalFileCount;
+    savedFileCount = 0;
+    savedByteCount = 0;
+    lastThroughputUpdateMs = 0;
+    throughputTimer.start();
+}
 
-    savedFile.open(QIODevice::WriteOnly);
-    savedFile.write(pFileContents, (qint64)fileSize);
-    savedFile.close();
+void CaseContentLoadingStager::NotifyFileSaved(qint64 byteCount)
+{
+    QMutexLocker progressLocker(&progressMutex);
 
-    free(pFileContents);
+    savedFileCount++;
+    savedByteCount += byteCount;
 
-    if (isDialog)
+    if (totalFileCount > 0)
     {
-        DialogIdToDialogFilePathMap[id] = saveDir.absolutePath().right(saveDir.absolutePath().length() - ProjectFileDir.absolutePath().length() - 1) + saveNameStringBase;
+        UpdateProgressPercent(100 * savedFileCount / totalFileCount);
     }
-    else
+
+    // We don't want to flood the dialog with updates, so we'll only
+    // recompute the throughput a few times a second.
+    qint64 elapsedMs = throughputTimer.elapsed();
+
+    if (elapsedMs - lastThroughputUpdateMs >= 250 || savedFileCount == totalFileCount)
     {
-        SfxIdToSfxFilePathMap[id] = saveDir.absolutePath().right(saveDir.absolutePath().length() - ProjectFileDir.absolutePath().length() - 1) + saveNameStringBase;
+        lastThroughputUpdateMs = elapsedMs;
+
+        double elapsedSeconds = elapsedMs > 0 ? elapsedMs / 1000.0 : 0.001;
+
+        ProgressThroughputUpdated(
+            QString("%1 files/s, %2 MB/s")
+                .arg(savedFileCount / elapsedSeconds, 0, 'f', 1)
+                .arg(savedByteCount / (1024.0 * 1024.0) / elapsedSeconds, 0, 'f', 1));
     }
 }
 
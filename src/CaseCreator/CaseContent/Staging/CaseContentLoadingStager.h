@@ -19,6 +19,9 @@
 #include <QList>
 #include <QMap>
 #include <QDir>
+#include <QImage>
+#include <QMutex>
+#include <QElapsedTimer>
 
 // To make things easier for us, we'll declare a macro that'll enable us
 // to easily do things involving all of the root staging helper types.
@@ -127,8 +130,52 @@ signals:
     void ProgressStageUpdated(QString currentStage);
     void ProgressPercentUpdated(int percentDone);
     void ProgressCurrentFileUpdated(QString currentFile);
+    void ProgressThroughputUpdated(QString throughput);
 
 private:
+    enum AudioType
+    {
+        AudioTypeBgm,
+        AudioTypeSfx,
+        AudioTypeDialog,
+    };
+
+    // Each of these represents one unit of work that we hand off to the thread pool.
+    // Everything that touches shared state (the maps, the project directories)
+    // is done on the staging thread before and after, so the jobs themselves
+    // only ever read from the archive and write to their own files.
+    class SpriteSheetLoadJob
+    {
+    public:
+        ArchiveReader *pReader;
+        QString SpriteSheetId;
+        QString FilePath;
+        QImage Image;
+    };
+
+    class SpriteSaveJob
+    {
+    public:
+        CaseContentLoadingStager *pStager;
+        Staging::Sprite *pSprite;
+        QImage SpriteSheetImage;
+        QString SpriteId;
+        QString AbsoluteFilePath;
+        QString RelativeFilePath;
+    };
+
+    class AudioSaveJob
+    {
+    public:
+        CaseContentLoadingStager *pStager;
+        ArchiveReader *pReader;
+        AudioType Type;
+        QString Id;
+        QString ArchiveFilePathBase;
+        QString AbsoluteFilePathBase;
+        QString RelativeFilePathBase;
+    };
+
     static CaseContentLoadingStager *pCurrentInstance;
 
     CaseContentLoadingStager(const QString &projectFilePath, const QString &projectFileName)
@@ -149,6 +196,10 @@ private:
         projectAudioFileDir.cd("Audio");
 
         lastPercentDone = 0;
+        totalFileCount = 0;
+        savedFileCount = 0;
+        savedByteCount = 0;
+        lastThroughputUpdateMs = 0;
     }
 
     ~CaseContentLoadingStager()
@@ -158,16 +209,22 @@ private:
     }
 
     void UpdateProgressPercent(int percentDone);
+    void BeginSavingFiles(int totalFileCount);
+    void NotifyFileSaved(qint64 byteCount);
+    void GetSaveFilePaths(const QDir &baseDir, const QString &filePath, QString *pAbsoluteFilePath, QString *pRelativeFilePath);
 
     STAGING_HELPER_TYPES_OPERATION(DECLARE_STAGING_HELPER_LOAD_METHOD)
     void LoadSpriteSheets(XmlReader *pReader);
 
     void SaveSprites(ArchiveReader *pReader);
+    static void LoadSpriteSheet(SpriteSheetLoadJob &job);
+    static void SaveSprite(SpriteSaveJob &job);
 
     void LoadAudio(XmlReader *pReader);
     void SaveAudio(ArchiveReader *pReader);
-    void SaveBGM(QString id, QString filePathBase, ArchiveReader *pReader);
-    void SaveSFXOrDialog(QString id, QString filePathBase, ArchiveReader *pReader, bool isDialog);
+    void AddAudioSaveJobs(QList<AudioSaveJob> *pJobList, const QMap<QString, QString> &filePathBaseMap, AudioType type, ArchiveReader *pReader);
+    static void SaveAudioFile(AudioSaveJob &job);
+    static void SaveArchiveFile(AudioSaveJob &job, const QString &suffix);
 
     QMap<QString, QString> spriteSheetIdToFilePathMap;
 
@@ -175,6 +232,13 @@ private:
     QDir projectAudioFileDir;
 
     int lastPercentDone;
+
+    QMutex progressMutex;
+    QElapsedTimer throughputTimer;
+    int totalFileCount;
+    int savedFileCount;
+    qint64 savedByteCount;
+    qint64 lastThroughputUpdateMs;
 };
 
 #endif // CASECONTENTLOADINGSTAGER_H
@@ -16,6 +16,9 @@
 #include <QKeyEvent>
 
 #include <QFontDatabase>
+#include <QMessageBox>
+#include <QElapsedTimer>
+#include <QThread>
 
 MainWindow *MainWindow::pSingleton = NULL;
 
@@ -102,6 +105,16 @@ MainWindow::MainWindow(QWidget *parent, Qt::WindowFlags flags)
     QAction *pCompileProjectToCaseFileAction = new QAction(tr("Co&mpile project to case file"), this);
     connect(pCompileProjectToCaseFileAction, SIGNAL(triggered()), this, SLOT(CompileProjectToCaseFile()));
     pFileMenu->addAction(pCompileProjectToCaseFileAction);
+
+    QAction *pRebuildCaseFileAction = new QAction(tr("&Rebuild case file from scratch"), this);
+    connect(pRebuildCaseFileAction, SIGNAL(triggered()), this, SLOT(RebuildCaseFile()));
+    pFileMenu->addAction(pRebuildCaseFileAction);
+
+#ifdef QT_DEBUG
+    QAction *pBenchmarkCaseFileCompressionAction = new QAction(tr("&Benchmark case file compression"), this);
+    connect(pBenchmarkCaseFileCompressionAction, SIGNAL(triggered()), this, SLOT(BenchmarkCaseFileCompression()));
+    pFileMenu->addAction(pBenchmarkCaseFileCompressionAction);
+#endif
 }
 
 void MainWindow::CaseLoaded()
@@ -238,7 +251,37 @@ void MainWindow::CreateProjectFromCaseFile()
 
 void MainWindow::CompileProjectToCaseFile()
 {
-    CaseContent::GetInstance()->CompileToCaseFile("CompiledCase/Case.zip");
+    CaseContent::GetInstance()->CompileToCaseFile("CompiledCase/Case.zip", true /* isIncremental */, true /* isParallel */);
+}
+
+void MainWindow::RebuildCaseFile()
+{
+    CaseContent::GetInstance()->CompileToCaseFile("CompiledCase/Case.zip", false /* isIncremental */, true /* isParallel */);
+}
+
+void MainWindow::BenchmarkCaseFileCompression()
+{
+    // Full builds of the same project, one compressing on this thread and one on the thread pool,
+    // written to their own archives so the case file itself is left alone.
+    QElapsedTimer elapsedTimer;
+
+    elapsedTimer.start();
+    bool serialSucceeded = CaseContent::GetInstance()->CompileToCaseFile("CompiledCase/Benchmark/Serial.zip", false /* isIncremental */, false /* isParallel */);
+    qint64 serialElapsedMs = elapsedTimer.elapsed();
+
+    elapsedTimer.restart();
+    bool parallelSucceeded = CaseContent::GetInstance()->CompileToCaseFile("CompiledCase/Benchmark/Parallel.zip", false /* isIncremental */, true /* isParallel */);
+    qint64 parallelElapsedMs = elapsedTimer.elapsed();
+
+    QMessageBox::information(
+                this,
+                tr("Case file compression benchmark"),
+                tr("Single-threaded: %1 ms%2\nParallel (%3 threads): %4 ms%5")
+                    .arg(serialElapsedMs)
+                    .arg(serialSucceeded ? "" : tr(" (failed)"))
+                    .arg(QThread::idealThreadCount())
+                    .arg(parallelElapsedMs)
+                    .arg(parallelSucceeded ? "" : tr(" (failed)")));
 }
 
 void MainWindow::RefreshLists()
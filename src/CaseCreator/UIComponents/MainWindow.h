@@ -62,6 +62,8 @@ private slots:
     void SaveProject();
     void CreateProjectFromCaseFile();
     void CompileProjectToCaseFile();
+    void RebuildCaseFile();
+    void BenchmarkCaseFileCompression();
 
 private:
     static MainWindow *pSingleton;
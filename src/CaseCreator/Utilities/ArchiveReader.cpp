@@ -57,6 +57,8 @@ void * ArchiveReader::LoadFile(const QString &relativeFilePath, unsigned int *pS
 
     *pSize = 0;
 
+    QMutexLocker zipArchiveLocker(&zipArchiveMutex);
+
     if (currentLanguage.length() == 0)
     {
         p = mz_zip_reader_extract_file_to_heap(&zipArchive, relativeFilePath.toStdString().c_str(), &uncompressedSize, 0);
@@ -6,6 +6,7 @@
 #include <QString>
 #include <QStringList>
 #include <QImage>
+#include <QMutex>
 
 class ArchiveReader
 {
@@ -25,6 +26,10 @@ public:
 private:
     mz_zip_archive zipArchive;
 
+    // miniz reads from a single file handle, so only one thread can be extracting at a time.
+    // Decoding what's been extracted doesn't need the lock, so LoadImage() can run in parallel.
+    QMutex zipArchiveMutex;
+
     QStringList languages;
     QString baseLanguage;
     QString currentLanguage;
@@ -1,19 +1,35 @@
 #include "ArchiveWriter.h"
 
 #include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
 #include <QDir>
+#include <QCryptographicHash>
+#include <QTextStream>
+#include <QThread>
+#include <QtConcurrent/QtConcurrent>
 
 ArchiveWriter::ArchiveWriter()
     : zipArchive(mz_zip_archive())
+    , previousZipArchive(mz_zip_archive())
 {
+    hasPreviousZipArchive = false;
+    isParallel = false;
+    pendingEntryWriteFailed = false;
 }
 
 ArchiveWriter::~ArchiveWriter()
 {
     mz_zip_writer_end(&zipArchive);
+
+    if (hasPreviousZipArchive)
+    {
+        mz_zip_reader_end(&previousZipArchive);
+        hasPreviousZipArchive = false;
+    }
 }
 
-bool ArchiveWriter::Init(const QString &archiveFilePath)
+bool ArchiveWriter::Init(const QString &archiveFilePath, bool isIncremental, bool isParallel)
 {
     QDir archiveDir(archiveFilePath.left(archiveFilePath.lastIndexOf("/")));
 
@@ -22,12 +38,75 @@ bool ArchiveWriter::Init(const QString &archiveFilePath)
         return false;
     }
 
+    this->archiveFilePath = archiveFilePath;
+    previousArchiveFilePath = archiveFilePath + ".previous";
+
+    this->isParallel = isParallel;
+    pendingEntryWriteFailed = false;
+
+    // To build incrementally, we move the previous archive out of the way
+    // and read from it while writing the new one in its place.
+    if (isIncremental && QFile::exists(archiveFilePath) && QFile::exists(GetManifestFilePath(archiveFilePath)))
+    {
+        QFile::remove(previousArchiveFilePath);
+
+        if (QFile::rename(archiveFilePath, previousArchiveFilePath) &&
+                mz_zip_reader_init_file(&previousZipArchive, previousArchiveFilePath.toStdString().c_str(), 0) > 0)
+        {
+            hasPreviousZipArchive = true;
+            LoadPreviousManifest();
+        }
+    }
+
     return mz_zip_writer_init_file(&zipArchive, archiveFilePath.toStdString().c_str(), 0) > 0;
 }
 
 bool ArchiveWriter::SaveFile(const QString &diskFilePath, const QString &relativeFilePath)
 {
-    return mz_zip_writer_add_file(&zipArchive, relativeFilePath.toStdString().c_str(), diskFilePath.toStdString().c_str(), NULL, 0, 9);
+    QFileInfo diskFileInfo(diskFilePath);
+    ManifestEntry manifestEntry;
+
+    manifestEntry.Size = diskFileInfo.size();
+    manifestEntry.LastModifiedTime = diskFileInfo.lastModified().toMSecsSinceEpoch();
+
+    // If the size and timestamp are the same as last time, we'll trust that the contents are as well,
+    // which saves us from having to read the whole file just to hash it.
+    if (previousManifestEntryMap.contains(relativeFilePath) &&
+            previousManifestEntryMap[relativeFilePath].Size == manifestEntry.Size &&
+            previousManifestEntryMap[relativeFilePath].LastModifiedTime == manifestEntry.LastModifiedTime)
+    {
+        manifestEntry.Hash = previousManifestEntryMap[relativeFilePath].Hash;
+
+        int previousFileIndex = GetPreviousFileIndex(relativeFilePath, manifestEntry);
+
+        if (previousFileIndex >= 0)
+        {
+            manifestEntryMap[relativeFilePath] = manifestEntry;
+            return SaveEntryFromPreviousArchive(previousFileIndex, relativeFilePath);
+        }
+    }
+
+    QFile diskFile(diskFilePath);
+
+    if (!diskFile.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    QByteArray fileContents = diskFile.readAll();
+    diskFile.close();
+
+    manifestEntry.Hash = QString(QCryptographicHash::hash(fileContents, QCryptographicHash::Sha1).toHex());
+    manifestEntryMap[relativeFilePath] = manifestEntry;
+
+    int previousFileIndex = GetPreviousFileIndex(relativeFilePath, manifestEntry);
+
+    if (previousFileIndex >= 0)
+    {
+        return SaveEntryFromPreviousArchive(previousFileIndex, relativeFilePath);
+    }
+
+    return SaveEntry(fileContents, relativeFilePath);
 }
 
 bool ArchiveWriter::SaveToFile(const QString &fileContents, const QString &relativeFilePath)
@@ -37,10 +116,262 @@ bool ArchiveWriter::SaveToFile(const QString &fileContents, const QString &relat
 
 bool ArchiveWriter::SaveToFile(const char *pFileContents, unsigned int fileSize, const QString &relativeFilePath)
 {
-    return mz_zip_writer_add_mem(&zipArchive, relativeFilePath.toStdString().c_str(), pFileContents, fileSize, 9);
+    QByteArray fileContents(pFileContents, fileSize);
+
+    ManifestEntry manifestEntry;
+    manifestEntry.Size = fileSize;
+    manifestEntry.Hash = QString(QCryptographicHash::hash(fileContents, QCryptographicHash::Sha1).toHex());
+
+    manifestEntryMap[relativeFilePath] = manifestEntry;
+
+    int previousFileIndex = GetPreviousFileIndex(relativeFilePath, manifestEntry);
+
+    if (previousFileIndex >= 0)
+    {
+        return SaveEntryFromPreviousArchive(previousFileIndex, relativeFilePath);
+    }
+
+    return SaveEntry(fileContents, relativeFilePath);
 }
 
 bool ArchiveWriter::Close()
 {
-    return mz_zip_writer_finalize_archive(&zipArchive);
+    WritePendingEntries(true /* waitForAll */);
+
+    bool succeeded = !pendingEntryWriteFailed && mz_zip_writer_finalize_archive(&zipArchive) > 0;
+
+    if (hasPreviousZipArchive)
+    {
+        mz_zip_reader_end(&previousZipArchive);
+        hasPreviousZipArchive = false;
+
+        QFile::remove(previousArchiveFilePath);
+    }
+
+    // If we couldn't finish writing the archive, we don't want the next build
+    // to trust anything in it, so we'll get rid of the manifest too.
+    if (succeeded)
+    {
+        succeeded = SaveManifest();
+    }
+    else
+    {
+        QFile::remove(GetManifestFilePath(archiveFilePath));
+    }
+
+    return succeeded;
+}
+
+QString ArchiveWriter::GetManifestFilePath(const QString &archiveFilePath)
+{
+    return archiveFilePath + ".manifest";
+}
+
+void ArchiveWriter::LoadPreviousManifest()
+{
+    previousManifestEntryMap.clear();
+
+    QFile manifestFile(GetManifestFilePath(archiveFilePath));
+
+    if (!manifestFile.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        return;
+    }
+
+    QTextStream manifestStream(&manifestFile);
+    manifestStream.setCodec("UTF-8");
+
+    while (!manifestStream.atEnd())
+    {
+        QStringList manifestFields = manifestStream.readLine().split('\t');
+
+        if (manifestFields.count() != 4)
+        {
+            continue;
+        }
+
+        ManifestEntry manifestEntry;
+        manifestEntry.Size = manifestFields[1].toLongLong();
+        manifestEntry.LastModifiedTime = manifestFields[2].toLongLong();
+        manifestEntry.Hash = manifestFields[3];
+
+        previousManifestEntryMap[manifestFields[0]] = manifestEntry;
+    }
+}
+
+bool ArchiveWriter::SaveManifest()
+{
+    QFile manifestFile(GetManifestFilePath(archiveFilePath));
+
+    if (!manifestFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+    {
+        return false;
+    }
+
+    QTextStream manifestStream(&manifestFile);
+    manifestStream.setCodec("UTF-8");
+
+    for (QMap<QString, ManifestEntry>::iterator iter = manifestEntryMap.begin(); iter != manifestEntryMap.end(); iter++)
+    {
+        manifestStream << iter.key() << '\t' << iter.value().Size << '\t' << iter.value().LastModifiedTime << '\t' << iter.value().Hash << '\n';
+    }
+
+    manifestStream.flush();
+    return manifestStream.status() == QTextStream::Ok;
+}
+
+int ArchiveWriter::GetCompressionLevel(const QString &relativeFilePath)
+{
+    QString extension = relativeFilePath.mid(relativeFilePath.lastIndexOf('.') + 1).toLower();
+
+    // These formats are already compressed, so deflating them again
+    // costs a lot of time for next to no gain.  We'll just store them.
+    if (extension == "png" || extension == "ogg" || extension == "mov" || extension == "jpg")
+    {
+        return MZ_NO_COMPRESSION;
+    }
+    else
+    {
+        return MZ_BEST_COMPRESSION;
+    }
+}
+
+ArchiveWriter::CompressedEntry ArchiveWriter::CompressEntry(const QByteArray &fileContents, int compressionLevel)
+{
+    CompressedEntry compressedEntry;
+
+    compressedEntry.UncompressedSize = fileContents.size();
+    compressedEntry.UncompressedCrc32 = (mz_uint32)mz_crc32(MZ_CRC32_INIT, reinterpret_cast<const unsigned char *>(fileContents.constData()), fileContents.size());
+
+    if (compressionLevel != MZ_NO_COMPRESSION && fileContents.size() > 3)
+    {
+        size_t compressedSize = 0;
+        void *pCompressedData =
+            tdefl_compress_mem_to_heap(
+                fileContents.constData(),
+                fileContents.size(),
+                &compressedSize,
+                tdefl_create_comp_flags_from_zip_params(compressionLevel, -15 /* raw deflate */, MZ_DEFAULT_STRATEGY));
+
+        // If deflating didn't actually make the file any smaller, we'll store it instead.
+        if (pCompressedData != NULL && compressedSize < (size_t)fileContents.size())
+        {
+            compressedEntry.Data = QByteArray(reinterpret_cast<char *>(pCompressedData), (int)compressedSize);
+            compressedEntry.IsCompressed = true;
+        }
+
+        free(pCompressedData);
+    }
+
+    if (!compressedEntry.IsCompressed)
+    {
+        compressedEntry.Data = fileContents;
+    }
+
+    return compressedEntry;
+}
+
+int ArchiveWriter::GetPreviousFileIndex(const QString &relativeFilePath, const ManifestEntry &manifestEntry)
+{
+    if (!hasPreviousZipArchive ||
+            !previousManifestEntryMap.contains(relativeFilePath) ||
+            previousManifestEntryMap[relativeFilePath].Hash != manifestEntry.Hash)
+    {
+        return -1;
+    }
+
+    return mz_zip_reader_locate_file(&previousZipArchive, relativeFilePath.toStdString().c_str(), NULL, 0);
+}
+
+bool ArchiveWriter::SaveEntry(const QByteArray &fileContents, const QString &relativeFilePath)
+{
+    if (!isParallel)
+    {
+        return mz_zip_writer_add_mem(&zipArchive, relativeFilePath.toStdString().c_str(), fileContents.constData(), fileContents.size(), GetCompressionLevel(relativeFilePath)) > 0;
+    }
+
+    PendingEntry pendingEntry;
+    pendingEntry.RelativeFilePath = relativeFilePath;
+    pendingEntry.CompressedEntryFuture = QtConcurrent::run(ArchiveWriter::CompressEntry, fileContents, GetCompressionLevel(relativeFilePath));
+
+    pendingEntryList.push_back(pendingEntry);
+    WritePendingEntries(false /* waitForAll */);
+
+    return !pendingEntryWriteFailed;
+}
+
+bool ArchiveWriter::SaveEntryFromPreviousArchive(int previousFileIndex, const QString &relativeFilePath)
+{
+    // If there are entries still being compressed ahead of this one,
+    // this has to wait its turn so the archive's order stays the same as the order files were added in.
+    if (isParallel && !pendingEntryList.empty())
+    {
+        PendingEntry pendingEntry;
+        pendingEntry.RelativeFilePath = relativeFilePath;
+        pendingEntry.PreviousFileIndex = previousFileIndex;
+
+        pendingEntryList.push_back(pendingEntry);
+        WritePendingEntries(false /* waitForAll */);
+
+        return !pendingEntryWriteFailed;
+    }
+
+    // This copies the entry's deflate stream verbatim, so we skip compressing it entirely.
+    return mz_zip_writer_add_from_zip_reader(&zipArchive, &previousZipArchive, (mz_uint)previousFileIndex) > 0;
+}
+
+void ArchiveWriter::WritePendingEntries(bool waitForAll)
+{
+    // We write out entries as soon as everything ahead of them is done,
+    // and only block once there are enough in flight to keep every core busy,
+    // which keeps us from holding the entire archive in memory at once.
+    int maxPendingEntryCount = 2 * QThread::idealThreadCount();
+
+    while (!pendingEntryList.empty())
+    {
+        PendingEntry &pendingEntry = pendingEntryList.front();
+        bool isReady = pendingEntry.PreviousFileIndex >= 0 || pendingEntry.CompressedEntryFuture.isFinished();
+
+        if (!isReady && !waitForAll && pendingEntryList.count() <= maxPendingEntryCount)
+        {
+            break;
+        }
+
+        bool succeeded = false;
+
+        if (pendingEntry.PreviousFileIndex >= 0)
+        {
+            succeeded = mz_zip_writer_add_from_zip_reader(&zipArchive, &previousZipArchive, (mz_uint)pendingEntry.PreviousFileIndex) > 0;
+        }
+        else
+        {
+            CompressedEntry compressedEntry = pendingEntry.CompressedEntryFuture.result();
+
+            if (compressedEntry.IsCompressed)
+            {
+                succeeded =
+                    mz_zip_writer_add_mem_ex(
+                        &zipArchive,
+                        pendingEntry.RelativeFilePath.toStdString().c_str(),
+                        compressedEntry.Data.constData(),
+                        compressedEntry.Data.size(),
+                        NULL,
+                        0,
+                        MZ_BEST_COMPRESSION | MZ_ZIP_FLAG_COMPRESSED_DATA,
+                        compressedEntry.UncompressedSize,
+                        compressedEntry.UncompressedCrc32) > 0;
+            }
+            else
+            {
+                succeeded = mz_zip_writer_add_mem(&zipArchive, pendingEntry.RelativeFilePath.toStdString().c_str(), compressedEntry.Data.constData(), compressedEntry.Data.size(), MZ_NO_COMPRESSION) > 0;
+            }
+        }
+
+        if (!succeeded)
+        {
+            pendingEntryWriteFailed = true;
+        }
+
+        pendingEntryList.pop_front();
+    }
 }
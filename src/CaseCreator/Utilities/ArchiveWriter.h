@@ -5,6 +5,10 @@
 
 #include <QString>
 #include <QImage>
+#include <QMap>
+#include <QList>
+#include <QByteArray>
+#include <QFuture>
 
 class ArchiveWriter
 {
@@ -12,14 +16,86 @@ public:
     ArchiveWriter();
     ~ArchiveWriter();
 
-    bool Init(const QString &archiveFilePath);
+    bool Init(const QString &archiveFilePath, bool isIncremental = false, bool isParallel = false);
     bool SaveFile(const QString &diskFilePath, const QString &relativeFilePath);
     bool SaveToFile(const QString &fileContents, const QString &relativeFilePath);
     bool SaveToFile(const char *pFileContents, unsigned int fileSize, const QString &relativeFilePath);
     bool Close();
 
 private:
+    // Alongside each archive, we keep a manifest recording a content hash for every file in it.
+    // When building incrementally, any file whose hash matches the previous build
+    // has its already-compressed data copied straight across rather than being compressed again.
+    class ManifestEntry
+    {
+    public:
+        ManifestEntry()
+        {
+            Size = 0;
+            LastModifiedTime = 0;
+        }
+
+        qint64 Size;
+        qint64 LastModifiedTime;
+        QString Hash;
+    };
+
+    // In parallel mode, each file is deflated on the thread pool into one of these,
+    // and then written into the archive by the calling thread in the order it was added.
+    class CompressedEntry
+    {
+    public:
+        CompressedEntry()
+        {
+            UncompressedSize = 0;
+            UncompressedCrc32 = 0;
+            IsCompressed = false;
+        }
+
+        QByteArray Data;
+        mz_uint64 UncompressedSize;
+        mz_uint32 UncompressedCrc32;
+        bool IsCompressed;
+    };
+
+    class PendingEntry
+    {
+    public:
+        PendingEntry()
+        {
+            PreviousFileIndex = -1;
+        }
+
+        QString RelativeFilePath;
+        int PreviousFileIndex;
+        QFuture<CompressedEntry> CompressedEntryFuture;
+    };
+
+    static QString GetManifestFilePath(const QString &archiveFilePath);
+    static int GetCompressionLevel(const QString &relativeFilePath);
+    static CompressedEntry CompressEntry(const QByteArray &fileContents, int compressionLevel);
+
+    void LoadPreviousManifest();
+    bool SaveManifest();
+    int GetPreviousFileIndex(const QString &relativeFilePath, const ManifestEntry &manifestEntry);
+
+    bool SaveEntry(const QByteArray &fileContents, const QString &relativeFilePath);
+    bool SaveEntryFromPreviousArchive(int previousFileIndex, const QString &relativeFilePath);
+    void WritePendingEntries(bool waitForAll);
+
     mz_zip_archive zipArchive;
+    mz_zip_archive previousZipArchive;
+    bool hasPreviousZipArchive;
+
+    QString archiveFilePath;
+    QString previousArchiveFilePath;
+
+    QMap<QString, ManifestEntry> previousManifestEntryMap;
+    QMap<QString, ManifestEntry> manifestEntryMap;
+
+    bool isParallel;
+    QList<PendingEntry> pendingEntryList;
+    bool pendingEntryWriteFailed;
 };
 
 #endif // ARCHIVEWRITER_H
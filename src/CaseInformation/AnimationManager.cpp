@@ -34,12 +34,12 @@
 
 AnimationManager::~AnimationManager()
 {
-    for (map<string, Animation *>::iterator iter = animationByIdMap.begin(); iter != animationByIdMap.end(); ++iter)
+    for (unordered_map<IdHandle, Animation *>::iterator iter = animationByIdMap.begin(); iter != animationByIdMap.end(); ++iter)
     {
         delete iter->second;
     }
 
-    for (map<string, Video *>::iterator iter = videoByIdMap.begin(); iter != videoByIdMap.end(); ++iter)
+    for (unordered_map<IdHandle, Video *>::iterator iter = videoByIdMap.begin(); iter != videoByIdMap.end(); ++iter)
     {
         delete iter->second;
     }
@@ -48,7 +48,7 @@ AnimationManager::~AnimationManager()
 void AnimationManager::AddAnimation(const string &animationId, Animation **ppAnimation)
 {
     Animation *pAnimation = new Animation(managerSource);
-    animationByIdMap[animationId] = pAnimation;
+    animationByIdMap[SymbolTable::Intern(animationId)] = pAnimation;
 
     *ppAnimation = pAnimation;
 }
@@ -56,33 +56,53 @@ void AnimationManager::AddAnimation(const string &animationId, Animation **ppAni
 void AnimationManager::AddVideo(const string &videoId, Video **ppVideo, bool shouldLoop)
 {
     Video *pVideo = new Video(shouldLoop);
-    videoByIdMap[videoId] = pVideo;
+    videoByIdMap[SymbolTable::Intern(videoId)] = pVideo;
 
     *ppVideo = pVideo;
 }
 
 void AnimationManager::DeleteAnimation(const string &animationId)
 {
-    Animation *pAnimation = animationByIdMap[animationId];
-    animationByIdMap.erase(animationId);
-    delete pAnimation;
+    unordered_map<IdHandle, Animation *>::iterator iter = animationByIdMap.find(SymbolTable::Find(animationId));
+
+    if (iter != animationByIdMap.end())
+    {
+        delete iter->second;
+        animationByIdMap.erase(iter);
+    }
 }
 
 void AnimationManager::DeleteVideo(const string &videoId)
 {
-    Video *pVideo = videoByIdMap[videoId];
-    videoByIdMap.erase(videoId);
-    delete pVideo;
+    unordered_map<IdHandle, Video *>::iterator iter = videoByIdMap.find(SymbolTable::Find(videoId));
+
+    if (iter != videoByIdMap.end())
+    {
+        delete iter->second;
+        videoByIdMap.erase(iter);
+    }
 }
 
 Animation * AnimationManager::GetAnimationFromId(const string &animationId)
 {
-    return animationByIdMap[animationId];
+    return GetAnimationFromId(SymbolTable::Find(animationId));
+}
+
+Animation * AnimationManager::GetAnimationFromId(IdHandle animationId)
+{
+    unordered_map<IdHandle, Animation *>::iterator iter = animationByIdMap.find(animationId);
+    return iter != animationByIdMap.end() ? iter->second : NULL;
 }
 
 Video * AnimationManager::GetVideoFromId(const string &videoId)
 {
-    return videoByIdMap[videoId];
+    return GetVideoFromId(SymbolTable::Find(videoId));
+}
+
+Video * AnimationManager::GetVideoFromId(IdHandle videoId)
+{
+    unordered_map<IdHandle, Video *>::iterator iter = videoByIdMap.find(videoId);
+    return iter != videoByIdMap.end() ? iter->second : NULL;
 }
 
 void AnimationManager::LoadFromXml(XmlReader *pReader)
@@ -94,7 +114,7 @@ void AnimationManager::LoadFromXml(XmlReader *pReader)
 
     while (pReader->MoveToNextListItem())
     {
-        string id = pReader->ReadTextElement("Id");
+        IdHandle id = SymbolTable::Intern(pReader->ReadTextElement("Id"));
         animationByIdMap[id] = new Animation(pReader, managerSource);
     }
 
@@ -105,7 +125,7 @@ void AnimationManager::LoadFromXml(XmlReader *pReader)
 
     while (pReader->MoveToNextListItem())
     {
-        string id = pReader->ReadTextElement("Id");
+        IdHandle id = SymbolTable::Intern(pReader->ReadTextElement("Id"));
         videoByIdMap[id] = new Video(pReader);
     }
 
@@ -113,36 +133,22 @@ void AnimationManager::LoadFromXml(XmlReader *pReader)
     pReader->EndElement();
 }
 
-void AnimationManager::FinishUpdateLoadedTextures(const string &newLocationId)
+void AnimationManager::FinishUpdateLoadedTextures(const vector<IdHandle> &videoIdsToLoad, const vector<IdHandle> &videoIdsToDelete)
 {
-    for (map<string, Video *>::iterator iter = videoByIdMap.begin(); iter != videoByIdMap.end(); ++iter)
+    for (unsigned int i = 0; i < videoIdsToLoad.size(); i++)
+    {
+        ResourceLoader::GetInstance()->AddVideoToLoadList(GetVideoFromId(videoIdsToLoad[i]));
+    }
+
+    for (unsigned int i = 0; i < videoIdsToDelete.size(); i++)
     {
-        bool loadSprite = false;
-        bool deleteSprite = false;
-        string videoId = iter->first;
-        Video *pVideo = iter->second;
-
-        if (pVideo == NULL)
-        {
-            continue;
-        }
-
-        pVideo->UpdateReadiness(newLocationId, &loadSprite, &deleteSprite);
-
-        if (loadSprite)
-        {
-            ResourceLoader::GetInstance()->AddVideoToLoadList(pVideo);
-        }
-        else if (deleteSprite)
-        {
-            ResourceLoader::GetInstance()->AddVideoToDeleteList(pVideo);
-        }
+        ResourceLoader::GetInstance()->AddVideoToDeleteList(GetVideoFromId(videoIdsToDelete[i]));
     }
 }
 
 void AnimationManager::UnloadResources()
 {
-    for (map<string, Video *>::iterator iter = videoByIdMap.begin(); iter != videoByIdMap.end(); ++iter)
+    for (unordered_map<IdHandle, Video *>::iterator iter = videoByIdMap.begin(); iter != videoByIdMap.end(); ++iter)
     {
         ResourceLoader::GetInstance()->AddVideoToDeleteList(iter->second);
     }
@@ -32,7 +32,8 @@
 
 #include "../Animation.h"
 #include "../Video.h"
-#include <map>
+#include "../SymbolTable.h"
+#include <unordered_map>
 
 using namespace std;
 
@@ -53,14 +54,16 @@ public:
     void DeleteAnimation(const string &animationId);
     void DeleteVideo(const string &animationId);
     Animation * GetAnimationFromId(const string &animationId);
+    Animation * GetAnimationFromId(IdHandle animationId);
     Video * GetVideoFromId(const string &videoId);
+    Video * GetVideoFromId(IdHandle videoId);
     void LoadFromXml(XmlReader *pReader);
-    void FinishUpdateLoadedTextures(const string &newLocationId);
+    void FinishUpdateLoadedTextures(const vector<IdHandle> &videoIdsToLoad, const vector<IdHandle> &videoIdsToDelete);
     void UnloadResources();
 
 private:
-    map<string, Animation *> animationByIdMap;
-    map<string, Video *> videoByIdMap;
+    unordered_map<IdHandle, Animation *> animationByIdMap;
+    unordered_map<IdHandle, Video *> videoByIdMap;
 
     ManagerSource managerSource;
 };
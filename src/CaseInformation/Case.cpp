@@ -29,6 +29,7 @@
  */
 
 #include "Case.h"
+#include "CommonCaseResources.h"
 #include "../FileFunctions.h"
 #include "../miniz.h"
 #include "../globals.h"
@@ -39,12 +40,24 @@
 #include "../Events/EventProviders.h"
 #include "../Events/CaseParsingEventProvider.h"
 
+#ifdef HEADLESS
+#include "../HeadlessRunner.h"
+#endif
+
 #include <iostream>
 
 #include <ctime>
 
 Case *Case::pInstance = NULL;
 SDL_sem *Case::pInstanceSemaphore = SDL_CreateSemaphore(1);
+SDL_sem *Case::pSaveFileSemaphore = SDL_CreateSemaphore(1);
+SDL_atomic_t Case::failedSaveCount;
+
+const int ScreenshotWidth = 246;
+const int ScreenshotHeight = 138;
+const unsigned int MaxQuickSaveSnapshotCount = 5;
+const int QuickSaveMessageDuration = 1500; // ms
+const double QuickSaveMessageMargin = 10; // px
 
 Case::Case()
     : playerCharacterId("")
@@ -61,6 +74,7 @@ Case::Case()
     pFlagManager = new FlagManager();
     pPartnerManager = new PartnerManager();
     pSpriteManager = new SpriteManager(ManagerSourceCaseFile);
+    pResidencyManager = new ResidencyManager();
 
     isFinished = false;
     isLoadingSprites = false;
@@ -70,6 +84,11 @@ Case::Case()
 
     pCurrentArea = NULL;
 
+    isQuickSaveRequested = false;
+    isQuickLoadRequested = false;
+    loadPreviousQuickSave = false;
+    quickSaveMessageTimeRemaining = 0;
+
     pLoadStageSemaphore = SDL_CreateSemaphore(1);
 }
 
@@ -88,6 +107,7 @@ Case::Case(const Case &other)
     pFlagManager = new FlagManager();
     pPartnerManager = new PartnerManager();
     pSpriteManager = new SpriteManager(ManagerSourceCaseFile);
+    pResidencyManager = new ResidencyManager();
 
     isFinished = false;
     isLoadingSprites = false;
@@ -97,6 +117,11 @@ Case::Case(const Case &other)
 
     pCurrentArea = NULL;
 
+    isQuickSaveRequested = false;
+    isQuickLoadRequested = false;
+    loadPreviousQuickSave = false;
+    quickSaveMessageTimeRemaining = 0;
+
     pLoadStageSemaphore = SDL_CreateSemaphore(1);
 }
 
@@ -124,6 +149,8 @@ Case::~Case()
     pPartnerManager = NULL;
     delete pSpriteManager;
     pSpriteManager = NULL;
+    delete pResidencyManager;
+    pResidencyManager = NULL;
 
     SDL_DestroySemaphore(pLoadStageSemaphore);
     pLoadStageSemaphore = NULL;
@@ -185,7 +212,7 @@ void Case::LoadFromXml(const string &caseFilePath)
             {
                 string locationId = reader.ReadTextElement("LocationId");
 
-                pInstance->parentLocationListsBySpriteSheetId[spriteSheetId].push_back(locationId);
+                pInstance->pResidencyManager->AddSpriteSheetParentLocation(spriteSheetId, locationId);
             }
 
             reader.EndElement();
@@ -207,7 +234,7 @@ void Case::LoadFromXml(const string &caseFilePath)
             {
                 string locationId = reader.ReadTextElement("LocationId");
 
-                pInstance->parentLocationListsByVideoId[videoId].push_back(locationId);
+                pInstance->pResidencyManager->AddVideoParentLocation(videoId, locationId);
             }
 
             reader.EndElement();
@@ -215,6 +242,9 @@ void Case::LoadFromXml(const string &caseFilePath)
 
         reader.EndElement();
 
+        pInstance->pContentManager->AddAdjacentLocations(pInstance->pResidencyManager);
+        pInstance->pResidencyManager->FinalizeTables();
+
         reader.EndElement();
     }
 
@@ -335,11 +365,52 @@ void Case::Begin()
 void Case::Update(int delta)
 {
     pCurrentArea->Update(delta);
+
+    // We wait until the area is done updating to load a quick save,
+    // since that can replace the current location out from under it.
+    if (isQuickSaveRequested || isQuickLoadRequested)
+    {
+        if (!pCurrentArea->GetCanQuickSave())
+        {
+            ShowQuickSaveMessage("Case/QuickSaveUnavailableText", "Can't quick save or load right now.");
+        }
+        else if (isQuickSaveRequested)
+        {
+            QuickSave();
+            ShowQuickSaveMessage("Case/QuickSavedText", "Quick saved.");
+        }
+        else if (QuickLoad())
+        {
+            ShowQuickSaveMessage("Case/QuickLoadedText", "Quick save loaded.");
+        }
+        else
+        {
+            ShowQuickSaveMessage("Case/NoQuickSaveText", "There's no quick save to load.");
+        }
+
+        isQuickSaveRequested = false;
+        isQuickLoadRequested = false;
+    }
+
+    if (quickSaveMessageTimeRemaining > 0)
+    {
+        quickSaveMessageTimeRemaining -= delta;
+    }
 }
 
 void Case::Draw()
 {
     pCurrentArea->Draw();
+
+    if (quickSaveMessageTimeRemaining > 0)
+    {
+        MLIFont *pFont = CommonCaseResources::GetInstance()->GetFontManager()->GetFontFromId("MouseOverFont");
+
+        if (pFont != NULL)
+        {
+            pFont->Draw(quickSaveMessage, Vector2(gScreenWidth - pFont->GetWidth(quickSaveMessage) - QuickSaveMessageMargin, QuickSaveMessageMargin));
+        }
+    }
 }
 
 void Case::DrawForScreenshot()
@@ -354,6 +425,8 @@ void Case::Reset()
     pFieldCutsceneManager->Reset();
     pFlagManager->Reset();
 
+    quickSaveSnapshotList.clear();
+
     SetIsFinished(false);
     SetLoadStage("");
 
@@ -362,34 +435,121 @@ void Case::Reset()
 
 void Case::SaveToSaveFile(const string &filePath, const string &fileExtension, const string &saveName)
 {
-    XmlWriter writer(filePath.c_str(), fileExtension.length() > 0 ? fileExtension.c_str() : NULL);
+    // Only one save may be in flight at a time, so if the previous one
+    // hasn't yet finished writing, we'll wait for it here.
+    SDL_SemWait(pSaveFileSemaphore);
 
-    writer.StartElement("Case");
+    #ifdef HEADLESS
+    HeadlessRunner::NotifySaveStarted();
+    #endif
 
-    pContentManager->SaveToSaveFile(&writer);
-    pEvidenceManager->SaveToSaveFile(&writer);
-    pFieldCutsceneManager->SaveToSaveFile(&writer);
-    pFlagManager->SaveToSaveFile(&writer);
-    pPartnerManager->SaveToSaveFile(&writer);
+    #ifdef MLI_DEBUG
+    Uint32 startTime = SDL_GetTicks();
+    #endif
 
-    pCurrentArea->SaveToSaveFile(&writer);
+    // Everything that touches case state or the renderer happens here on the game thread.
+    // The XML writer buffers its output in memory, so this amounts to taking a snapshot
+    // of the current state - the expensive work of encoding the screenshot, hashing the contents
+    // and writing the file is deferred to a background thread.
+    XmlWriter *pWriter = new XmlWriter(filePath.c_str(), fileExtension.length() > 0 ? fileExtension.c_str() : NULL);
 
-    writer.EndElement();
+    pWriter->StartElement("Case");
+
+    pContentManager->SaveToSaveFile(pWriter);
+    pEvidenceManager->SaveToSaveFile(pWriter);
+    pFieldCutsceneManager->SaveToSaveFile(pWriter);
+    pFlagManager->SaveToSaveFile(pWriter);
+    pPartnerManager->SaveToSaveFile(pWriter);
+
+    pCurrentArea->SaveToSaveFile(pWriter);
 
-    writer.StartElement("CaseMetadata");
+    pWriter->EndElement();
 
-    writer.WriteTextElement("SaveName", saveName);
-    writer.WriteIntElement("Timestamp", (int)time(NULL));
+    pWriter->StartElement("CaseMetadata");
 
-    void *pPngMemory = NULL;
+    pWriter->WriteTextElement("SaveName", saveName);
+    pWriter->WriteIntElement("Timestamp", (int)time(NULL));
+
+    Uint8 bytesPerPixel = 0;
+    Uint8 *pScreenshotPixels = GetFieldScreenshotPixels(&bytesPerPixel);
+
+    #ifdef MLI_DEBUG
+    cout << "Took save snapshot in " << (SDL_GetTicks() - startTime) << " ms." << endl;
+    #endif
+
+    SDL_Thread *pThread = SDL_CreateThread(Case::FinishSaveToSaveFileStatic, "SaveFileThread", new FinishSaveToSaveFileParameters(pWriter, pScreenshotPixels, bytesPerPixel));
+
+    if (pThread != NULL)
+    {
+        SDL_DetachThread(pThread);
+    }
+    else
+    {
+        // If we couldn't spin up a thread for whatever reason,
+        // we'll just finish the save synchronously.
+        FinishSaveToSaveFile(pWriter, pScreenshotPixels, bytesPerPixel);
+    }
+}
+
+int Case::FinishSaveToSaveFileStatic(void *pData)
+{
+    FinishSaveToSaveFileParameters *pParams = reinterpret_cast<FinishSaveToSaveFileParameters *>(pData);
+
+    XmlWriter *pWriter = pParams->pWriter;
+    Uint8 *pScreenshotPixels = pParams->pScreenshotPixels;
+    Uint8 bytesPerPixel = pParams->bytesPerPixel;
+
+    delete pParams;
+
+    FinishSaveToSaveFile(pWriter, pScreenshotPixels, bytesPerPixel);
+
+    return 0;
+}
+
+void Case::FinishSaveToSaveFile(XmlWriter *pWriter, Uint8 *pScreenshotPixels, Uint8 bytesPerPixel)
+{
     size_t pngSize = 0;
-    Case::GetInstance()->GetFieldScreenshot(&pPngMemory, &pngSize);
+    void *pPngMemory = tdefl_write_image_to_png_file_in_memory(pScreenshotPixels, ScreenshotWidth, ScreenshotHeight, bytesPerPixel, &pngSize);
+    delete [] pScreenshotPixels;
 
-    writer.WritePngElement("Screenshot", pPngMemory, pngSize);
+    pWriter->WritePngElement("Screenshot", pPngMemory, pngSize);
 
     free(pPngMemory);
 
-    writer.EndElement();
+    pWriter->EndElement();
+
+    bool saveSucceeded = pWriter->WriteToFile();
+    delete pWriter;
+
+    SDL_SemPost(pSaveFileSemaphore);
+
+    // The player needs to know if their progress wasn't saved,
+    // since otherwise they'd only find out when they next try to load it.
+    // We might be on the save thread, though, so we'll leave telling them to the game loop.
+    if (!saveSucceeded)
+    {
+        SDL_AtomicAdd(&failedSaveCount, 1);
+    }
+}
+
+void Case::WaitForPendingSaves()
+{
+    SDL_SemWait(pSaveFileSemaphore);
+    SDL_SemPost(pSaveFileSemaphore);
+}
+
+void Case::ReportFailedSaves()
+{
+    if (SDL_AtomicSet(&failedSaveCount, 0) == 0)
+    {
+        return;
+    }
+
+    #ifdef HEADLESS
+        cout << "Couldn't write the save file." << endl;
+    #else
+        SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Couldn't save", "Couldn't write the save file. Your progress since the last save has not been saved.\n\nCheck that there is free disk space and that the save folder can be written to.", gpWindow);
+    #endif
 }
 
 void Case::Autosave()
@@ -398,10 +558,19 @@ void Case::Autosave()
 }
 
 void Case::GetFieldScreenshot(void **ppPngMemory, size_t *pPngSize)
+{
+    Uint8 bytesPerPixel = 0;
+    Uint8 *pPixels = GetFieldScreenshotPixels(&bytesPerPixel);
+
+    *ppPngMemory = tdefl_write_image_to_png_file_in_memory(pPixels, ScreenshotWidth, ScreenshotHeight, bytesPerPixel, pPngSize);
+    delete [] pPixels;
+}
+
+Uint8 * Case::GetFieldScreenshotPixels(Uint8 *pBytesPerPixel)
 {
     gIsSavingScreenshot = true;
-    gScreenshotWidth = 246;
-    gScreenshotHeight = 138;
+    gScreenshotWidth = ScreenshotWidth;
+    gScreenshotHeight = ScreenshotHeight;
 
 #if SDL_BYTEORDER == SDL_LIL_ENDIAN
     Uint32 targetPixelFormat = SDL_PIXELFORMAT_ABGR8888;
@@ -416,19 +585,22 @@ void Case::GetFieldScreenshot(void **ppPngMemory, size_t *pPngSize)
 
     Uint8 targetBytesPerPixel = SDL_BYTESPERPIXEL(targetPixelFormat);
     int targetPitch = gScreenshotWidth * targetBytesPerPixel;
-    Uint8 *pPixels = new Uint8[gScreenshotHeight * targetPitch];
+    // Zeroed in case the renderer can't give us every pixel, as with the headless renderer.
+    Uint8 *pPixels = new Uint8[gScreenshotHeight * targetPitch]();
 
     SDL_Rect rect = { 0, 0, gScreenshotWidth, gScreenshotHeight };
     SDL_RenderReadPixels(gpRenderer, &rect, targetPixelFormat, pPixels, targetPitch);
 
-    *ppPngMemory = tdefl_write_image_to_png_file_in_memory(pPixels, gScreenshotWidth, gScreenshotHeight, targetBytesPerPixel, pPngSize);
-    delete [] pPixels;
-
     gIsSavingScreenshot = false;
+
+    *pBytesPerPixel = targetBytesPerPixel;
+    return pPixels;
 }
 
 void Case::LoadFromSaveFile(const string &filePath)
 {
+    WaitForPendingSaves();
+
     XmlReader reader(filePath.c_str());
 
     reader.StartElement("Case");
@@ -447,6 +619,96 @@ void Case::LoadFromSaveFile(const string &filePath)
     SetLoadStage("");
 }
 
+void Case::QuickSave()
+{
+    #ifdef MLI_DEBUG
+    Uint32 startTime = SDL_GetTicks();
+    #endif
+
+    QuickSaveSnapshot snapshot;
+
+    snapshot.flagStateSnapshot = pFlagManager->CreateSnapshot();
+    snapshot.evidenceSnapshot = pEvidenceManager->CreateSnapshot();
+    snapshot.currentPartnerId = pPartnerManager->GetCurrentPartnerId();
+
+    XmlWriter writer(NULL);
+
+    writer.StartElement("Case");
+
+    pContentManager->SaveToSaveFile(&writer);
+    pFieldCutsceneManager->SaveToSaveFile(&writer);
+
+    pCurrentArea->SaveToSaveFile(&writer);
+
+    writer.EndElement();
+
+    snapshot.contentXml = writer.GetXmlString();
+
+    quickSaveSnapshotList.push_back(snapshot);
+
+    if (quickSaveSnapshotList.size() > MaxQuickSaveSnapshotCount)
+    {
+        quickSaveSnapshotList.pop_front();
+    }
+
+    #ifdef MLI_DEBUG
+    cout << "Took quick save in " << (SDL_GetTicks() - startTime) << " ms." << endl;
+    #endif
+}
+
+bool Case::QuickLoad()
+{
+    // Loading the previous quick save discards the most recent one,
+    // so doing this repeatedly steps back through all of the quick saves we're holding onto.
+    if (loadPreviousQuickSave && quickSaveSnapshotList.size() > 1)
+    {
+        quickSaveSnapshotList.pop_back();
+    }
+
+    if (quickSaveSnapshotList.empty())
+    {
+        return false;
+    }
+
+    // A quick save only records state that's changed from the start of the case,
+    // so we need to start from a clean slate just like loading a save file does.
+    // Resetting throws away the quick saves too, though, so we'll hold onto them while we do.
+    deque<QuickSaveSnapshot> quickSaveSnapshotListToKeep;
+    quickSaveSnapshotListToKeep.swap(quickSaveSnapshotList);
+    Reset();
+    quickSaveSnapshotList.swap(quickSaveSnapshotListToKeep);
+
+    const QuickSaveSnapshot &snapshot = quickSaveSnapshotList.back();
+
+    pEvidenceManager->RestoreFromSnapshot(snapshot.evidenceSnapshot);
+    pFlagManager->RestoreFromSnapshot(snapshot.flagStateSnapshot);
+    pPartnerManager->SetCurrentPartner(snapshot.currentPartnerId);
+
+    XmlReader reader;
+    reader.ParseXmlContent(snapshot.contentXml);
+
+    reader.StartElement("Case");
+
+    pContentManager->LoadFromSaveFile(&reader);
+    pFieldCutsceneManager->LoadFromSaveFile(&reader);
+
+    Area::LoadFromSaveFile(&reader, &pCurrentArea);
+
+    reader.EndElement();
+
+    return true;
+}
+
+void Case::ShowQuickSaveMessage(const string &textId, const string &defaultText)
+{
+    quickSaveMessage = gpLocalizableContent->GetTextOrDefault(textId, defaultText);
+    quickSaveMessageTimeRemaining = QuickSaveMessageDuration;
+
+    #ifdef MLI_DEBUG
+    cout << quickSaveMessage << endl;
+    #endif
+}
+
 void Case::CacheState()
 {
     pEvidenceManager->CacheState();
@@ -517,9 +779,7 @@ void Case::UpdateLoadedTextures(const string &newLocationId, bool waitUntilLoade
     #ifdef MLI_DEBUG
     cout << "Loading sprites for location \"" << newLocationId << "\"." << endl;
     #endif
-    pSpriteManager->FinishUpdateLoadedTextures(newLocationId);
-    pAnimationManager->FinishUpdateLoadedTextures(newLocationId);
-    SetWantsToLoadResources(true);
+    FinishUpdateLoadedTextures(newLocationId);
 }
 
 int Case::FinishUpdateLoadedTexturesStatic(void *pData)
@@ -538,24 +798,54 @@ int Case::FinishUpdateLoadedTexturesStatic(void *pData)
 
 void Case::FinishUpdateLoadedTextures(const string &newLocationId)
 {
-    pSpriteManager->FinishUpdateLoadedTextures(newLocationId);
-    pAnimationManager->FinishUpdateLoadedTextures(newLocationId);
+    vector<IdHandle> spriteSheetIdsToLoad;
+    vector<IdHandle> spriteSheetIdsToDelete;
+    vector<IdHandle> videoIdsToLoad;
+    vector<IdHandle> videoIdsToDelete;
+
+    pResidencyManager->UpdateForLocation(
+        newLocationId,
+        pPartnerManager->GetCurrentPartnerId(),
+        &spriteSheetIdsToLoad,
+        &spriteSheetIdsToDelete,
+        &videoIdsToLoad,
+        &videoIdsToDelete);
+
+    pSpriteManager->FinishUpdateLoadedTextures(spriteSheetIdsToLoad, spriteSheetIdsToDelete);
+    pAnimationManager->FinishUpdateLoadedTextures(videoIdsToLoad, videoIdsToDelete);
     SetWantsToLoadResources(true);
 }
 
-void Case::UnloadResources()
+void Case::UpdatePrefetch()
 {
-    pAnimationManager->UnloadResources();
-    pSpriteManager->UnloadResources();
-    isUnloaded = true;
-}
+    // We only prefetch when nothing else is loading, so prefetching never
+    // delays resources that the current location actually needs.
+    if (IsLoading() ||
+        ResourceLoader::GetInstance()->HasLoadStep() ||
+        ResourceLoader::GetInstance()->HasImageTexturesToLoad())
+    {
+        return;
+    }
 
-vector<string> Case::GetParentLocationListForSpriteSheetId(const string &id)
-{
-    return parentLocationListsBySpriteSheetId[id];
+    vector<IdHandle> spriteSheetIdsToLoad;
+    vector<IdHandle> videoIdsToLoad;
+
+    if (pResidencyManager->GetNextPrefetch(&spriteSheetIdsToLoad, &videoIdsToLoad))
+    {
+        pSpriteManager->FinishUpdateLoadedTextures(spriteSheetIdsToLoad, vector<IdHandle>());
+        pAnimationManager->FinishUpdateLoadedTextures(videoIdsToLoad, vector<IdHandle>());
+        ResourceLoader::GetInstance()->SnapLoadStepQueue();
+    }
+    else
+    {
+        pContentManager->MaterializeNextAdjacentLocation();
+    }
 }
 
-vector<string> Case::GetParentLocationListForVideoId(const string &id)
+void Case::UnloadResources()
 {
-    return parentLocationListsByVideoId[id];
+    pAnimationManager->UnloadResources();
+    pSpriteManager->UnloadResources();
+    pResidencyManager->Reset();
+    isUnloaded = true;
 }
@@ -41,8 +41,10 @@
 #include "FieldCutsceneManager.h"
 #include "FlagManager.h"
 #include "PartnerManager.h"
+#include "ResidencyManager.h"
 #include "SpriteManager.h"
 
+#include <deque>
 #include <vector>
 #include <map>
 
@@ -50,6 +52,8 @@
 
 using namespace std;
 
+class XmlWriter;
+
 class Case
 {
 public:
@@ -106,6 +110,7 @@ public:
     FlagManager * GetFlagManager() { return pFlagManager; }
     PartnerManager * GetPartnerManager() { return pPartnerManager; }
     SpriteManager * GetSpriteManager() { return pSpriteManager; }
+    ResidencyManager * GetResidencyManager() { return pResidencyManager; }
 
     void Begin();
     void Update(int delta);
@@ -116,9 +121,22 @@ public:
     void CacheState();
     void LoadCachedState();
 
+    // Quick saves are kept in memory rather than written to a file,
+    // and are taken or restored at the end of the next update in which the player could save.
+    void RequestQuickSave() { this->isQuickSaveRequested = true; }
+    void RequestQuickLoad(bool loadPreviousQuickSave) { this->isQuickLoadRequested = true; this->loadPreviousQuickSave = loadPreviousQuickSave; }
+
     void SaveToSaveFile(const string &filePath, const string &fileExtension, const string &saveName);
+    static int FinishSaveToSaveFileStatic(void *pData);
+    static void FinishSaveToSaveFile(XmlWriter *pWriter, Uint8 *pScreenshotPixels, Uint8 bytesPerPixel);
+    static void WaitForPendingSaves();
+
+    // Saves are finished on a background thread, but message boxes have to be shown from the main thread,
+    // so this should be called from the game loop to tell the player about any saves that failed.
+    static void ReportFailedSaves();
     void Autosave();
     void GetFieldScreenshot(void **ppPngMemory, size_t *pPngSize);
+    Uint8 * GetFieldScreenshotPixels(Uint8 *pBytesPerPixel);
     void LoadFromSaveFile(const string &filePath);
 
     string GetPlayerCharacterId() const { return this->playerCharacterId; }
@@ -148,20 +166,24 @@ public:
     void UpdateLoadedTextures(const string &newLocationId, bool waitUntilLoaded = true);
     static int FinishUpdateLoadedTexturesStatic(void *pData);
     void FinishUpdateLoadedTextures(const string &newLocationId);
+    void UpdatePrefetch();
 
     void UnloadResources();
 
-    vector<string> GetParentLocationListForSpriteSheetId(const string &id);
-    vector<string> GetParentLocationListForVideoId(const string &id);
-
 private:
     static Case *pInstance;
     static SDL_sem *pInstanceSemaphore;
+    static SDL_sem *pSaveFileSemaphore;
+    static SDL_atomic_t failedSaveCount;
 
     Case();
     Case(const Case &other);
     ~Case();
 
+    void QuickSave();
+    bool QuickLoad();
+    void ShowQuickSaveMessage(const string &textId, const string &defaultText);
+
     AnimationManager *pAnimationManager;
     AudioManager *pAudioManager;
     ContentManager *pContentManager;
@@ -173,6 +195,7 @@ private:
     FlagManager *pFlagManager;
     PartnerManager *pPartnerManager;
     SpriteManager *pSpriteManager;
+    ResidencyManager *pResidencyManager;
 
     string playerCharacterId;
     string filePath;
@@ -188,8 +211,24 @@ private:
 
     Area *pCurrentArea;
 
-    map<string, vector<string> > parentLocationListsBySpriteSheetId;
-    map<string, vector<string> > parentLocationListsByVideoId;
+    class QuickSaveSnapshot
+    {
+    public:
+        CopyOnWriteVector<bool> flagStateSnapshot;
+        EvidenceManager::Snapshot evidenceSnapshot;
+        string currentPartnerId;
+
+        // Conversations, field cutscenes and locations don't have snapshots of their own,
+        // so their state is kept as the same XML we'd write to a save file.
+        string contentXml;
+    };
+
+    deque<QuickSaveSnapshot> quickSaveSnapshotList;
+    bool isQuickSaveRequested;
+    bool isQuickLoadRequested;
+    bool loadPreviousQuickSave;
+    string quickSaveMessage;
+    int quickSaveMessageTimeRemaining;
 
     class UpdateLoadedTexturesParameters
     {
@@ -203,6 +242,21 @@ private:
         Case *pCase;
         string newLocationId;
     };
+
+    class FinishSaveToSaveFileParameters
+    {
+    public:
+        FinishSaveToSaveFileParameters(XmlWriter *pWriter, Uint8 *pScreenshotPixels, Uint8 bytesPerPixel)
+        {
+            this->pWriter = pWriter;
+            this->pScreenshotPixels = pScreenshotPixels;
+            this->bytesPerPixel = bytesPerPixel;
+        }
+
+        XmlWriter *pWriter;
+        Uint8 *pScreenshotPixels;
+        Uint8 bytesPerPixel;
+    };
 };
 
 #endif
@@ -28,27 +28,33 @@
  */
 
 #include "ContentManager.h"
+#include "ResidencyManager.h"
 #include "../XmlReader.h"
 #include "../XmlWriter.h"
 
+// Once more locations than this have been materialized, we'll release
+// the ones that were entered least recently.
+const unsigned int MaxMaterializedLocationCount = 8;
+
 ContentManager::~ContentManager()
 {
-    for (map<string, Area *>::iterator iter = areaByIdMap.begin(); iter != areaByIdMap.end(); ++iter)
+    for (unordered_map<IdHandle, Area *>::iterator iter = areaByIdMap.begin(); iter != areaByIdMap.end(); ++iter)
     {
         delete iter->second;
     }
 
-    for (map<string, Location *>::iterator iter = locationByIdMap.begin(); iter != locationByIdMap.end(); ++iter)
+    for (unordered_map<IdHandle, LocationEntry>::iterator iter = locationEntryByIdMap.begin(); iter != locationEntryByIdMap.end(); ++iter)
     {
-        delete iter->second;
+        delete iter->second.pLocation;
+        iter->second.pLocation = NULL;
     }
 
-    for (map<string, Encounter *>::iterator iter = encounterByIdMap.begin(); iter != encounterByIdMap.end(); ++iter)
+    for (unordered_map<IdHandle, Encounter *>::iterator iter = encounterByIdMap.begin(); iter != encounterByIdMap.end(); ++iter)
     {
         delete iter->second;
     }
 
-    for (map<string, Conversation *>::iterator iter = conversationByIdMap.begin(); iter != conversationByIdMap.end(); ++iter)
+    for (unordered_map<IdHandle, Conversation *>::iterator iter = conversationByIdMap.begin(); iter != conversationByIdMap.end(); ++iter)
     {
         delete iter->second;
     }
@@ -58,27 +64,244 @@ ContentManager::~ContentManager()
 
 Area * ContentManager::GetAreaFromId(const string &areaId)
 {
-    return areaByIdMap[areaId];
+    return GetAreaFromId(SymbolTable::Find(areaId));
+}
+
+Area * ContentManager::GetAreaFromId(IdHandle areaId)
+{
+    unordered_map<IdHandle, Area *>::iterator iter = areaByIdMap.find(areaId);
+    return iter != areaByIdMap.end() ? iter->second : NULL;
 }
 
 Location * ContentManager::GetLocationFromId(const string &locationId)
 {
-    return locationByIdMap[locationId];
+    return GetLocationFromId(SymbolTable::Find(locationId));
+}
+
+Location * ContentManager::GetLocationFromId(IdHandle locationId)
+{
+    unordered_map<IdHandle, LocationEntry>::iterator iter = locationEntryByIdMap.find(locationId);
+
+    if (iter == locationEntryByIdMap.end())
+    {
+        return NULL;
+    }
+
+    return iter->second.pLocation != NULL ? iter->second.pLocation : MaterializeLocation(&iter->second);
 }
 
 Encounter * ContentManager::GetEncounterFromId(const string &encounterId)
 {
-    return encounterByIdMap[encounterId];
+    return GetEncounterFromId(SymbolTable::Find(encounterId));
+}
+
+Encounter * ContentManager::GetEncounterFromId(IdHandle encounterId)
+{
+    unordered_map<IdHandle, Encounter *>::iterator iter = encounterByIdMap.find(encounterId);
+    return iter != encounterByIdMap.end() ? iter->second : NULL;
 }
 
 Conversation * ContentManager::GetConversationFromId(const string &conversationId)
 {
-    return conversationByIdMap[conversationId];
+    return GetConversationFromId(SymbolTable::Find(conversationId));
+}
+
+Conversation * ContentManager::GetConversationFromId(IdHandle conversationId)
+{
+    unordered_map<IdHandle, Conversation *>::iterator iter = conversationByIdMap.find(conversationId);
+    return iter != conversationByIdMap.end() ? iter->second : NULL;
+}
+
+void ContentManager::AddAdjacentLocations(ResidencyManager *pResidencyManager)
+{
+    for (unordered_map<IdHandle, LocationEntry>::iterator iter = locationEntryByIdMap.begin(); iter != locationEntryByIdMap.end(); ++iter)
+    {
+        const string &locationId = SymbolTable::GetString(iter->first);
+        LocationEntry *pEntry = &iter->second;
+
+        for (unsigned int i = 0; i < pEntry->transitionTargetLocationIdList.size(); i++)
+        {
+            pResidencyManager->AddAdjacentLocation(locationId, pEntry->transitionTargetLocationIdList[i]);
+        }
+
+        // Cutscenes have their own entries in the residency tables,
+        // and they hand control back to this location when they finish.
+        for (unsigned int i = 0; i < pEntry->cutsceneIdList.size(); i++)
+        {
+            pResidencyManager->AddAdjacentLocation(locationId, pEntry->cutsceneIdList[i]);
+            pResidencyManager->AddAdjacentLocation(pEntry->cutsceneIdList[i], locationId);
+        }
+    }
+}
+
+void ContentManager::EnterLocation(Location *pLocation)
+{
+    currentLocationId = SymbolTable::Find(pLocation->GetId());
+
+    unordered_map<IdHandle, LocationEntry>::iterator iter = locationEntryByIdMap.find(currentLocationId);
+
+    if (iter != locationEntryByIdMap.end())
+    {
+        locationEnterCount++;
+        iter->second.lastEnteredIndex = locationEnterCount;
+    }
+
+    ReleaseUnusedLocations(pLocation);
+}
+
+bool ContentManager::MaterializeNextAdjacentLocation()
+{
+    // We'll build the locations the player can walk to from here while we're otherwise idle,
+    // so that walking through a door doesn't have to wait on parsing the next room.
+    if (currentLocationId == InvalidIdHandle || GetMaterializedLocationCount() >= MaxMaterializedLocationCount)
+    {
+        return false;
+    }
+
+    unordered_map<IdHandle, LocationEntry>::iterator currentIter = locationEntryByIdMap.find(currentLocationId);
+
+    if (currentIter == locationEntryByIdMap.end())
+    {
+        return false;
+    }
+
+    vector<string> *pTransitionTargetLocationIdList = &currentIter->second.transitionTargetLocationIdList;
+
+    for (unsigned int i = 0; i < pTransitionTargetLocationIdList->size(); i++)
+    {
+        unordered_map<IdHandle, LocationEntry>::iterator iter = locationEntryByIdMap.find(SymbolTable::Find((*pTransitionTargetLocationIdList)[i]));
+
+        if (iter != locationEntryByIdMap.end() && iter->second.pLocation == NULL)
+        {
+            MaterializeLocation(&iter->second);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+Location * ContentManager::MaterializeLocation(LocationEntry *pEntry)
+{
+    XmlReader reader;
+    reader.ParseXmlFragment(pEntry->xmlFragment, formattingVersion);
+
+    reader.StartElement("Entry");
+    pEntry->pLocation = new Location(&reader);
+    reader.EndElement();
+
+    // Freshly materialized locations count as recently entered,
+    // so a prefetched location isn't released before the player gets a chance to use it.
+    pEntry->lastEnteredIndex = locationEnterCount;
+
+    vector<HiddenForegroundElement *> *pHiddenForegroundElementList = pEntry->pLocation->GetHiddenForegroundElementList();
+
+    for (unsigned int i = 0; i < pHiddenForegroundElementList->size(); i++)
+    {
+        HiddenForegroundElement *pHiddenForegroundElement = (*pHiddenForegroundElementList)[i];
+        map<string, bool>::iterator iter = pEntry->isDiscoveredByHiddenForegroundElementNameMap.find(pHiddenForegroundElement->GetName());
+
+        if (iter != pEntry->isDiscoveredByHiddenForegroundElementNameMap.end())
+        {
+            pHiddenForegroundElement->SetIsDiscovered(iter->second);
+        }
+    }
+
+    pEntry->isDiscoveredByHiddenForegroundElementNameMap.clear();
+
+    return pEntry->pLocation;
+}
+
+void ContentManager::ReleaseLocation(LocationEntry *pEntry)
+{
+    // We hold onto the same state the save file does, so the location
+    // comes back exactly as the player left it.
+    vector<HiddenForegroundElement *> *pHiddenForegroundElementList = pEntry->pLocation->GetHiddenForegroundElementList();
+
+    for (unsigned int i = 0; i < pHiddenForegroundElementList->size(); i++)
+    {
+        HiddenForegroundElement *pHiddenForegroundElement = (*pHiddenForegroundElementList)[i];
+        pEntry->isDiscoveredByHiddenForegroundElementNameMap[pHiddenForegroundElement->GetName()] = pHiddenForegroundElement->GetIsDiscovered();
+    }
+
+    delete pEntry->pLocation;
+    pEntry->pLocation = NULL;
+}
+
+void ContentManager::ReleaseUnusedLocations(Location *pCurrentLocation)
+{
+    while (GetMaterializedLocationCount() > MaxMaterializedLocationCount)
+    {
+        LocationEntry *pLeastRecentlyEnteredEntry = NULL;
+
+        for (unordered_map<IdHandle, LocationEntry>::iterator iter = locationEntryByIdMap.begin(); iter != locationEntryByIdMap.end(); ++iter)
+        {
+            LocationEntry *pEntry = &iter->second;
+
+            // We can't release a location that a pathfinding thread is still working in.
+            if (pEntry->pLocation == NULL || pEntry->pLocation == pCurrentLocation || pEntry->pLocation->GetIsPathfinding())
+            {
+                continue;
+            }
+
+            if (pLeastRecentlyEnteredEntry == NULL || pEntry->lastEnteredIndex < pLeastRecentlyEnteredEntry->lastEnteredIndex)
+            {
+                pLeastRecentlyEnteredEntry = pEntry;
+            }
+        }
+
+        if (pLeastRecentlyEnteredEntry == NULL)
+        {
+            break;
+        }
+
+        ReleaseLocation(pLeastRecentlyEnteredEntry);
+    }
+}
+
+void ContentManager::ResetLocations()
+{
+    // Location::Reset() doesn't touch hidden elements, and a released location's state
+    // only lives on in its entry, so we need to clear both of those ourselves -
+    // otherwise, whatever the player found this session would survive into the next one.
+    for (unordered_map<IdHandle, LocationEntry>::iterator iter = locationEntryByIdMap.begin(); iter != locationEntryByIdMap.end(); ++iter)
+    {
+        LocationEntry *pEntry = &iter->second;
+
+        pEntry->isDiscoveredByHiddenForegroundElementNameMap.clear();
+
+        if (pEntry->pLocation != NULL)
+        {
+            pEntry->pLocation->Reset();
+
+            vector<HiddenForegroundElement *> *pHiddenForegroundElementList = pEntry->pLocation->GetHiddenForegroundElementList();
+
+            for (unsigned int i = 0; i < pHiddenForegroundElementList->size(); i++)
+            {
+                (*pHiddenForegroundElementList)[i]->SetIsDiscovered(false);
+            }
+        }
+    }
+}
+
+unsigned int ContentManager::GetMaterializedLocationCount()
+{
+    unsigned int materializedLocationCount = 0;
+
+    for (unordered_map<IdHandle, LocationEntry>::iterator iter = locationEntryByIdMap.begin(); iter != locationEntryByIdMap.end(); ++iter)
+    {
+        if (iter->second.pLocation != NULL)
+        {
+            materializedLocationCount++;
+        }
+    }
+
+    return materializedLocationCount;
 }
 
 void ContentManager::Reset()
 {
-    for (map<string, Conversation *>::iterator iter = conversationByIdMap.begin(); iter != conversationByIdMap.end(); ++iter)
+    for (unordered_map<IdHandle, Conversation *>::iterator iter = conversationByIdMap.begin(); iter != conversationByIdMap.end(); ++iter)
     {
         iter->second->SetIsEnabled(conversationToOriginalEnabledStateMap[iter->second]);
         iter->second->GetUnlockConditions()->clear();
@@ -87,12 +310,9 @@ void ContentManager::Reset()
         iter->second->ResetTopics();
     }
 
-    for (map<string, Location *>::iterator iter = locationByIdMap.begin(); iter != locationByIdMap.end(); ++iter)
-    {
-        iter->second->Reset();
-    }
+    ResetLocations();
 
-    for (map<string, Area *>::iterator iter = areaByIdMap.begin(); iter != areaByIdMap.end(); ++iter)
+    for (unordered_map<IdHandle, Area *>::iterator iter = areaByIdMap.begin(); iter != areaByIdMap.end(); ++iter)
     {
         iter->second->Reset();
     }
@@ -103,7 +323,16 @@ void ContentManager::SaveToSaveFile(XmlWriter *pWriter)
     pWriter->StartElement("ContentManager");
     pWriter->StartElement("Conversations");
 
-    for (map<string, Conversation *>::iterator iter = conversationByIdMap.begin(); iter != conversationByIdMap.end(); ++iter)
+    // The hash maps have no meaningful order, so we'll write entries sorted by ID
+    // to keep the same state always producing the same save file.
+    map<string, Conversation *> conversationsById;
+
+    for (unordered_map<IdHandle, Conversation *>::iterator iter = conversationByIdMap.begin(); iter != conversationByIdMap.end(); ++iter)
+    {
+        conversationsById[SymbolTable::GetString(iter->first)] = iter->second;
+    }
+
+    for (map<string, Conversation *>::iterator iter = conversationsById.begin(); iter != conversationsById.end(); ++iter)
     {
         if (iter->second != NULL)
         {
@@ -136,17 +365,33 @@ void ContentManager::SaveToSaveFile(XmlWriter *pWriter)
 
     pWriter->StartElement("Locations");
 
-    for (map<string, Location *>::iterator iter = locationByIdMap.begin(); iter != locationByIdMap.end(); ++iter)
+    map<string, LocationEntry *> locationEntriesById;
+
+    for (unordered_map<IdHandle, LocationEntry>::iterator iter = locationEntryByIdMap.begin(); iter != locationEntryByIdMap.end(); ++iter)
     {
-        if (iter->second != NULL)
+        locationEntriesById[SymbolTable::GetString(iter->first)] = &iter->second;
+    }
+
+    for (map<string, LocationEntry *>::iterator iter = locationEntriesById.begin(); iter != locationEntriesById.end(); ++iter)
+    {
+        LocationEntry *pEntry = iter->second;
+
+        // Locations that have never been materialized are still in their initial state,
+        // so there's nothing to save for them.
+        if (pEntry->pLocation == NULL && pEntry->isDiscoveredByHiddenForegroundElementNameMap.empty())
         {
-            pWriter->StartElement("Location");
+            continue;
+        }
 
-            pWriter->WriteTextElement("Id", iter->first);
+        pWriter->StartElement("Location");
+
+        pWriter->WriteTextElement("Id", iter->first);
 
-            pWriter->StartElement("HiddenForegroundElementList");
+        pWriter->StartElement("HiddenForegroundElementList");
 
-            vector<HiddenForegroundElement *> *pHiddenForegroundElementList = iter->second->GetHiddenForegroundElementList();
+        if (pEntry->pLocation != NULL)
+        {
+            vector<HiddenForegroundElement *> *pHiddenForegroundElementList = pEntry->pLocation->GetHiddenForegroundElementList();
 
             for (unsigned int i = 0; i < pHiddenForegroundElementList->size(); i++)
             {
@@ -159,10 +404,22 @@ void ContentManager::SaveToSaveFile(XmlWriter *pWriter)
 
                 pWriter->EndElement();
             }
-
-            pWriter->EndElement();
-            pWriter->EndElement();
         }
+        else
+        {
+            for (map<string, bool>::iterator discoveredIter = pEntry->isDiscoveredByHiddenForegroundElementNameMap.begin();
+                 discoveredIter != pEntry->isDiscoveredByHiddenForegroundElementNameMap.end();
+                 ++discoveredIter)
+            {
+                pWriter->StartElement("Entry");
+                pWriter->WriteTextElement("Name", discoveredIter->first);
+                pWriter->WriteBooleanElement("IsDiscovered", discoveredIter->second);
+                pWriter->EndElement();
+            }
+        }
+
+        pWriter->EndElement();
+        pWriter->EndElement();
     }
 
     pWriter->EndElement();
@@ -179,7 +436,7 @@ void ContentManager::LoadFromSaveFile(XmlReader *pReader)
 
     while (pReader->MoveToNextListItem())
     {
-        string id = pReader->ReadTextElement("Id");
+        IdHandle id = SymbolTable::Find(pReader->ReadTextElement("Id"));
 
         if (conversationByIdMap.count(id) > 0)
         {
@@ -205,15 +462,9 @@ void ContentManager::LoadFromSaveFile(XmlReader *pReader)
 
     pReader->EndElement();
 
-    for (map<string, Location *>::iterator iter = locationByIdMap.begin(); iter != locationByIdMap.end(); ++iter)
-    {
-        if (iter->second != NULL)
-        {
-            iter->second->Reset();
-        }
-    }
+    ResetLocations();
 
-    for (map<string, Area *>::iterator iter = areaByIdMap.begin(); iter != areaByIdMap.end(); ++iter)
+    for (unordered_map<IdHandle, Area *>::iterator iter = areaByIdMap.begin(); iter != areaByIdMap.end(); ++iter)
     {
         if (iter->second != NULL)
         {
@@ -227,13 +478,34 @@ void ContentManager::LoadFromSaveFile(XmlReader *pReader)
 
     while (pReader->MoveToNextListItem())
     {
-        string id = pReader->ReadTextElement("Id");
-        Location *pLocation = locationByIdMap[id];
+        unordered_map<IdHandle, LocationEntry>::iterator entryIter = locationEntryByIdMap.find(SymbolTable::Find(pReader->ReadTextElement("Id")));
+
+        if (entryIter == locationEntryByIdMap.end())
+        {
+            continue;
+        }
+
+        LocationEntry *pEntry = &entryIter->second;
 
         pReader->StartElement("HiddenForegroundElementList");
 
         pReader->StartList("Entry");
-        vector<HiddenForegroundElement *> *pHiddenForegroundElementList = pLocation->GetHiddenForegroundElementList();
+
+        // If the location isn't materialized, we'll just hold onto this
+        // and apply it when it is.
+        if (pEntry->pLocation == NULL)
+        {
+            while (pReader->MoveToNextListItem())
+            {
+                string name = pReader->ReadTextElement("Name");
+                pEntry->isDiscoveredByHiddenForegroundElementNameMap[name] = pReader->ReadBooleanElement("IsDiscovered");
+            }
+
+            pReader->EndElement();
+            continue;
+        }
+
+        vector<HiddenForegroundElement *> *pHiddenForegroundElementList = pEntry->pLocation->GetHiddenForegroundElementList();
 
         while (pReader->MoveToNextListItem())
         {
@@ -275,7 +547,7 @@ void ContentManager::LoadFromXml(XmlReader *pReader)
 
     while (pReader->MoveToNextListItem())
     {
-        string id = pReader->ReadTextElement("Id");
+        IdHandle id = SymbolTable::Intern(pReader->ReadTextElement("Id"));
         Conversation *pConversation = Conversation::LoadFromXml(pReader);
         conversationByIdMap[id] = pConversation;
         conversationToOriginalEnabledStateMap[pConversation] = pConversation->GetIsEnabled();
@@ -289,7 +561,7 @@ void ContentManager::LoadFromXml(XmlReader *pReader)
 
     while (pReader->MoveToNextListItem())
     {
-        string id = pReader->ReadTextElement("Id");
+        IdHandle id = SymbolTable::Intern(pReader->ReadTextElement("Id"));
         encounterByIdMap[id] = new Encounter(pReader);
     }
 
@@ -298,10 +570,42 @@ void ContentManager::LoadFromXml(XmlReader *pReader)
     pReader->StartElement("LocationByIdHashMap");
     pReader->StartList("Entry");
 
+    formattingVersion = pReader->GetFormattingVersion();
+
     while (pReader->MoveToNextListItem())
     {
-        string id = pReader->ReadTextElement("Id");
-        locationByIdMap[id] = new Location(pReader);
+        IdHandle id = SymbolTable::Intern(pReader->ReadTextElement("Id"));
+        LocationEntry *pEntry = &locationEntryByIdMap[id];
+
+        // We only pull out what we need to know about each location up front,
+        // and save the rest to be parsed when the location is actually needed.
+        pEntry->xmlFragment = pReader->GetCurrentElementXml();
+
+        pReader->StartElement("Location");
+
+        pReader->StartElement("CutsceneIdList");
+        pReader->StartList("Entry");
+
+        while (pReader->MoveToNextListItem())
+        {
+            pEntry->cutsceneIdList.push_back(pReader->ReadTextElement("CutsceneId"));
+        }
+
+        pReader->EndElement();
+
+        pReader->StartElement("TransitionList");
+        pReader->StartList("Entry");
+
+        while (pReader->MoveToNextListItem())
+        {
+            pReader->StartElement("Transition");
+            pEntry->transitionTargetLocationIdList.push_back(pReader->ReadTextElement("TargetLocationId"));
+            pReader->EndElement();
+        }
+
+        pReader->EndElement();
+
+        pReader->EndElement();
     }
 
     pReader->EndElement();
@@ -311,7 +615,7 @@ void ContentManager::LoadFromXml(XmlReader *pReader)
 
     while (pReader->MoveToNextListItem())
     {
-        string id = pReader->ReadTextElement("Id");
+        IdHandle id = SymbolTable::Intern(pReader->ReadTextElement("Id"));
         areaByIdMap[id] = new Area(pReader);
     }
 
@@ -34,7 +34,11 @@
 #include "../CaseContent/Location.h"
 #include "../CaseContent/Encounter.h"
 #include "../CaseContent/Conversation.h"
+#include "../SymbolTable.h"
 
+#include <unordered_map>
+
+class ResidencyManager;
 class XmlReader;
 class XmlWriter;
 
@@ -43,6 +47,9 @@ class ContentManager
 public:
     ContentManager()
     {
+        formattingVersion = 1;
+        currentLocationId = InvalidIdHandle;
+        locationEnterCount = 0;
     }
 
     ~ContentManager();
@@ -54,9 +61,18 @@ public:
     void SetInitialLocationId(const string &initialLocationId) { this->initialLocationId = initialLocationId; }
 
     Area * GetAreaFromId(const string &areaId);
+    Area * GetAreaFromId(IdHandle areaId);
     Location * GetLocationFromId(const string &locationId);
+    Location * GetLocationFromId(IdHandle locationId);
     Encounter * GetEncounterFromId(const string &encounterId);
+    Encounter * GetEncounterFromId(IdHandle encounterId);
     Conversation * GetConversationFromId(const string &conversationId);
+    Conversation * GetConversationFromId(IdHandle conversationId);
+
+    void AddAdjacentLocations(ResidencyManager *pResidencyManager);
+
+    void EnterLocation(Location *pLocation);
+    bool MaterializeNextAdjacentLocation();
 
     void Reset();
 
@@ -66,16 +82,49 @@ public:
     void LoadFromXml(XmlReader *pReader);
 
 private:
-    map<string, Area *> areaByIdMap;
-    map<string, Location *> locationByIdMap;
-    map<string, Encounter *> encounterByIdMap;
-    map<string, Conversation *> conversationByIdMap;
+    // Locations are only fully constructed when they're first needed.
+    // Until then - and again after being released - all we keep is the XML
+    // they're built from, what they're adjacent to, and any state that needs
+    // to survive the location being released and recreated.
+    class LocationEntry
+    {
+    public:
+        LocationEntry()
+        {
+            pLocation = NULL;
+            lastEnteredIndex = 0;
+        }
+
+        string xmlFragment;
+        vector<string> transitionTargetLocationIdList;
+        vector<string> cutsceneIdList;
+
+        Location *pLocation;
+        unsigned int lastEnteredIndex;
+
+        map<string, bool> isDiscoveredByHiddenForegroundElementNameMap;
+    };
+
+    Location * MaterializeLocation(LocationEntry *pEntry);
+    void ReleaseLocation(LocationEntry *pEntry);
+    void ResetLocations();
+    void ReleaseUnusedLocations(Location *pCurrentLocation);
+    unsigned int GetMaterializedLocationCount();
+
+    unordered_map<IdHandle, Area *> areaByIdMap;
+    unordered_map<IdHandle, LocationEntry> locationEntryByIdMap;
+    unordered_map<IdHandle, Encounter *> encounterByIdMap;
+    unordered_map<IdHandle, Conversation *> conversationByIdMap;
 
     map<Conversation *, bool> conversationToOriginalEnabledStateMap;
     map<Conversation *, bool> conversationToOriginalHasBeenCompletedStateMap;
 
     string initialAreaId;
     string initialLocationId;
+
+    int formattingVersion;
+    IdHandle currentLocationId;
+    unsigned int locationEnterCount;
 };
 
 #endif
@@ -36,6 +36,10 @@
 #include "../CaseContent/Dialog.h"
 #include <algorithm>
 
+// Each composited portrait is a screen-height render target,
+// so we keep few enough of them around to bound how much VRAM they use.
+const unsigned int MaxCachedPortraitCount = 16;
+
 Image *DialogCharacterManager::pBreakdownFlashSprite = NULL;
 EasingFunction *DialogCharacterManager::pFlashSpriteOpacityEaseIn = NULL;
 EasingFunction *DialogCharacterManager::pFlashSpriteOpacityEaseOut = NULL;
@@ -43,7 +47,7 @@ double DialogCharacterManager::flashSpriteOpacity = 0;
 
 DialogCharacterManager::~DialogCharacterManager()
 {
-    for (map<string, DialogCharacter *>::iterator iter = characterByIdMap.begin(); iter != characterByIdMap.end(); ++iter)
+    for (unordered_map<IdHandle, DialogCharacter *>::iterator iter = characterByIdMap.begin(); iter != characterByIdMap.end(); ++iter)
     {
         delete iter->second;
     }
@@ -76,12 +80,12 @@ void DialogCharacterManager::UpdateForState(State *pState, int delta)
         {
             if (pState->GetBreakdownActivePosition() != CharacterPositionNone)
             {
-                string characterId =
+                IdHandle characterId =
                     pState->GetBreakdownActivePosition() == CharacterPositionLeft ?
-                    pState->GetLeftCharacterId() :
-                    pState->GetRightCharacterId();
+                    pState->GetLeftCharacterHandle() :
+                    pState->GetRightCharacterHandle();
 
-                pBreakdownVideo = characterByIdMap[characterId]->GetBreakdownVideo();
+                pBreakdownVideo = GetCharacterFromId(characterId)->GetBreakdownVideo();
                 pBreakdownVideo->Begin();
                 pFlashSpriteOpacityEaseOut->Begin();
 
@@ -146,29 +150,29 @@ void DialogCharacterManager::UpdateForState(State *pState, int delta)
         {
             string zoomEmotion = "Zoom";
 
-            Update(pState->GetLeftCharacterId(), leftCharacterEmotionId, delta, pState->GetIsFinishingDialog(), true /* isInBackground */);
-            Update(pState->GetLeftCharacterId(), zoomEmotion, delta, pState->GetIsFinishingDialog());
+            Update(pState->GetLeftCharacterHandle(), leftCharacterEmotionId, delta, pState->GetIsFinishingDialog(), true /* isInBackground */);
+            Update(pState->GetLeftCharacterHandle(), zoomEmotion, delta, pState->GetIsFinishingDialog());
         }
         else
         {
-            Update(pState->GetLeftCharacterId(), leftCharacterEmotionId, delta, pState->GetIsFinishingDialog());
+            Update(pState->GetLeftCharacterHandle(), leftCharacterEmotionId, delta, pState->GetIsFinishingDialog());
         }
 
-        Update(pState->GetLeftReplacementCharacterId(), leftReplacementCharacterEmotionId, delta, pState->GetIsFinishingDialog());
+        Update(pState->GetLeftReplacementCharacterHandle(), leftReplacementCharacterEmotionId, delta, pState->GetIsFinishingDialog());
 
         if (pState->GetIsRightCharacterZoomed())
         {
             string zoomEmotion = "Zoom";
 
-            Update(pState->GetRightCharacterId(), rightCharacterEmotionId, delta, pState->GetIsFinishingDialog(), true /* isInBackground */);
-            Update(pState->GetRightCharacterId(), zoomEmotion, delta, pState->GetIsFinishingDialog());
+            Update(pState->GetRightCharacterHandle(), rightCharacterEmotionId, delta, pState->GetIsFinishingDialog(), true /* isInBackground */);
+            Update(pState->GetRightCharacterHandle(), zoomEmotion, delta, pState->GetIsFinishingDialog());
         }
         else
         {
-            Update(pState->GetRightCharacterId(), rightCharacterEmotionId, delta, pState->GetIsFinishingDialog());
+            Update(pState->GetRightCharacterHandle(), rightCharacterEmotionId, delta, pState->GetIsFinishingDialog());
         }
 
-        Update(pState->GetRightReplacementCharacterId(), rightReplacementCharacterEmotionId, delta, pState->GetIsFinishingDialog());
+        Update(pState->GetRightReplacementCharacterHandle(), rightReplacementCharacterEmotionId, delta, pState->GetIsFinishingDialog());
 
         if (leftCharacterEmotionId != pState->GetLeftCharacterEmotionId())
         {
@@ -207,20 +211,20 @@ void DialogCharacterManager::DrawForState(State *pState)
     {
         if (pState->GetIsLeftCharacterZoomed())
         {
-            pSpeedLinesVideo->Draw(Vector2(0, 0), characterByIdMap[pState->GetLeftCharacterId()]->GetBackgroundColor());
-            Draw(pState->GetLeftCharacterId(), "Zoom", pState->GetIsLeftCharacterTalking(), pState->GetShouldLeftCharacterChangeMouth(), false /* isRightSide */, pState->GetLeftCharacterXOffsetEasingFunction());
+            pSpeedLinesVideo->Draw(Vector2(0, 0), GetCharacterFromId(pState->GetLeftCharacterHandle())->GetBackgroundColor());
+            Draw(pState->GetLeftCharacterHandle(), "Zoom", pState->GetIsLeftCharacterTalking(), pState->GetShouldLeftCharacterChangeMouth(), false /* isRightSide */, pState->GetLeftCharacterXOffsetEasingFunction());
         }
         else if (pState->GetIsRightCharacterZoomed())
         {
-            pSpeedLinesVideo->Draw(Vector2(0, 0), true /* flipHorizontally */, characterByIdMap[pState->GetRightCharacterId()]->GetBackgroundColor());
-            Draw(pState->GetRightCharacterId(), "Zoom", pState->GetIsRightCharacterTalking(), pState->GetShouldRightCharacterChangeMouth(), true /* isRightSide */, pState->GetRightCharacterXOffsetEasingFunction());
+            pSpeedLinesVideo->Draw(Vector2(0, 0), true /* flipHorizontally */, GetCharacterFromId(pState->GetRightCharacterHandle())->GetBackgroundColor());
+            Draw(pState->GetRightCharacterHandle(), "Zoom", pState->GetIsRightCharacterTalking(), pState->GetShouldRightCharacterChangeMouth(), true /* isRightSide */, pState->GetRightCharacterXOffsetEasingFunction());
         }
         else
         {
-            Draw(pState->GetLeftCharacterId(), pState->GetLeftCharacterEmotionId(), pState->GetIsLeftCharacterTalking(), pState->GetShouldLeftCharacterChangeMouth(), false /* isRightSide */, pState->GetLeftCharacterXOffsetEasingFunction());
-            Draw(pState->GetLeftReplacementCharacterId(), pState->GetLeftReplacementCharacterEmotionId(), false /* isTalking */, false /* shouldChangeMouth */, false /* isRightSide */, pState->GetLeftReplacementCharacterXOffsetEasingFunction());
-            Draw(pState->GetRightCharacterId(), pState->GetRightCharacterEmotionId(), pState->GetIsRightCharacterTalking(), pState->GetShouldRightCharacterChangeMouth(), true /* isRightSide */, pState->GetRightCharacterXOffsetEasingFunction());
-            Draw(pState->GetRightReplacementCharacterId(), pState->GetRightReplacementCharacterEmotionId(), false /* isTalking */, false /* shouldChangeMouth */, true /* isRightSide */, pState->GetRightReplacementCharacterXOffsetEasingFunction());
+            Draw(pState->GetLeftCharacterHandle(), pState->GetLeftCharacterEmotionId(), pState->GetIsLeftCharacterTalking(), pState->GetShouldLeftCharacterChangeMouth(), false /* isRightSide */, pState->GetLeftCharacterXOffsetEasingFunction());
+            Draw(pState->GetLeftReplacementCharacterHandle(), pState->GetLeftReplacementCharacterEmotionId(), false /* isTalking */, false /* shouldChangeMouth */, false /* isRightSide */, pState->GetLeftReplacementCharacterXOffsetEasingFunction());
+            Draw(pState->GetRightCharacterHandle(), pState->GetRightCharacterEmotionId(), pState->GetIsRightCharacterTalking(), pState->GetShouldRightCharacterChangeMouth(), true /* isRightSide */, pState->GetRightCharacterXOffsetEasingFunction());
+            Draw(pState->GetRightReplacementCharacterHandle(), pState->GetRightReplacementCharacterEmotionId(), false /* isTalking */, false /* shouldChangeMouth */, true /* isRightSide */, pState->GetRightReplacementCharacterXOffsetEasingFunction());
         }
     }
     else
@@ -262,46 +266,54 @@ void DialogCharacterManager::BeginAnimations(const string &characterId, const st
         return;
     }
 
-    characterByIdMap[characterId]->BeginAnimations(emotionId);
+    GetCharacterFromId(characterId)->BeginAnimations(emotionId);
 }
 
-void DialogCharacterManager::Update(const string &characterId, string &emotionId, int delta, bool finishOneTimeEmotions, bool isInBackground)
+void DialogCharacterManager::Update(IdHandle characterId, string &emotionId, int delta, bool finishOneTimeEmotions, bool isInBackground)
 {
-    if (characterId.length() == 0)
+    if (characterId == InvalidIdHandle)
     {
         return;
     }
 
-    characterByIdMap[characterId]->Update(delta, emotionId, finishOneTimeEmotions, isInBackground);
+    GetCharacterFromId(characterId)->Update(delta, emotionId, finishOneTimeEmotions, isInBackground);
 }
 
-void DialogCharacterManager::Draw(const string &characterId, const string &emotionId, bool isTalking, bool shouldChangeMouth, bool isRightSide, EasingFunction *pCharacterXOffsetEasingFunction)
+void DialogCharacterManager::Draw(IdHandle characterId, const string &emotionId, bool isTalking, bool shouldChangeMouth, bool isRightSide, EasingFunction *pCharacterXOffsetEasingFunction)
 {
     int xOffset = (int)(pCharacterXOffsetEasingFunction == NULL ? 0 : pCharacterXOffsetEasingFunction->GetCurrentValue());
 
-    if (characterId.length() == 0)
+    if (characterId == InvalidIdHandle)
     {
         return;
     }
 
-    characterByIdMap[characterId]->Draw(emotionId, isTalking, shouldChangeMouth, isRightSide, xOffset);
+    GetCharacterFromId(characterId)->Draw(emotionId, isTalking, shouldChangeMouth, isRightSide, xOffset);
 }
 
 string DialogCharacterManager::GetCharacterNameFromId(const string &characterId)
 {
-    if (characterId.length() == 0 || characterByIdMap.count(characterId) == 0)
+    DialogCharacter *pCharacter = characterId.length() > 0 ? GetCharacterFromId(characterId) : NULL;
+
+    if (pCharacter == NULL)
     {
         return "";
     }
     else
     {
-        return characterByIdMap[characterId]->GetName();
+        return pCharacter->GetName();
     }
 }
 
 DialogCharacter * DialogCharacterManager::GetCharacterFromId(const string &characterId)
 {
-    return characterByIdMap[characterId];
+    return GetCharacterFromId(SymbolTable::Find(characterId));
+}
+
+DialogCharacter * DialogCharacterManager::GetCharacterFromId(IdHandle characterId)
+{
+    unordered_map<IdHandle, DialogCharacter *>::iterator iter = characterByIdMap.find(characterId);
+    return iter != characterByIdMap.end() ? iter->second : NULL;
 }
 
 void DialogCharacterManager::LoadFromXml(XmlReader *pReader)
@@ -317,7 +329,7 @@ void DialogCharacterManager::LoadFromXml(XmlReader *pReader)
 
     while (pReader->MoveToNextListItem())
     {
-        string id = pReader->ReadTextElement("Id");
+        IdHandle id = SymbolTable::Intern(pReader->ReadTextElement("Id"));
         characterByIdMap[id] = new DialogCharacter(pReader);
     }
 
@@ -326,6 +338,8 @@ void DialogCharacterManager::LoadFromXml(XmlReader *pReader)
     pReader->EndElement();
 }
 
+MRUCache<DialogCharacter::PortraitKey, SDL_Texture *> DialogCharacter::portraitCache(MaxCachedPortraitCount, new DialogCharacter::PortraitCacheItemHandler());
+
 DialogCharacter::OneTimeEmotion::OneTimeEmotion(XmlReader *pReader)
 {
     pVideo = NULL;
@@ -392,6 +406,9 @@ DialogCharacter::DialogCharacter(XmlReader *pReader)
         string emotionId = pReader->ReadTextElement("EmotionId");
         string spriteId = pReader->ReadTextElement("SpriteId");
 
+        // We'll key composited portraits on the emotion's handle,
+        // so we'll intern it now rather than on first draw.
+        SymbolTable::Intern(emotionId);
         characterEmotionBaseSpriteIds[emotionId] = spriteId;
     }
 
@@ -555,6 +572,10 @@ DialogCharacter::~DialogCharacter()
     {
         delete iter->second;
     }
+
+    // Characters are only ever deleted all together when a case is unloaded, along with
+    // the sprites that their portraits are keyed on, so we'll just clear out every portrait.
+    ClearPortraitCache();
 }
 
 Sprite * DialogCharacter::GetPresentCorrectEvidenceSprite()
@@ -695,35 +716,64 @@ void DialogCharacter::Update(int delta, string &emotionId, bool finishOneTimeEmo
     }
 }
 
-void DialogCharacter::Draw(string emotionId, bool isTalking, bool shouldChangeMouth, bool isRightSide, int xOffset)
+void DialogCharacter::Draw(const string &emotionId, bool isTalking, bool shouldChangeMouth, bool isRightSide, int xOffset)
 {
-    if (emotionId.length() == 0)
-    {
-        emotionId = defaultEmotionId;
-    }
+    const string &emotionIdToDraw = emotionId.length() > 0 ? emotionId : defaultEmotionId;
 
-    if (characterOneTimeEmotions.count(emotionId) > 0)
+    map<string, OneTimeEmotion *>::iterator oneTimeEmotionIter = characterOneTimeEmotions.find(emotionIdToDraw);
+
+    if (oneTimeEmotionIter != characterOneTimeEmotions.end())
     {
-        Video *pVideo = characterOneTimeEmotions[emotionId]->GetVideo();
+        Video *pVideo = oneTimeEmotionIter->second->GetVideo();
         Vector2 position((isRightSide ? (double)gScreenWidth - pVideo->GetWidth() : 0) + xOffset, (double)gScreenHeight - Dialog::Height - pVideo->GetHeight());
         pVideo->Draw(position, !isRightSide, Color::White);
         return;
     }
 
-    Sprite *pBaseSprite = GetBaseSpriteForEmotion(emotionId);
-    Sprite *pEyeSprite = GetEyeSpriteForEmotion(emotionId);
-    Sprite *pMouthSprite = GetMouthSpriteForEmotion(emotionId, isTalking, shouldChangeMouth);
-    vector<Animation *> *pForegroundLayers = GetForegroundLayersForEmotion(emotionId);
+    Sprite *pBaseSprite = GetBaseSpriteForEmotion(emotionIdToDraw);
+    Sprite *pEyeSprite = GetEyeSpriteForEmotion(emotionIdToDraw);
+    Sprite *pMouthSprite = GetMouthSpriteForEmotion(emotionIdToDraw, isTalking, shouldChangeMouth);
+    vector<Animation *> *pForegroundLayers = GetForegroundLayersForEmotion(emotionIdToDraw);
 
     if (pBaseSprite != NULL)
     {
         Vector2 position((isRightSide ? gScreenWidth / 2 : 0) + xOffset, 0);
 
-        pBaseSprite->Draw(position, Color::White, 1.0, !isRightSide);
+        // The base and eyes only change when the eyes blink, so we draw them once into
+        // a cached texture and then draw just that each frame.  The mouth and foreground layers
+        // change far more often than that, so those we continue to draw on top separately.
+        SDL_Texture *&pPortraitTexture = portraitCache[PortraitKey(pBaseSprite, pEyeSprite)];
+
+        if (pPortraitTexture == NULL && pBaseSprite->IsReady() && (pEyeSprite == NULL || pEyeSprite->IsReady()))
+        {
+            pPortraitTexture = CompositePortrait(pBaseSprite, pEyeSprite);
+        }
 
-        if (pEyeSprite != NULL)
+        if (pPortraitTexture != NULL)
         {
-            pEyeSprite->Draw(position, Color::White, 1.0, !isRightSide);
+            int portraitWidth = 0;
+            int portraitHeight = 0;
+
+            SDL_QueryTexture(pPortraitTexture, NULL, NULL, &portraitWidth, &portraitHeight);
+
+            Image::Draw(
+                pPortraitTexture,
+                Vector2((int)position.GetX(), (int)position.GetY()),
+                RectangleWH(0, 0, portraitWidth, portraitHeight),
+                !isRightSide,
+                false /* flipVertically */,
+                1.0 /* xScale */,
+                1.0 /* yScale */,
+                Color::White);
+        }
+        else
+        {
+            pBaseSprite->Draw(position, Color::White, 1.0, !isRightSide);
+
+            if (pEyeSprite != NULL)
+            {
+                pEyeSprite->Draw(position, Color::White, 1.0, !isRightSide);
+            }
         }
 
         if (pMouthSprite != NULL)
@@ -959,3 +1009,75 @@ void DialogCharacter::PopulateEyeFrameDurationList(const string &emotionId)
         eyeFrameDurationList.push_back(75);
     }
 }
+
+void DialogCharacter::ClearPortraitCache()
+{
+    portraitCache.clear();
+}
+
+SDL_Texture * DialogCharacter::CompositePortrait(Sprite *pBaseSprite, Sprite *pEyeSprite)
+{
+    // Sprites that were trimmed when the case was compiled know the size of the image they
+    // were trimmed from, which is what we want to composite into, since flipping a portrait
+    // has to flip each layer within that full image.  Untrimmed sprites are already that size.
+    // If we can't work out a single size that both layers agree on, we'll just draw them separately.
+    Vector2 portraitSize;
+
+    if (pBaseSprite->originalSize.GetX() > 0)
+    {
+        portraitSize = pBaseSprite->originalSize;
+    }
+    else if (pBaseSprite->spriteDrawOffset.GetX() == 0 && pBaseSprite->spriteDrawOffset.GetY() == 0)
+    {
+        portraitSize = Vector2(pBaseSprite->GetWidth(), pBaseSprite->GetHeight());
+    }
+    else
+    {
+        return NULL;
+    }
+
+    if (pEyeSprite != NULL &&
+        (pEyeSprite->originalSize.GetX() > 0 ?
+            pEyeSprite->originalSize != portraitSize :
+            (pEyeSprite->spriteDrawOffset.GetX() != 0 || pEyeSprite->spriteDrawOffset.GetY() != 0 || Vector2(pEyeSprite->GetWidth(), pEyeSprite->GetHeight()) != portraitSize)))
+    {
+        return NULL;
+    }
+
+    if (!SDL_RenderTargetSupported(gpRenderer))
+    {
+        return NULL;
+    }
+
+    SDL_Texture *pTexture = SDL_CreateTexture(gpRenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, (int)portraitSize.GetX(), (int)portraitSize.GetY());
+
+    if (pTexture == NULL)
+    {
+        return NULL;
+    }
+
+    // Drawing the layers into the texture with normal alpha blending leaves the texture
+    // with premultiplied alpha, so that's the blend mode we need to draw it to the screen with.
+    SDL_BlendMode premultipliedAlphaBlendMode =
+        SDL_ComposeCustomBlendMode(
+            SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+            SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+
+    if (SDL_SetTextureBlendMode(pTexture, premultipliedAlphaBlendMode) != 0 ||
+        !Image::BeginDrawingToTexture(pTexture))
+    {
+        SDL_DestroyTexture(pTexture);
+        return NULL;
+    }
+
+    pBaseSprite->Draw(Vector2(0, 0));
+
+    if (pEyeSprite != NULL)
+    {
+        pEyeSprite->Draw(Vector2(0, 0));
+    }
+
+    Image::EndDrawingToTexture();
+
+    return pTexture;
+}
@@ -30,9 +30,12 @@
 #ifndef DIALOGCHARACTERMANAGER_H
 #define DIALOGCHARACTERMANAGER_H
 
+#include "../Cache.h"
 #include "../State.h"
+#include "../SymbolTable.h"
 
 #include <deque>
+#include <unordered_map>
 #include <vector>
 
 using namespace std;
@@ -56,10 +59,11 @@ public:
     void DrawForState(State *pState);
     static void DrawInterjectionForState(State *pState);
     void BeginAnimations(const string &characterId, const string &emotionId);
-    void Update(const string &characterId, string &emotionId, int delta, bool finishOneTimeEmotions, bool isInBackground = false);
-    void Draw(const string &characterId, const string &emotionId, bool isTalking, bool shouldChangeMouth, bool isRightSide, EasingFunction *pCharacterXOffsetEasingFunction);
+    void Update(IdHandle characterId, string &emotionId, int delta, bool finishOneTimeEmotions, bool isInBackground = false);
+    void Draw(IdHandle characterId, const string &emotionId, bool isTalking, bool shouldChangeMouth, bool isRightSide, EasingFunction *pCharacterXOffsetEasingFunction);
     string GetCharacterNameFromId(const string &characterId);
     DialogCharacter * GetCharacterFromId(const string &characterId);
+    DialogCharacter * GetCharacterFromId(IdHandle characterId);
     void LoadFromXml(XmlReader *pReader);
 
 private:
@@ -68,7 +72,7 @@ private:
     static EasingFunction *pFlashSpriteOpacityEaseOut;
     static double flashSpriteOpacity;
 
-    map<string, DialogCharacter *> characterByIdMap;
+    unordered_map<IdHandle, DialogCharacter *> characterByIdMap;
     Video *pBreakdownVideo;
 
     Video *pSpeedLinesVideo;
@@ -97,6 +101,41 @@ private:
         Video *pVideo;
     };
 
+    // A composited portrait is entirely determined by the base and eye sprites drawn into it,
+    // so that's what we key it on - this way, drawing one never requires looking up an ID.
+    class PortraitKey
+    {
+    public:
+        PortraitKey(Sprite *pBaseSprite, Sprite *pEyeSprite)
+        {
+            this->pBaseSprite = pBaseSprite;
+            this->pEyeSprite = pEyeSprite;
+        }
+
+        bool operator<(const PortraitKey &other) const
+        {
+            if (pBaseSprite != other.pBaseSprite)
+            {
+                return pBaseSprite < other.pBaseSprite;
+            }
+            else
+            {
+                return pEyeSprite < other.pEyeSprite;
+            }
+        }
+
+    private:
+        Sprite *pBaseSprite;
+        Sprite *pEyeSprite;
+    };
+
+    class PortraitCacheItemHandler : public MRUCache<PortraitKey, SDL_Texture *>::ItemHandler
+    {
+    public:
+        void releaseItem(const PortraitKey &key, SDL_Texture * const &value) { if (value != NULL) { SDL_DestroyTexture(value); } }
+        SDL_Texture * newItem(const PortraitKey &key) { return NULL; }
+    };
+
 public:
     DialogCharacter()
     {
@@ -160,7 +199,7 @@ public:
 
     void BeginAnimations(string emotionId);
     void Update(int delta, string &emotionId, bool finishOneTimeEmotions, bool isInBackground = false);
-    void Draw(string emotionId, bool isTalking, bool shouldChangeMouth, bool isRightSide, int xOffset);
+    void Draw(const string &emotionId, bool isTalking, bool shouldChangeMouth, bool isRightSide, int xOffset);
     Sprite * GetBaseSpriteForEmotion(const string &emotionId);
     Sprite * GetEyeSpriteForEmotion(const string &emotionId);
     Sprite * GetMouthSpriteForEmotion(const string &emotionId, bool isTalking, bool shouldChangeMouth);
@@ -182,8 +221,13 @@ public:
 
     int GetLeadInTimeForEmotion(const string &emotionId);
 
+    static void ClearPortraitCache();
+
 private:
     void PopulateEyeFrameDurationList(const string &emotionId);
+    static SDL_Texture * CompositePortrait(Sprite *pBaseSprite, Sprite *pEyeSprite);
+
+    static MRUCache<PortraitKey, SDL_Texture *> portraitCache;
 
     map<string, string> characterEmotionBaseSpriteIds;
     map<string, vector<string> > characterEmotionEyeSpriteIds;
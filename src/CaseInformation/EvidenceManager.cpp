@@ -46,6 +46,8 @@ Evidence::Evidence(XmlReader *pReader)
 
     pSmallSprite = NULL;
     pLargeSprite = NULL;
+
+    stateIndex = 0;
 }
 
 Sprite * Evidence::GetSmallSprite()
@@ -140,24 +142,24 @@ bool EvidenceManager::IsEvidenceWithIdProfile(const string &id)
 
 bool EvidenceManager::IsEvidenceWithIdEnabled(const string &id)
 {
-    return idToItemMap[id]->GetIsEnabled();
+    return GetEvidenceStateFlag(idToItemMap[id], EvidenceStateFlagEnabled);
 }
 
 bool EvidenceManager::IsEvidenceWithIdVisible(const string &id)
 {
-    return idToItemMap[id]->GetIsEnabled() && !idToItemMap[id]->GetIsHidden();
+    return GetEvidenceStateFlag(idToItemMap[id], EvidenceStateFlagEnabled) && !GetEvidenceStateFlag(idToItemMap[id], EvidenceStateFlagHidden);
 }
 
 void EvidenceManager::EnableEvidenceWithId(const string &id)
 {
-    idToItemMap[id]->SetIsEnabled(true);
+    SetEvidenceStateFlag(idToItemMap[id], EvidenceStateFlagEnabled, true);
     evidenceCount++;
     CheckAreEvidenceCombinations();
 }
 
 void EvidenceManager::DisableEvidenceWithId(const string &id)
 {
-    idToItemMap[id]->SetIsHidden(true);
+    SetEvidenceStateFlag(idToItemMap[id], EvidenceStateFlagHidden, true);
     evidenceCount--;
     CheckAreEvidenceCombinations();
 }
@@ -181,30 +183,37 @@ void EvidenceManager::Reset()
 {
     for (map<string, Evidence *>::iterator iter = idToItemMap.begin(); iter != idToItemMap.end(); ++iter)
     {
-        iter->second->SetIsEnabled(evidenceToOriginalEnabledStateMap[iter->second]);
-        iter->second->SetIsHidden(false);
+        SetEvidenceStateFlag(iter->second, EvidenceStateFlagEnabled, iter->second->GetIsInitiallyEnabled());
+        SetEvidenceStateFlag(iter->second, EvidenceStateFlagHidden, false);
     }
 }
 
-void EvidenceManager::CacheState()
+EvidenceManager::Snapshot EvidenceManager::CreateSnapshot() const
 {
-    evidenceToCachedEnabledStateMap.clear();
-    evidenceToCachedHiddenStateMap.clear();
+    Snapshot snapshot;
 
-    for (map<string, Evidence *>::iterator iter = idToItemMap.begin(); iter != idToItemMap.end(); ++iter)
-    {
-        evidenceToCachedEnabledStateMap[iter->second] = iter->second->GetIsEnabled();
-        evidenceToCachedHiddenStateMap[iter->second] = iter->second->GetIsHidden();
-    }
+    snapshot.evidenceStateList = evidenceStateList;
+    snapshot.evidenceCount = evidenceCount;
+
+    return snapshot;
+}
+
+void EvidenceManager::RestoreFromSnapshot(const Snapshot &snapshot)
+{
+    evidenceStateList = snapshot.evidenceStateList;
+    evidenceCount = snapshot.evidenceCount;
+
+    CheckAreEvidenceCombinations();
+}
+
+void EvidenceManager::CacheState()
+{
+    cachedSnapshot = CreateSnapshot();
 }
 
 void EvidenceManager::LoadCachedState()
 {
-    for (map<string, Evidence *>::iterator iter = idToItemMap.begin(); iter != idToItemMap.end(); ++iter)
-    {
-        iter->second->SetIsEnabled(evidenceToCachedEnabledStateMap[iter->second]);
-        iter->second->SetIsHidden(evidenceToCachedHiddenStateMap[iter->second]);
-    }
+    RestoreFromSnapshot(cachedSnapshot);
 }
 
 void EvidenceManager::SaveToSaveFile(XmlWriter *pWriter)
@@ -216,8 +225,8 @@ void EvidenceManager::SaveToSaveFile(XmlWriter *pWriter)
     {
         pWriter->StartElement("Evidence");
         pWriter->WriteTextElement("Id", iter->first);
-        pWriter->WriteBooleanElement("IsEnabled", iter->second->GetIsEnabled());
-        pWriter->WriteBooleanElement("IsHidden", iter->second->GetIsHidden());
+        pWriter->WriteBooleanElement("IsEnabled", GetEvidenceStateFlag(iter->second, EvidenceStateFlagEnabled));
+        pWriter->WriteBooleanElement("IsHidden", GetEvidenceStateFlag(iter->second, EvidenceStateFlagHidden));
         pWriter->EndElement();
     }
 
@@ -238,8 +247,8 @@ void EvidenceManager::LoadFromSaveFile(XmlReader *pReader)
 
         if (idToItemMap.count(id) > 0)
         {
-            idToItemMap[id]->SetIsEnabled(pReader->ReadBooleanElement("IsEnabled"));
-            idToItemMap[id]->SetIsHidden(pReader->ReadBooleanElement("IsHidden"));
+            SetEvidenceStateFlag(idToItemMap[id], EvidenceStateFlagEnabled, pReader->ReadBooleanElement("IsEnabled"));
+            SetEvidenceStateFlag(idToItemMap[id], EvidenceStateFlagHidden, pReader->ReadBooleanElement("IsHidden"));
         }
     }
 
@@ -259,14 +268,24 @@ void EvidenceManager::LoadFromXml(XmlReader *pReader)
     while (pReader->MoveToNextListItem())
     {
         string id = pReader->ReadTextElement("Id");
-        idToItemMap[id] = new Evidence(pReader);
+        Evidence *pEvidence = new Evidence(pReader);
+        unsigned char evidenceState = 0;
 
-        if (idToItemMap[id]->GetIsEnabled())
+        if (pEvidence->GetIsInitiallyEnabled())
         {
+            evidenceState |= EvidenceStateFlagEnabled;
             evidenceCount++;
         }
 
-        evidenceToOriginalEnabledStateMap[idToItemMap[id]] = idToItemMap[id]->GetIsEnabled();
+        if (pEvidence->GetIsInitiallyHidden())
+        {
+            evidenceState |= EvidenceStateFlagHidden;
+        }
+
+        pEvidence->SetStateIndex(evidenceStateList.GetCount());
+        evidenceStateList.Add(evidenceState);
+
+        idToItemMap[id] = pEvidence;
     }
 
     CheckAreEvidenceCombinations();
@@ -305,6 +324,27 @@ void EvidenceManager::LoadFromXml(XmlReader *pReader)
     pReader->EndElement();
 }
 
+bool EvidenceManager::GetEvidenceStateFlag(Evidence *pEvidence, EvidenceStateFlag flag) const
+{
+    return (evidenceStateList.Get(pEvidence->GetStateIndex()) & flag) != 0;
+}
+
+void EvidenceManager::SetEvidenceStateFlag(Evidence *pEvidence, EvidenceStateFlag flag, bool isSet)
+{
+    unsigned char evidenceState = evidenceStateList.Get(pEvidence->GetStateIndex());
+
+    if (isSet)
+    {
+        evidenceState |= flag;
+    }
+    else
+    {
+        evidenceState &= ~flag;
+    }
+
+    evidenceStateList.Set(pEvidence->GetStateIndex(), evidenceState);
+}
+
 void EvidenceManager::CheckAreEvidenceCombinations()
 {
     areEvidenceCombinations = false;
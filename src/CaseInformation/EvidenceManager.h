@@ -30,6 +30,7 @@
 #ifndef EVIDENCEMANAGER_H
 #define EVIDENCEMANAGER_H
 
+#include "../CopyOnWriteVector.h"
 #include "../Sprite.h"
 #include "../CaseContent/Conversation.h"
 #include <map>
@@ -51,6 +52,7 @@ public:
         , isProfile(false)
         , isEnabled(false)
         , isHidden(false)
+        , stateIndex(0)
     {
     }
 
@@ -66,11 +68,13 @@ public:
     bool GetIsProfile() const { return this->isProfile; }
     void SetIsProfile(bool isProfile) { this->isProfile = isProfile; }
 
-    bool GetIsEnabled() const { return this->isEnabled; }
-    void SetIsEnabled(bool isEnabled) { this->isEnabled = isEnabled; }
+    // These are the states the evidence starts the case in -
+    // the current states are tracked by the evidence manager.
+    bool GetIsInitiallyEnabled() const { return this->isEnabled; }
+    bool GetIsInitiallyHidden() const { return this->isHidden; }
 
-    bool GetIsHidden() const { return this->isHidden; }
-    void SetIsHidden(bool isHidden) { this->isHidden = isHidden; }
+    unsigned int GetStateIndex() const { return this->stateIndex; }
+    void SetStateIndex(unsigned int stateIndex) { this->stateIndex = stateIndex; }
 
     bool operator< (const Evidence &other) const;
 
@@ -86,6 +90,8 @@ private:
     bool isProfile;
     bool isEnabled;
     bool isHidden;
+
+    unsigned int stateIndex;
 };
 
 class EvidenceIdPair
@@ -124,6 +130,18 @@ private:
 class EvidenceManager
 {
 public:
+    class Snapshot
+    {
+    public:
+        Snapshot()
+        {
+            evidenceCount = 0;
+        }
+
+        CopyOnWriteVector<unsigned char> evidenceStateList;
+        int evidenceCount;
+    };
+
     EvidenceManager()
     {
         evidenceCount = 0;
@@ -156,6 +174,9 @@ public:
     Encounter * GetEncounterForEvidenceCombination(const string &evidenceId1, const string &evidenceId2);
     void Reset();
 
+    Snapshot CreateSnapshot() const;
+    void RestoreFromSnapshot(const Snapshot &snapshot);
+
     void CacheState();
     void LoadCachedState();
 
@@ -165,6 +186,15 @@ public:
     void LoadFromXml(XmlReader *pReader);
 
 private:
+    enum EvidenceStateFlag
+    {
+        EvidenceStateFlagEnabled = 1 << 0,
+        EvidenceStateFlagHidden = 1 << 1,
+    };
+
+    bool GetEvidenceStateFlag(Evidence *pEvidence, EvidenceStateFlag flag) const;
+    void SetEvidenceStateFlag(Evidence *pEvidence, EvidenceStateFlag flag, bool isSet);
+
     void CheckAreEvidenceCombinations();
 
     map<string, Evidence *> idToItemMap;
@@ -174,10 +204,10 @@ private:
     int evidenceCount;
     bool areEvidenceCombinations;
 
-    map<Evidence *, bool> evidenceToOriginalEnabledStateMap;
-
-    map<Evidence *, bool> evidenceToCachedEnabledStateMap;
-    map<Evidence *, bool> evidenceToCachedHiddenStateMap;
+    // The enabled and hidden states of every piece of evidence,
+    // indexed by each one's state index.
+    CopyOnWriteVector<unsigned char> evidenceStateList;
+    Snapshot cachedSnapshot;
 
     Encounter *pWrongCombinationEncounter;
 };
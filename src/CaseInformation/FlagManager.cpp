@@ -31,47 +31,53 @@
 #include "../XmlReader.h"
 #include "../XmlWriter.h"
 
-bool FlagManager::IsFlagSet(const string &flagName)
+unsigned int FlagManager::GetFlagIndex(const string &flagName)
 {
-    if (namedFlagMap.count(flagName) == 0)
+    map<string, unsigned int>::iterator iter = flagIndexByNameMap.find(flagName);
+
+    if (iter != flagIndexByNameMap.end())
     {
-        namedFlagMap[flagName] = false;
+        return iter->second;
     }
 
-    return namedFlagMap[flagName];
-}
+    unsigned int flagIndex = (unsigned int)flagNameList.size();
 
-void FlagManager::SetFlag(const string &flagName)
-{
-    namedFlagMap[flagName] = true;
-}
+    flagIndexByNameMap[flagName] = flagIndex;
+    flagNameList.push_back(flagName);
+    flagStateList.Add(false);
 
-void FlagManager::ClearFlag(const string &flagName)
-{
-    namedFlagMap[flagName] = false;
+    return flagIndex;
 }
 
 void FlagManager::Reset()
 {
-    namedFlagMap.clear();
+    // We keep the interned indexes around, since conditions and actions
+    // resolved theirs when the case was loaded.
+    flagStateList.Fill(false);
 }
 
-void FlagManager::CacheState()
+void FlagManager::RestoreFromSnapshot(const CopyOnWriteVector<bool> &snapshot)
 {
-    cachedFlagStateMap.clear();
+    CopyOnWriteVector<bool> restoredFlagStateList = snapshot;
 
-    for (map<string, bool>::iterator iter = namedFlagMap.begin(); iter != namedFlagMap.end(); ++iter)
+    // Any flags first seen after the snapshot was taken aren't in the snapshot,
+    // so those keep their current values.
+    for (unsigned int i = snapshot.GetCount(); i < flagStateList.GetCount(); i++)
     {
-        cachedFlagStateMap[iter->first] = iter->second;
+        restoredFlagStateList.Add(flagStateList.Get(i));
     }
+
+    flagStateList = restoredFlagStateList;
+}
+
+void FlagManager::CacheState()
+{
+    cachedFlagStateList = CreateSnapshot();
 }
 
 void FlagManager::LoadCachedState()
 {
-    for (map<string, bool>::iterator iter = cachedFlagStateMap.begin(); iter != cachedFlagStateMap.end(); ++iter)
-    {
-        namedFlagMap[iter->first] = iter->second;
-    }
+    RestoreFromSnapshot(cachedFlagStateList);
 }
 
 void FlagManager::SaveToSaveFile(XmlWriter *pWriter)
@@ -79,11 +85,13 @@ void FlagManager::SaveToSaveFile(XmlWriter *pWriter)
     pWriter->StartElement("FlagManager");
     pWriter->StartElement("FlagList");
 
-    for (map<string, bool>::iterator iter = namedFlagMap.begin(); iter != namedFlagMap.end(); ++iter)
+    // Save files identify flags by name, so they stay valid
+    // regardless of the order in which flags were interned.
+    for (map<string, unsigned int>::iterator iter = flagIndexByNameMap.begin(); iter != flagIndexByNameMap.end(); ++iter)
     {
         pWriter->StartElement("Flag");
         pWriter->WriteTextElement("Id", iter->first);
-        pWriter->WriteBooleanElement("IsSet", iter->second);
+        pWriter->WriteBooleanElement("IsSet", flagStateList.Get(iter->second));
         pWriter->EndElement();
     }
 
@@ -103,7 +111,9 @@ void FlagManager::LoadFromSaveFile(XmlReader *pReader)
     while (pReader->MoveToNextListItem())
     {
         string id = pReader->ReadTextElement("Id");
-        namedFlagMap[id] = pReader->ReadBooleanElement("IsSet");
+        unsigned int flagIndex = GetFlagIndex(id);
+
+        flagStateList.Set(flagIndex, pReader->ReadBooleanElement("IsSet"));
     }
 
     pReader->EndElement();
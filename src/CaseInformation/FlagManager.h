@@ -30,8 +30,11 @@
 #ifndef FLAGMANAGER_H
 #define FLAGMANAGER_H
 
+#include "../CopyOnWriteVector.h"
+
 #include <map>
 #include <string>
+#include <vector>
 
 using namespace std;
 
@@ -41,11 +44,23 @@ class XmlWriter;
 class FlagManager
 {
 public:
-    bool IsFlagSet(const string &flagName);
-    void SetFlag(const string &flagName);
-    void ClearFlag(const string &flagName);
+    unsigned int GetFlagIndex(const string &flagName);
+
+    bool IsFlagSet(const string &flagName) { return IsFlagSet(GetFlagIndex(flagName)); }
+    void SetFlag(const string &flagName) { SetFlag(GetFlagIndex(flagName)); }
+    void ClearFlag(const string &flagName) { ClearFlag(GetFlagIndex(flagName)); }
+
+    bool IsFlagSet(unsigned int flagIndex) const { return flagStateList.Get(flagIndex); }
+    void SetFlag(unsigned int flagIndex) { flagStateList.Set(flagIndex, true); }
+    void ClearFlag(unsigned int flagIndex) { flagStateList.Set(flagIndex, false); }
+
     void Reset();
 
+    // Snapshots share storage with the live flag states until either is modified,
+    // so taking and restoring them is cheap enough to do at every checkpoint.
+    CopyOnWriteVector<bool> CreateSnapshot() const { return this->flagStateList; }
+    void RestoreFromSnapshot(const CopyOnWriteVector<bool> &snapshot);
+
     void CacheState();
     void LoadCachedState();
 
@@ -55,8 +70,15 @@ public:
     void LoadFromXml(XmlReader *pReader);
 
 private:
-    map<string, bool> namedFlagMap;
-    map<string, bool> cachedFlagStateMap;
+    // Flag names are interned to dense indexes the first time they're seen,
+    // so the per-frame checks don't need to do any string comparisons.
+    // Indexes are never released, so anything holding onto one can
+    // keep using it for as long as the case is loaded.
+    map<string, unsigned int> flagIndexByNameMap;
+    vector<string> flagNameList;
+
+    CopyOnWriteVector<bool> flagStateList;
+    CopyOnWriteVector<bool> cachedFlagStateList;
 };
 
 #endif
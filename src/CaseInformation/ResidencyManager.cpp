@@ -0,0 +1,396 @@
+/**
+ * Manager for which sprite sheets and videos are resident for each location;
+ * computes the resources to load and unload on a location change, and prefetches
+ * the resources of adjacent locations while the game is idle.
+ *
+ * @author GabuEx, dawnmew
+ * @since 1.0.7
+ *
+ * Licensed under the MIT License.
+ *
+ * Copyright (c) 2014 Equestrian Dreamers
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ResidencyManager.h"
+#include "Case.h"
+#include "../globals.h"
+#include "../Profiler.h"
+
+#include <algorithm>
+#include <iterator>
+
+const string CommonFilesId = "CommonFiles";
+const unsigned int BytesPerPixel = 4;
+
+void ResidencyManager::AddSpriteSheetParentLocation(const string &spriteSheetId, const string &locationId)
+{
+    spriteSheetTable.idListByLocationIdMap[SymbolTable::Intern(locationId)].push_back(SymbolTable::Intern(spriteSheetId));
+}
+
+void ResidencyManager::AddVideoParentLocation(const string &videoId, const string &locationId)
+{
+    videoTable.idListByLocationIdMap[SymbolTable::Intern(locationId)].push_back(SymbolTable::Intern(videoId));
+}
+
+void ResidencyManager::AddAdjacentLocation(const string &locationId, const string &adjacentLocationId)
+{
+    if (locationId == adjacentLocationId)
+    {
+        return;
+    }
+
+    adjacentLocationIdListByLocationIdMap[SymbolTable::Intern(locationId)].push_back(SymbolTable::Intern(adjacentLocationId));
+}
+
+void ResidencyManager::FinalizeTables()
+{
+    FinalizeTable(&spriteSheetTable.idListByLocationIdMap);
+    FinalizeTable(&videoTable.idListByLocationIdMap);
+
+    for (IdListByIdMap::iterator iter = adjacentLocationIdListByLocationIdMap.begin(); iter != adjacentLocationIdListByLocationIdMap.end(); ++iter)
+    {
+        sort(iter->second.begin(), iter->second.end());
+        iter->second.erase(unique(iter->second.begin(), iter->second.end()), iter->second.end());
+    }
+}
+
+void ResidencyManager::UpdateForLocation(
+    const string &newLocationId,
+    const string &partnerId,
+    vector<IdHandle> *pSpriteSheetIdsToLoad,
+    vector<IdHandle> *pSpriteSheetIdsToDelete,
+    vector<IdHandle> *pVideoIdsToLoad,
+    vector<IdHandle> *pVideoIdsToDelete)
+{
+    IdHandle locationId = SymbolTable::Find(newLocationId);
+    IdHandle partnerHandle = SymbolTable::Find(partnerId);
+
+    UpdateTableForLocation(&spriteSheetTable, locationId, partnerHandle, pSpriteSheetIdsToLoad, pSpriteSheetIdsToDelete);
+    UpdateTableForLocation(&videoTable, locationId, partnerHandle, pVideoIdsToLoad, pVideoIdsToDelete);
+
+    // Now that we know what's resident, evict the least recently used prefetched
+    // resources until we're back under the prefetch budget.
+    Uint64 budget = (Uint64)gPrefetchBudgetMegabytes * 1024 * 1024;
+
+    UpdatePrefetchedByteCounts();
+
+    while (!prefetchedResourceList.empty() && (budget == 0 || prefetchedByteCount > budget))
+    {
+        PrefetchedResourceList::iterator leastRecentlyUsedIter = --prefetchedResourceList.end();
+
+        if (leastRecentlyUsedIter->pTable == &spriteSheetTable)
+        {
+            pSpriteSheetIdsToDelete->push_back(leastRecentlyUsedIter->id);
+        }
+        else
+        {
+            pVideoIdsToDelete->push_back(leastRecentlyUsedIter->id);
+        }
+
+        RemovePrefetchedResource(leastRecentlyUsedIter);
+    }
+
+    spriteSheetTable.pendingPrefetchIdQueue.clear();
+    videoTable.pendingPrefetchIdQueue.clear();
+
+    IdListByIdMap::iterator iter = adjacentLocationIdListByLocationIdMap.find(locationId);
+
+    if (iter != adjacentLocationIdListByLocationIdMap.end())
+    {
+        for (unsigned int i = 0; i < iter->second.size(); i++)
+        {
+            QueuePrefetchesForLocation(&spriteSheetTable, iter->second[i], false /* prioritize */);
+            QueuePrefetchesForLocation(&videoTable, iter->second[i], false /* prioritize */);
+        }
+    }
+
+    UpdateProfilerStatistics();
+}
+
+void ResidencyManager::PrioritizeLocation(const string &locationId)
+{
+    IdHandle locationHandle = SymbolTable::Find(locationId);
+
+    QueuePrefetchesForLocation(&spriteSheetTable, locationHandle, true /* prioritize */);
+    QueuePrefetchesForLocation(&videoTable, locationHandle, true /* prioritize */);
+}
+
+bool ResidencyManager::GetNextPrefetch(vector<IdHandle> *pSpriteSheetIdsToLoad, vector<IdHandle> *pVideoIdsToLoad)
+{
+    // We're only asked for the next prefetch once the loader is idle, so the previous prefetch
+    // has finished loading and its size counts against the budget before we start another.
+    UpdatePrefetchedByteCounts();
+    UpdateProfilerStatistics();
+
+    if (prefetchedByteCount >= (Uint64)gPrefetchBudgetMegabytes * 1024 * 1024)
+    {
+        return false;
+    }
+
+    ResourceTable *pTables[] = { &spriteSheetTable, &videoTable };
+    vector<IdHandle> *pIdsToLoadLists[] = { pSpriteSheetIdsToLoad, pVideoIdsToLoad };
+
+    for (unsigned int i = 0; i < 2; i++)
+    {
+        ResourceTable *pTable = pTables[i];
+
+        while (!pTable->pendingPrefetchIdQueue.empty())
+        {
+            IdHandle id = pTable->pendingPrefetchIdQueue.front();
+            pTable->pendingPrefetchIdQueue.pop_front();
+
+            if (!pTable->IsLoaded(id))
+            {
+                AddPrefetchedResource(pTable, id);
+                pIdsToLoadLists[i]->push_back(id);
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void ResidencyManager::Reset()
+{
+    spriteSheetTable.residentIdList.clear();
+    spriteSheetTable.prefetchedResourceByIdMap.clear();
+    spriteSheetTable.pendingPrefetchIdQueue.clear();
+    videoTable.residentIdList.clear();
+    videoTable.prefetchedResourceByIdMap.clear();
+    videoTable.pendingPrefetchIdQueue.clear();
+
+    prefetchedResourceList.clear();
+    prefetchedByteCount = 0;
+    unsizedPrefetchCount = 0;
+}
+
+bool ResidencyManager::ResourceTable::IsLoaded(IdHandle id)
+{
+    return
+        binary_search(residentIdList.begin(), residentIdList.end(), id) ||
+        prefetchedResourceByIdMap.count(id) > 0;
+}
+
+void ResidencyManager::FinalizeTable(IdListByIdMap *pIdListByIdMap)
+{
+    for (IdListByIdMap::iterator iter = pIdListByIdMap->begin(); iter != pIdListByIdMap->end(); ++iter)
+    {
+        sort(iter->second.begin(), iter->second.end());
+        iter->second.erase(unique(iter->second.begin(), iter->second.end()), iter->second.end());
+    }
+
+    // Common files are resident everywhere, so we fold them into every location's list
+    // up front rather than merging them in on every transition.
+    IdListByIdMap::iterator commonFilesIter = pIdListByIdMap->find(SymbolTable::Intern(CommonFilesId));
+
+    if (commonFilesIter == pIdListByIdMap->end())
+    {
+        return;
+    }
+
+    vector<IdHandle> commonFilesIdList = commonFilesIter->second;
+
+    for (IdListByIdMap::iterator iter = pIdListByIdMap->begin(); iter != pIdListByIdMap->end(); ++iter)
+    {
+        vector<IdHandle> mergedIdList;
+        set_union(iter->second.begin(), iter->second.end(), commonFilesIdList.begin(), commonFilesIdList.end(), back_inserter(mergedIdList));
+        iter->second.swap(mergedIdList);
+    }
+}
+
+void ResidencyManager::UpdateTableForLocation(ResourceTable *pTable, IdHandle locationId, IdHandle partnerId, vector<IdHandle> *pIdsToLoad, vector<IdHandle> *pIdsToDelete)
+{
+    vector<IdHandle> emptyIdList;
+    vector<IdHandle> *pLocationIdList = &emptyIdList;
+    vector<IdHandle> *pPartnerIdList = &emptyIdList;
+
+    IdListByIdMap::iterator iter = pTable->idListByLocationIdMap.find(locationId);
+
+    if (iter == pTable->idListByLocationIdMap.end())
+    {
+        iter = pTable->idListByLocationIdMap.find(SymbolTable::Find(CommonFilesId));
+    }
+
+    if (iter != pTable->idListByLocationIdMap.end())
+    {
+        pLocationIdList = &iter->second;
+    }
+
+    iter = pTable->idListByLocationIdMap.find(partnerId);
+
+    if (iter != pTable->idListByLocationIdMap.end())
+    {
+        pPartnerIdList = &iter->second;
+    }
+
+    vector<IdHandle> newResidentIdList;
+    vector<IdHandle> idsToLoad;
+    vector<IdHandle> idsNoLongerNeeded;
+
+    set_union(pLocationIdList->begin(), pLocationIdList->end(), pPartnerIdList->begin(), pPartnerIdList->end(), back_inserter(newResidentIdList));
+    set_difference(newResidentIdList.begin(), newResidentIdList.end(), pTable->residentIdList.begin(), pTable->residentIdList.end(), back_inserter(idsToLoad));
+    set_difference(pTable->residentIdList.begin(), pTable->residentIdList.end(), newResidentIdList.begin(), newResidentIdList.end(), back_inserter(idsNoLongerNeeded));
+
+    // Anything we already prefetched only needs to move back into the resident list.
+    for (unsigned int i = 0; i < idsToLoad.size(); i++)
+    {
+        unordered_map<IdHandle, PrefetchedResourceList::iterator>::iterator prefetchedIter = pTable->prefetchedResourceByIdMap.find(idsToLoad[i]);
+
+        if (prefetchedIter != pTable->prefetchedResourceByIdMap.end())
+        {
+            RemovePrefetchedResource(prefetchedIter->second);
+            prefetchHitCount++;
+        }
+        else
+        {
+            pIdsToLoad->push_back(idsToLoad[i]);
+            prefetchMissCount++;
+        }
+    }
+
+    // Resources we no longer need stay loaded as the most recently used prefetches,
+    // since the player is likely to head right back to where they came from.
+    for (unsigned int i = 0; i < idsNoLongerNeeded.size(); i++)
+    {
+        AddPrefetchedResource(pTable, idsNoLongerNeeded[i]);
+    }
+
+    pTable->residentIdList.swap(newResidentIdList);
+}
+
+void ResidencyManager::QueuePrefetchesForLocation(ResourceTable *pTable, IdHandle locationId, bool prioritize)
+{
+    IdListByIdMap::iterator iter = pTable->idListByLocationIdMap.find(locationId);
+
+    if (iter == pTable->idListByLocationIdMap.end())
+    {
+        return;
+    }
+
+    for (unsigned int i = 0; i < iter->second.size(); i++)
+    {
+        IdHandle id = iter->second[i];
+
+        if (pTable->IsLoaded(id))
+        {
+            continue;
+        }
+
+        deque<IdHandle>::iterator pendingIter = find(pTable->pendingPrefetchIdQueue.begin(), pTable->pendingPrefetchIdQueue.end(), id);
+
+        if (pendingIter != pTable->pendingPrefetchIdQueue.end())
+        {
+            if (!prioritize)
+            {
+                continue;
+            }
+
+            pTable->pendingPrefetchIdQueue.erase(pendingIter);
+        }
+
+        if (prioritize)
+        {
+            pTable->pendingPrefetchIdQueue.push_front(id);
+        }
+        else
+        {
+            pTable->pendingPrefetchIdQueue.push_back(id);
+        }
+    }
+}
+
+void ResidencyManager::AddPrefetchedResource(ResourceTable *pTable, IdHandle id)
+{
+    prefetchedResourceList.push_front(PrefetchedResource(pTable, id));
+    pTable->prefetchedResourceByIdMap[id] = prefetchedResourceList.begin();
+    unsizedPrefetchCount++;
+}
+
+void ResidencyManager::RemovePrefetchedResource(PrefetchedResourceList::iterator iter)
+{
+    prefetchedByteCount -= iter->byteCount;
+
+    if (!iter->isByteCountKnown)
+    {
+        unsizedPrefetchCount--;
+    }
+
+    iter->pTable->prefetchedResourceByIdMap.erase(iter->id);
+    prefetchedResourceList.erase(iter);
+}
+
+void ResidencyManager::UpdatePrefetchedByteCounts()
+{
+    // We can't know how large a sprite sheet is until it's been loaded,
+    // so we add each resource to the running total as soon as we find out.
+    // A sheet that isn't ready yet takes up no room, so we'll leave it unsized until it is -
+    // if it failed to load, that might be never, but it'll also never take up any room.
+    for (PrefetchedResourceList::iterator iter = prefetchedResourceList.begin(); iter != prefetchedResourceList.end() && unsizedPrefetchCount > 0; ++iter)
+    {
+        if (!iter->isByteCountKnown && GetResourceByteCount(iter->pTable, iter->id, &iter->byteCount))
+        {
+            iter->isByteCountKnown = true;
+            prefetchedByteCount += iter->byteCount;
+            unsizedPrefetchCount--;
+        }
+    }
+}
+
+bool ResidencyManager::GetResourceByteCount(ResourceTable *pTable, IdHandle id, Uint64 *pByteCount)
+{
+    *pByteCount = 0;
+
+    if (pTable == &spriteSheetTable)
+    {
+        Image *pImage = Case::GetInstance()->GetSpriteManager()->GetImageFromId(id);
+
+        if (pImage == NULL)
+        {
+            // If there's no such image, then there's nothing to wait for.
+            return true;
+        }
+
+        if (!pImage->IsReady())
+        {
+            return false;
+        }
+
+        *pByteCount = (Uint64)pImage->width * pImage->height * BytesPerPixel;
+    }
+    else
+    {
+        // Videos' dimensions are known from the case file, so we know their size up front.
+        Video *pVideo = Case::GetInstance()->GetAnimationManager()->GetVideoFromId(id);
+
+        if (pVideo != NULL)
+        {
+            *pByteCount = (Uint64)pVideo->GetWidth() * pVideo->GetHeight() * BytesPerPixel;
+        }
+    }
+
+    return true;
+}
+
+void ResidencyManager::UpdateProfilerStatistics()
+{
+    Profiler::SetPrefetchStatistics(prefetchHitCount, prefetchMissCount, prefetchedByteCount);
+}
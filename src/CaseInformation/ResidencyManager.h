@@ -0,0 +1,142 @@
+/**
+ * Basic header/include file for ResidencyManager.cpp.
+ *
+ * @author GabuEx, dawnmew
+ * @since 1.0.7
+ *
+ * Licensed under the MIT License.
+ *
+ * Copyright (c) 2014 Equestrian Dreamers
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef RESIDENCYMANAGER_H
+#define RESIDENCYMANAGER_H
+
+#include "../SymbolTable.h"
+
+#include <SDL2/SDL.h>
+
+#include <deque>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+class ResidencyManager
+{
+public:
+    ResidencyManager()
+    {
+        prefetchedByteCount = 0;
+        unsizedPrefetchCount = 0;
+        prefetchHitCount = 0;
+        prefetchMissCount = 0;
+    }
+
+    void AddSpriteSheetParentLocation(const string &spriteSheetId, const string &locationId);
+    void AddVideoParentLocation(const string &videoId, const string &locationId);
+    void AddAdjacentLocation(const string &locationId, const string &adjacentLocationId);
+    void FinalizeTables();
+
+    void UpdateForLocation(
+        const string &newLocationId,
+        const string &partnerId,
+        vector<IdHandle> *pSpriteSheetIdsToLoad,
+        vector<IdHandle> *pSpriteSheetIdsToDelete,
+        vector<IdHandle> *pVideoIdsToLoad,
+        vector<IdHandle> *pVideoIdsToDelete);
+
+    void PrioritizeLocation(const string &locationId);
+    bool GetNextPrefetch(vector<IdHandle> *pSpriteSheetIdsToLoad, vector<IdHandle> *pVideoIdsToLoad);
+    void Reset();
+
+    Uint64 GetPrefetchedByteCount() const { return this->prefetchedByteCount; }
+    unsigned int GetPrefetchHitCount() const { return this->prefetchHitCount; }
+    unsigned int GetPrefetchMissCount() const { return this->prefetchMissCount; }
+
+private:
+    typedef unordered_map<IdHandle, vector<IdHandle> > IdListByIdMap;
+
+    class ResourceTable;
+
+    // A resource that is loaded (or being loaded) but not needed by the current location.
+    class PrefetchedResource
+    {
+    public:
+        PrefetchedResource(ResourceTable *pTable, IdHandle id)
+        {
+            this->pTable = pTable;
+            this->id = id;
+            this->byteCount = 0;
+            this->isByteCountKnown = false;
+        }
+
+        ResourceTable *pTable;
+        IdHandle id;
+        Uint64 byteCount;
+        bool isByteCountKnown;
+    };
+
+    typedef list<PrefetchedResource> PrefetchedResourceList;
+
+    class ResourceTable
+    {
+    public:
+        // Maps each location, partner, and the common files ID to the sorted list
+        // of resources that must be resident while it is active.
+        IdListByIdMap idListByLocationIdMap;
+
+        // Sorted list of the resources needed by the current location.
+        vector<IdHandle> residentIdList;
+
+        // Where each of this table's prefetched resources sits in the shared prefetched list.
+        unordered_map<IdHandle, PrefetchedResourceList::iterator> prefetchedResourceByIdMap;
+
+        deque<IdHandle> pendingPrefetchIdQueue;
+
+        bool IsLoaded(IdHandle id);
+    };
+
+    static void FinalizeTable(IdListByIdMap *pIdListByIdMap);
+    void UpdateTableForLocation(ResourceTable *pTable, IdHandle locationId, IdHandle partnerId, vector<IdHandle> *pIdsToLoad, vector<IdHandle> *pIdsToDelete);
+    void QueuePrefetchesForLocation(ResourceTable *pTable, IdHandle locationId, bool prioritize);
+    void AddPrefetchedResource(ResourceTable *pTable, IdHandle id);
+    void RemovePrefetchedResource(PrefetchedResourceList::iterator iter);
+    void UpdatePrefetchedByteCounts();
+    bool GetResourceByteCount(ResourceTable *pTable, IdHandle id, Uint64 *pByteCount);
+    void UpdateProfilerStatistics();
+
+    ResourceTable spriteSheetTable;
+    ResourceTable videoTable;
+    IdListByIdMap adjacentLocationIdListByLocationIdMap;
+
+    // Prefetched sprite sheets and videos together, ordered from most to least recently used,
+    // so that eviction always picks the least recently used resource of either kind.
+    PrefetchedResourceList prefetchedResourceList;
+    Uint64 prefetchedByteCount;
+    unsigned int unsizedPrefetchCount;
+
+    unsigned int prefetchHitCount;
+    unsigned int prefetchMissCount;
+};
+
+#endif
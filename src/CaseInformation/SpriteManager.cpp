@@ -42,7 +42,7 @@ SpriteManager::SpriteManager(ManagerSource managerSource)
 SpriteManager::~SpriteManager()
 {
     SDL_SemWait(pImageByIdSemaphore);
-    for (map<string, Sprite *>::iterator iter = spriteByIdMap.begin(); iter != spriteByIdMap.end(); ++iter)
+    for (unordered_map<IdHandle, Sprite *>::iterator iter = spriteByIdMap.begin(); iter != spriteByIdMap.end(); ++iter)
     {
         delete iter->second;
     }
@@ -59,15 +59,31 @@ Sprite * SpriteManager::GetSpriteFromId(const string &id)
         return NULL;
     }
 
-    return spriteByIdMap[id];
+    return GetSpriteFromId(SymbolTable::Find(id));
+}
+
+Sprite * SpriteManager::GetSpriteFromId(IdHandle id)
+{
+    unordered_map<IdHandle, Sprite *>::iterator iter = spriteByIdMap.find(id);
+    return iter != spriteByIdMap.end() ? iter->second : NULL;
 }
 
 Image * SpriteManager::GetImageFromId(const string &id)
+{
+    return GetImageFromId(SymbolTable::Find(id));
+}
+
+Image * SpriteManager::GetImageFromId(IdHandle id)
 {
     Image *pSprite = NULL;
 
     SDL_SemWait(pImageByIdSemaphore);
-    pSprite = smartSpriteByIdMap[id];
+    unordered_map<IdHandle, Image *>::iterator iter = smartSpriteByIdMap.find(id);
+
+    if (iter != smartSpriteByIdMap.end())
+    {
+        pSprite = iter->second;
+    }
     SDL_SemPost(pImageByIdSemaphore);
 
     return pSprite;
@@ -75,34 +91,43 @@ Image * SpriteManager::GetImageFromId(const string &id)
 
 void SpriteManager::AddSprite(const string &id, const string &spriteSheetId, const RectangleWH &spriteClipRect)
 {
-    spriteByIdMap[id] = new Sprite(spriteSheetId, spriteClipRect);
-    spriteByIdMap[id]->SetManagerSource(managerSource);
+    Sprite *pSprite = new Sprite(spriteSheetId, spriteClipRect);
+    pSprite->SetManagerSource(managerSource);
+
+    spriteByIdMap[SymbolTable::Intern(id)] = pSprite;
+    spriteListBySpriteSheetIdMap[pSprite->GetSpriteSheetImageHandle()].push_back(pSprite);
 }
 
 void SpriteManager::AddImage(const string &id, Image *pSprite)
 {
+    IdHandle idHandle = SymbolTable::Intern(id);
+
     SDL_SemWait(pImageByIdSemaphore);
-    if (smartSpriteByIdMap[id] != NULL)
+    if (smartSpriteByIdMap[idHandle] != NULL)
     {
-        delete smartSpriteByIdMap[id];
+        delete smartSpriteByIdMap[idHandle];
     }
-    smartSpriteByIdMap[id] = pSprite;
+    smartSpriteByIdMap[idHandle] = pSprite;
     SDL_SemPost(pImageByIdSemaphore);
 }
 
 void SpriteManager::LoadImageFromFilePath(const string &id)
 {
-    AddImage(id, ResourceLoader::GetInstance()->LoadImage(smartSpriteFilePathByIdMap[id]));
+    AddImage(id, ResourceLoader::GetInstance()->LoadImage(smartSpriteFilePathByIdMap[SymbolTable::Intern(id)]));
 }
 
 void SpriteManager::DeleteImage(const string &id)
 {
+    IdHandle idHandle = SymbolTable::Find(id);
+
     SDL_SemWait(pImageByIdSemaphore);
-    if (smartSpriteByIdMap[id] != NULL)
+    unordered_map<IdHandle, Image *>::iterator iter = smartSpriteByIdMap.find(idHandle);
+
+    if (iter != smartSpriteByIdMap.end())
     {
-        delete smartSpriteByIdMap[id];
+        delete iter->second;
+        smartSpriteByIdMap.erase(iter);
     }
-    smartSpriteByIdMap.erase(id);
     SDL_SemPost(pImageByIdSemaphore);
 }
 
@@ -115,9 +140,10 @@ void SpriteManager::LoadFromXml(XmlReader *pReader)
 
     while (pReader->MoveToNextListItem())
     {
-        string id = pReader->ReadTextElement("Id");
+        IdHandle id = SymbolTable::Intern(pReader->ReadTextElement("Id"));
         spriteByIdMap[id] = new Sprite(pReader);
         spriteByIdMap[id]->SetManagerSource(managerSource);
+        spriteListBySpriteSheetIdMap[spriteByIdMap[id]->GetSpriteSheetImageHandle()].push_back(spriteByIdMap[id]);
     }
 
     pReader->EndElement();
@@ -127,7 +153,7 @@ void SpriteManager::LoadFromXml(XmlReader *pReader)
 
     while (pReader->MoveToNextListItem())
     {
-        string spriteSheetId = pReader->ReadTextElement("SpriteSheetId");
+        IdHandle spriteSheetId = SymbolTable::Intern(pReader->ReadTextElement("SpriteSheetId"));
         string filePath = pReader->ReadTextElement("FilePath");
 
         smartSpriteFilePathByIdMap[spriteSheetId] = filePath;
@@ -138,39 +164,35 @@ void SpriteManager::LoadFromXml(XmlReader *pReader)
     pReader->EndElement();
 }
 
-void SpriteManager::FinishUpdateLoadedTextures(const string &newLocationId)
+void SpriteManager::FinishUpdateLoadedTextures(const vector<IdHandle> &spriteSheetIdsToLoad, const vector<IdHandle> &spriteSheetIdsToDelete)
 {
-    for (map<string, Sprite *>::iterator iter = spriteByIdMap.begin(); iter != spriteByIdMap.end(); ++iter)
+    for (unsigned int i = 0; i < spriteSheetIdsToLoad.size(); i++)
     {
-        bool loadSprite = false;
-        bool deleteSprite = false;
-        string spriteId = iter->first;
-        Sprite *pSprite = iter->second;
-
-        if (pSprite == NULL)
-        {
-            continue;
-        }
+        ResourceLoader::GetInstance()->AddImageIdToLoadList(SymbolTable::GetString(spriteSheetIdsToLoad[i]));
+    }
 
-        pSprite->UpdateReadiness(newLocationId, &loadSprite, &deleteSprite);
+    for (unsigned int i = 0; i < spriteSheetIdsToDelete.size(); i++)
+    {
+        unordered_map<IdHandle, vector<Sprite *> >::iterator iter = spriteListBySpriteSheetIdMap.find(spriteSheetIdsToDelete[i]);
 
-        if (loadSprite)
+        if (iter != spriteListBySpriteSheetIdMap.end())
         {
-            ResourceLoader::GetInstance()->AddImageIdToLoadList(pSprite->GetSpriteSheetImageId());
-        }
-        else if (deleteSprite)
-        {
-            ResourceLoader::GetInstance()->AddImageIdToDeleteList(pSprite->GetSpriteSheetImageId());
+            for (unsigned int j = 0; j < iter->second.size(); j++)
+            {
+                iter->second[j]->ClearCachedSpriteSheetImage();
+            }
         }
+
+        ResourceLoader::GetInstance()->AddImageIdToDeleteList(SymbolTable::GetString(spriteSheetIdsToDelete[i]));
     }
 }
 
 void SpriteManager::UnloadResources()
 {
     SDL_SemWait(pImageByIdSemaphore);
-    for (map<string, Image *>::iterator iter = smartSpriteByIdMap.begin(); iter != smartSpriteByIdMap.end(); ++iter)
+    for (unordered_map<IdHandle, Image *>::iterator iter = smartSpriteByIdMap.begin(); iter != smartSpriteByIdMap.end(); ++iter)
     {
-        ResourceLoader::GetInstance()->AddImageIdToDeleteList(iter->first);
+        ResourceLoader::GetInstance()->AddImageIdToDeleteList(SymbolTable::GetString(iter->first));
     }
     SDL_SemPost(pImageByIdSemaphore);
 }
@@ -33,7 +33,8 @@
 #include "../enums.h"
 #include "../Image.h"
 #include "../Sprite.h"
-#include <map>
+#include "../SymbolTable.h"
+#include <unordered_map>
 
 class XmlReader;
 
@@ -44,19 +45,22 @@ public:
     ~SpriteManager();
 
     Sprite * GetSpriteFromId(const string &id);
+    Sprite * GetSpriteFromId(IdHandle id);
     Image * GetImageFromId(const string &id);
+    Image * GetImageFromId(IdHandle id);
     void AddSprite(const string &id, const string &spriteSheetId, const RectangleWH &spriteClipRect);
     void AddImage(const string &id, Image *pImage);
     void LoadImageFromFilePath(const string &id);
     void DeleteImage(const string &id);
     void LoadFromXml(XmlReader *pReader);
-    void FinishUpdateLoadedTextures(const string &newLocationId);
+    void FinishUpdateLoadedTextures(const vector<IdHandle> &spriteSheetIdsToLoad, const vector<IdHandle> &spriteSheetIdsToDelete);
     void UnloadResources();
 
 private:
-    map<string, Sprite *> spriteByIdMap;
-    map<string, Image *> smartSpriteByIdMap;
-    map<string, string> smartSpriteFilePathByIdMap;
+    unordered_map<IdHandle, Sprite *> spriteByIdMap;
+    unordered_map<IdHandle, vector<Sprite *> > spriteListBySpriteSheetIdMap;
+    unordered_map<IdHandle, Image *> smartSpriteByIdMap;
+    unordered_map<IdHandle, string> smartSpriteFilePathByIdMap;
 
     ManagerSource managerSource;
     SDL_sem *pImageByIdSemaphore;
@@ -124,6 +124,16 @@ bool HitBox::IsCollision(Vector2 offset, HitBox *pHitBox, Vector2 hitBoxOffset,
 }
 
 RectangleWH HitBox::GetBoundingBox() const
+{
+    return ComputeBoundingBox(false /* includeObjectPositions */);
+}
+
+RectangleWH HitBox::GetCollisionBoundingBox() const
+{
+    return ComputeBoundingBox(true /* includeObjectPositions */);
+}
+
+RectangleWH HitBox::ComputeBoundingBox(bool includeObjectPositions) const
 {
     double left = numeric_limits<double>::infinity();
     double top = numeric_limits<double>::infinity();
@@ -133,10 +143,11 @@ RectangleWH HitBox::GetBoundingBox() const
     for (unsigned int i = 0; i < collidableObjectList.size(); i++)
     {
         vector<Vector2> *pVertices = collidableObjectList[i]->GetVertices();
+        Vector2 objectPosition = includeObjectPositions ? collidableObjectList[i]->GetPosition() : Vector2(0, 0);
 
         for (unsigned int j = 0; j < pVertices->size(); j++)
         {
-            Vector2 vertex = (*pVertices)[j];
+            Vector2 vertex = (*pVertices)[j] + objectPosition;
 
             if (vertex.GetX() < left)
             {
@@ -50,10 +50,16 @@ public:
     bool ContainsPoint(Vector2 offset, Vector2 point) const;
     bool IsCollision(Vector2 offset, HitBox *pHitBox, Vector2 hitBoxOffset, CollisionParameter *pParam) const;
     RectangleWH GetBoundingBox() const;
+
+    // Unlike GetBoundingBox(), this includes the position of each collidable object,
+    // so it bounds everything that IsCollision() tests against, relative to the same offset.
+    RectangleWH GetCollisionBoundingBox() const;
     void Draw(Vector2 topLeftCornerPosition) const;
     HitBox * Clone();
 
 private:
+    RectangleWH ComputeBoundingBox(bool includeObjectPositions) const;
+
     vector<CollidableObject *> collidableObjectList;
     RectangleWH areaBoundsRectangle;
 };
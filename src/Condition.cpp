@@ -114,6 +114,7 @@ Condition::ConditionCriterion * Condition::ConditionCriterion::LoadFromXml(XmlRe
 Condition::FlagSetCondition::FlagSetCondition(const string &flagId)
     : flagId(flagId)
 {
+    flagIndex = Case::GetInstance()->GetFlagManager()->GetFlagIndex(flagId);
 }
 
 Condition::FlagSetCondition::FlagSetCondition(XmlReader *pReader)
@@ -121,6 +122,8 @@ Condition::FlagSetCondition::FlagSetCondition(XmlReader *pReader)
     pReader->StartElement("FlagSetCondition");
     flagId = pReader->ReadTextElement("FlagId");
     pReader->EndElement();
+
+    flagIndex = Case::GetInstance()->GetFlagManager()->GetFlagIndex(flagId);
 }
 
 Condition::FlagSetCondition::~FlagSetCondition()
@@ -129,7 +132,7 @@ Condition::FlagSetCondition::~FlagSetCondition()
 
 bool Condition::FlagSetCondition::IsTrue()
 {
-    return Case::GetInstance()->GetFlagManager()->IsFlagSet(flagId);
+    return Case::GetInstance()->GetFlagManager()->IsFlagSet(flagIndex);
 }
 
 Condition::ConditionCriterion * Condition::FlagSetCondition::Clone()
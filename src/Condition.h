@@ -73,6 +73,7 @@ public:
 
     private:
         string flagId;
+        unsigned int flagIndex;
     };
 
     class EvidencePresentCondition : public ConditionCriterion
@@ -0,0 +1,231 @@
+/**
+ * A vector whose copies share storage until one of them is modified.
+ *
+ * @author GabuEx, dawnmew
+ * @since 1.0.7
+ *
+ * Licensed under the MIT License.
+ *
+ * Copyright (c) 2014 Equestrian Dreamers
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef COPYONWRITEVECTOR_H
+#define COPYONWRITEVECTOR_H
+
+#include <vector>
+
+using namespace std;
+
+// Items are stored in fixed-size pages, and both the pages and the list of pages
+// are shared between copies, so copying one of these is O(1) no matter how many items it holds.
+// Modifying an item only copies the list of pages and the one page holding that item,
+// and only if some other copy is still sharing them.
+// The reference counts aren't atomic, so copies must only be used from one thread.
+template <typename T>
+class CopyOnWriteVector
+{
+public:
+    CopyOnWriteVector()
+    {
+        pRoot = new Root();
+    }
+
+    CopyOnWriteVector(const CopyOnWriteVector<T> &other)
+    {
+        pRoot = other.pRoot;
+        pRoot->referenceCount++;
+    }
+
+    ~CopyOnWriteVector()
+    {
+        ReleaseRoot(pRoot);
+    }
+
+    CopyOnWriteVector<T> & operator=(const CopyOnWriteVector<T> &other)
+    {
+        if (pRoot != other.pRoot)
+        {
+            other.pRoot->referenceCount++;
+            ReleaseRoot(pRoot);
+            pRoot = other.pRoot;
+        }
+
+        return *this;
+    }
+
+    unsigned int GetCount() const { return this->pRoot->count; }
+
+    T Get(unsigned int index) const
+    {
+        return pRoot->pageList[index / PageSize]->itemList[index % PageSize];
+    }
+
+    void Set(unsigned int index, const T &item)
+    {
+        // Writing a value that's already there shouldn't cost us a copy.
+        if (Get(index) == item)
+        {
+            return;
+        }
+
+        GetWritablePage(index / PageSize)->itemList[index % PageSize] = item;
+    }
+
+    void Add(const T &item)
+    {
+        Root *pWritableRoot = GetWritableRoot();
+
+        if (pWritableRoot->count % PageSize == 0)
+        {
+            pWritableRoot->pageList.push_back(new Page());
+        }
+
+        unsigned int index = pWritableRoot->count;
+
+        pWritableRoot->count++;
+        GetWritablePage(index / PageSize)->itemList[index % PageSize] = item;
+    }
+
+    // Sets every item to the given value without changing the count.
+    void Fill(const T &item)
+    {
+        Root *pNewRoot = new Root();
+
+        for (unsigned int i = 0; i < pRoot->count; i++)
+        {
+            if (i % PageSize == 0)
+            {
+                pNewRoot->pageList.push_back(new Page());
+            }
+
+            pNewRoot->pageList.back()->itemList[i % PageSize] = item;
+        }
+
+        pNewRoot->count = pRoot->count;
+
+        ReleaseRoot(pRoot);
+        pRoot = pNewRoot;
+    }
+
+private:
+    static const unsigned int PageSize = 64;
+
+    class Page
+    {
+    public:
+        Page()
+        {
+            referenceCount = 1;
+
+            for (unsigned int i = 0; i < PageSize; i++)
+            {
+                itemList[i] = T();
+            }
+        }
+
+        unsigned int referenceCount;
+        T itemList[PageSize];
+    };
+
+    class Root
+    {
+    public:
+        Root()
+        {
+            referenceCount = 1;
+            count = 0;
+        }
+
+        unsigned int referenceCount;
+        unsigned int count;
+        vector<Page *> pageList;
+    };
+
+    static void ReleaseRoot(Root *pRoot)
+    {
+        pRoot->referenceCount--;
+
+        if (pRoot->referenceCount > 0)
+        {
+            return;
+        }
+
+        for (unsigned int i = 0; i < pRoot->pageList.size(); i++)
+        {
+            Page *pPage = pRoot->pageList[i];
+            pPage->referenceCount--;
+
+            if (pPage->referenceCount == 0)
+            {
+                delete pPage;
+            }
+        }
+
+        delete pRoot;
+    }
+
+    Root * GetWritableRoot()
+    {
+        if (pRoot->referenceCount > 1)
+        {
+            Root *pNewRoot = new Root();
+
+            pNewRoot->count = pRoot->count;
+            pNewRoot->pageList = pRoot->pageList;
+
+            for (unsigned int i = 0; i < pNewRoot->pageList.size(); i++)
+            {
+                pNewRoot->pageList[i]->referenceCount++;
+            }
+
+            ReleaseRoot(pRoot);
+            pRoot = pNewRoot;
+        }
+
+        return pRoot;
+    }
+
+    Page * GetWritablePage(unsigned int pageIndex)
+    {
+        Root *pWritableRoot = GetWritableRoot();
+        Page *pPage = pWritableRoot->pageList[pageIndex];
+
+        if (pPage->referenceCount > 1)
+        {
+            Page *pNewPage = new Page();
+
+            for (unsigned int i = 0; i < PageSize; i++)
+            {
+                pNewPage->itemList[i] = pPage->itemList[i];
+            }
+
+            pPage->referenceCount--;
+            pWritableRoot->pageList[pageIndex] = pNewPage;
+            pPage = pNewPage;
+        }
+
+        return pPage;
+    }
+
+    Root *pRoot;
+};
+
+#endif
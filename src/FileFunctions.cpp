@@ -43,6 +43,7 @@
 #include "ResourceLoader.h"
 #endif
 
+#include <algorithm>
 #include <fstream>
 
 #ifdef __WINDOWS
@@ -585,6 +586,8 @@ void SaveConfigurations()
     configWriter.WriteDoubleElement("SoundEffectsVolume", gSoundEffectsVolume);
     configWriter.WriteDoubleElement("VoiceVolume", gVoiceVolume);
     configWriter.WriteTextElement("LocalizedResourcesFileName", gLocalizedResourcesFileName);
+    configWriter.WriteIntElement("PrefetchBudgetMegabytes", gPrefetchBudgetMegabytes);
+    configWriter.WriteBooleanElement("EnableVsync", gEnableVsync);
 
     KeyboardHelper::WriteConfig(configWriter);
 
@@ -610,6 +613,8 @@ void LoadConfigurations()
             double backgroundMusicVolume = gBackgroundMusicVolume;
             double soundEffectsVolume = gSoundEffectsVolume;
             double voiceVolume = gVoiceVolume;
+            int prefetchBudgetMegabytes = gPrefetchBudgetMegabytes;
+            bool enableVsync = gEnableVsync;
 #endif
             string localizedResourcesFileName = gLocalizedResourcesFileName;
 
@@ -661,6 +666,16 @@ void LoadConfigurations()
                 {
                     voiceVolume = configReader.ReadDoubleElement("VoiceVolume");
                 }
+
+                if (configReader.ElementExists("PrefetchBudgetMegabytes"))
+                {
+                    prefetchBudgetMegabytes = configReader.ReadIntElement("PrefetchBudgetMegabytes");
+                }
+
+                if (configReader.ElementExists("EnableVsync"))
+                {
+                    enableVsync = configReader.ReadBooleanElement("EnableVsync");
+                }
 #endif
 
                 if (configReader.ElementExists("LocalizedResourcesFileName"))
@@ -686,6 +701,8 @@ void LoadConfigurations()
             gBackgroundMusicVolume = backgroundMusicVolume;
             gSoundEffectsVolume = soundEffectsVolume;
             gVoiceVolume = voiceVolume;
+            gPrefetchBudgetMegabytes = prefetchBudgetMegabytes > 0 ? prefetchBudgetMegabytes : 0;
+            gEnableVsync = enableVsync;
 #endif
             gLocalizedResourcesFileName = localizedResourcesFileName;
         }
@@ -853,7 +870,7 @@ vector<string> GetSaveFilePathsForCase(const string &caseUuid)
         {
             string saveFilePath = saveFilePaths[j];
 
-            if (saveFilePath.find(".sav") != string::npos)
+            if (saveFilePath.length() >= 4 && saveFilePath.compare(saveFilePath.length() - 4, 4, ".sav") == 0)
             {
                 filePaths.push_back(saveFilePath);
             }
@@ -861,7 +878,7 @@ vector<string> GetSaveFilePathsForCase(const string &caseUuid)
 #elif __unix
         FOR_EACH_FILE(saveFilePath, GetSaveFolderPathForCase(caseUuid))
         {
-            if (saveFilePath.find(".sav") != string::npos)
+            if (saveFilePath.length() >= 4 && saveFilePath.compare(saveFilePath.length() - 4, 4, ".sav") == 0)
             {
                 filePaths.push_back(saveFilePath);
             }
@@ -878,11 +895,21 @@ bool IsAutosave(const string &saveFilePath)
     return GetUuidFromFilePath(saveFilePath) == "00000000-0000-0000-0000-000000000000";
 }
 
+const unsigned int DialogsSeenLogCompactionThreshold = 256; // entries
+
+vector<string> dialogsSeenPendingList;
+unsigned int dialogsSeenLogEntryCount = 0;
+
 string GetDialogsSeenListFilePathForCase(const string &caseUuid)
 {
     return dialogSeenListsPath + caseUuid + string(".xml");
 }
 
+string GetDialogsSeenLogFilePathForCase(const string &caseUuid)
+{
+    return dialogSeenListsPath + caseUuid + string(".log");
+}
+
 bool DialogsSeenListFileExistsForCase(const string &caseUuid)
 {
     ifstream dialogsSeenListFileStream(GetDialogsSeenListFilePathForCase(caseUuid).c_str());
@@ -890,30 +917,95 @@ bool DialogsSeenListFileExistsForCase(const string &caseUuid)
     return dialogsSeenListFileStream.is_open();
 }
 
+bool IsDialogSeen(const string &dialogId)
+{
+    IdHandle dialogHandle = SymbolTable::Find(dialogId);
+
+    return dialogHandle != InvalidIdHandle && gDialogsSeenSet.count(dialogHandle) > 0;
+}
+
+void MarkDialogSeen(const string &dialogId)
+{
+    if (gDialogsSeenSet.insert(SymbolTable::Intern(dialogId)).second)
+    {
+        dialogsSeenPendingList.push_back(dialogId);
+    }
+}
+
 void SaveDialogsSeenListForCase(const string &caseUuid)
 {
+    if (dialogsSeenPendingList.empty())
+    {
+        return;
+    }
+
+    // Newly seen dialogs are appended to the log file, which is much cheaper than
+    // rewriting the whole list every time.  Once the log gets long enough,
+    // we fold it back into the XML file.
+    if (dialogsSeenLogEntryCount + dialogsSeenPendingList.size() < DialogsSeenLogCompactionThreshold)
+    {
+        ofstream dialogsSeenLogFileStream(GetDialogsSeenLogFilePathForCase(caseUuid).c_str(), ios::out | ios::app);
+
+        if (dialogsSeenLogFileStream.is_open())
+        {
+            for (unsigned int i = 0; i < dialogsSeenPendingList.size(); i++)
+            {
+                dialogsSeenLogFileStream << dialogsSeenPendingList[i] << '\n';
+            }
+
+            dialogsSeenLogFileStream.flush();
+
+            if (dialogsSeenLogFileStream.good())
+            {
+                dialogsSeenLogEntryCount += dialogsSeenPendingList.size();
+                dialogsSeenPendingList.clear();
+                return;
+            }
+        }
+    }
+
+    vector<string> dialogsSeenList;
+
+    for (unordered_set<IdHandle>::iterator iter = gDialogsSeenSet.begin(); iter != gDialogsSeenSet.end(); ++iter)
+    {
+        dialogsSeenList.push_back(SymbolTable::GetString(*iter));
+    }
+
+    sort(dialogsSeenList.begin(), dialogsSeenList.end());
+
     XmlWriter dialogsSeenListWriter(GetDialogsSeenListFilePathForCase(caseUuid).c_str());
 
     dialogsSeenListWriter.StartElement("DialogsSeenList");
 
-    for (unsigned int i = 0; i < gDialogsSeenList.size(); i++)
+    for (unsigned int i = 0; i < dialogsSeenList.size(); i++)
     {
         dialogsSeenListWriter.StartElement("Dialog");
-        dialogsSeenListWriter.WriteTextElement("Id", gDialogsSeenList[i]);
+        dialogsSeenListWriter.WriteTextElement("Id", dialogsSeenList[i]);
         dialogsSeenListWriter.EndElement();
     }
 
     dialogsSeenListWriter.EndElement();
+
+    // If we couldn't write the list, then the log is still the only record of what's pending,
+    // so we'll keep both around and try again the next time we save.
+    if (!dialogsSeenListWriter.WriteToFile())
+    {
+        return;
+    }
+
+    remove(GetDialogsSeenLogFilePathForCase(caseUuid).c_str());
+    dialogsSeenLogEntryCount = 0;
+    dialogsSeenPendingList.clear();
 }
 
 void LoadDialogsSeenListForCase(const string &caseUuid)
 {
+    vector<string> dialogsSeenList;
+
     if (DialogsSeenListFileExistsForCase(caseUuid))
     {
         try
         {
-            vector<string> dialogsSeenList;
-
             XmlReader dialogsSeenListReader(GetDialogsSeenListFilePathForCase(caseUuid).c_str());
 
             if (dialogsSeenListReader.ElementExists("DialogsSeenList"))
@@ -935,19 +1027,42 @@ void LoadDialogsSeenListForCase(const string &caseUuid)
 
                 dialogsSeenListReader.EndElement();
             }
-
-            gDialogsSeenList.clear();
-
-            for (unsigned int i = 0; i < dialogsSeenList.size(); i++)
-            {
-                gDialogsSeenList.push_back(dialogsSeenList[i]);
-            }
         }
         catch (MLIException e)
         {
             // Nothing to do - we just won't load completed cases if we ran into trouble.
+            dialogsSeenList.clear();
+        }
+    }
+
+    dialogsSeenLogEntryCount = 0;
+    dialogsSeenPendingList.clear();
+
+    ifstream dialogsSeenLogFileStream(GetDialogsSeenLogFilePathForCase(caseUuid).c_str());
+    string dialogId;
+
+    while (getline(dialogsSeenLogFileStream, dialogId))
+    {
+        // A partially written final line is only possible if we crashed mid-append,
+        // in which case we'll just see that dialog again.
+        if (dialogId.length() > 0 && !dialogsSeenLogFileStream.eof())
+        {
+            dialogsSeenList.push_back(dialogId);
+            dialogsSeenLogEntryCount++;
         }
     }
+
+    gDialogsSeenSet.clear();
+
+    for (unsigned int i = 0; i < dialogsSeenList.size(); i++)
+    {
+        gDialogsSeenSet.insert(SymbolTable::Intern(dialogsSeenList[i]));
+    }
+}
+
+string GetProfilerTraceFilePath()
+{
+    return userAppDataPath + "ProfilerTrace.json";
 }
 
 bool CheckForExistingInstance()
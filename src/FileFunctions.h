@@ -94,10 +94,15 @@ vector<string> GetSaveFilePathsForCase(const string &caseUuid);
 bool IsAutosave(const string &saveFilePath);
 
 string GetDialogsSeenListFilePathForCase(const string &caseUuid);
+string GetDialogsSeenLogFilePathForCase(const string &caseUuid);
 bool DialogsSeenListFileExistsForCase(const string &caseUuid);
+bool IsDialogSeen(const string &dialogId);
+void MarkDialogSeen(const string &dialogId);
 void SaveDialogsSeenListForCase(const string &caseUuid);
 void LoadDialogsSeenListForCase(const string &caseUuid);
 
+string GetProfilerTraceFilePath();
+
 bool CheckForExistingInstance();
 #endif
 
@@ -44,7 +44,9 @@
 #include "CaseContent/Dialog.h"
 #include "CaseInformation/Case.h"
 #include "CaseInformation/CommonCaseResources.h"
+#include "CaseInformation/DialogCharacterManager.h"
 #include "Events/EventProviders.h"
+#include "Profiler.h"
 #include "Screens/LogoScreen.h"
 #include "Screens/TitleScreen.h"
 #include "Screens/GameScreen.h"
@@ -111,6 +113,13 @@ string sfxIdList[] =
 const unsigned int builtInSfxCount = sizeof(sfxIdList) / sizeof(sfxIdList[0]);
 #endif
 
+#ifdef HEADLESS
+// Headless runs render into this one-pixel surface, which stands in for a null renderer:
+// textures are still created and draw calls still go through the renderer,
+// but everything is clipped away before any pixels are touched.
+SDL_Surface *pHeadlessRenderSurface = NULL;
+#endif
+
 bool Game::CreateAndInit()
 {
     // If an instance already exists, we'll just keep it as is.
@@ -135,6 +144,13 @@ bool Game::CreateAndInit()
     srand((unsigned int)time(NULL));
 #endif
 
+#ifdef HEADLESS
+    // Headless runs never put anything on screen or through the speakers,
+    // so we use SDL's dummy drivers instead of whatever the machine has.
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+#endif
+
     // Turn on ALL THE THINGS.
     if (SDL_Init(SDL_INIT_EVERYTHING) != 0)
     {
@@ -150,6 +166,7 @@ bool Game::CreateAndInit()
     av_register_all();
 
     gUiThreadId = SDL_ThreadID();
+    Profiler::Init();
 #else
     // Initialize networking for the purposes of checking for updates.
     curl_global_init(CURL_GLOBAL_ALL);
@@ -190,7 +207,12 @@ bool Game::CreateAndInit()
     }
 #endif
 
+#ifdef HEADLESS
+    SDL_WindowFlags flags = SDL_WINDOW_HIDDEN;
+    gIsFullscreen = false;
+#else
     SDL_WindowFlags flags = SDL_WINDOW_SHOWN;
+#endif
 
 #ifdef GAME_EXECUTABLE
     if (gIsFullscreen)
@@ -236,7 +258,20 @@ bool Game::CreateAndInit()
 #endif
 #endif
 
-    gpRenderer = SDL_CreateRenderer(gpWindow, -1, 0);
+#ifdef HEADLESS
+    pHeadlessRenderSurface = SDL_CreateRGBSurface(0, 1, 1, 32, 0, 0, 0, 0);
+
+    if (pHeadlessRenderSurface == NULL)
+    {
+        return false;
+    }
+
+    gpRenderer = SDL_CreateSoftwareRenderer(pHeadlessRenderSurface);
+#elif defined(GAME_EXECUTABLE)
+    gpRenderer = SDL_CreateRenderer(gpWindow, -1, gEnableVsync ? SDL_RENDERER_PRESENTVSYNC : 0);
+#else
+    gpRenderer = SDL_CreateRenderer(gpWindow, -1, SDL_RENDERER_PRESENTVSYNC);
+#endif
 
     // Ditto for the renderer.
     if (gpRenderer == NULL)
@@ -255,6 +290,10 @@ bool Game::CreateAndInit()
     gMaxTextureWidth = rendererInfo.max_texture_width;
     gMaxTextureHeight = rendererInfo.max_texture_height;
 
+    // Vsync isn't guaranteed, so we'll need to know whether we actually got it
+    // in order to know whether we need to pace frames ourselves.
+    gIsVsyncEnabled = (rendererInfo.flags & SDL_RENDERER_PRESENTVSYNC) != 0;
+
 #ifdef GAME_EXECUTABLE
     // Initialize audio subsystems.
     initAudio();
@@ -321,6 +360,8 @@ void Game::SetOverlayById(const string &overlayId)
 void Game::Update(int delta)
 {
 #ifdef GAME_EXECUTABLE
+    Profiler::Zone zone("Game::Update");
+
     if (pOverlayScreen != NULL)
     {
         pOverlayScreen->UpdateAudio(delta);
@@ -419,9 +460,15 @@ void Game::Finish()
     // If we have a case open, we want to free all its resources.
     Case::DestroyInstance();
 
+    // Composited portraits are textures, so they need to go before the renderer does
+    // rather than whenever static destructors happen to run.
+    DialogCharacter::ClearPortraitCache();
+
     // Stop playing music/SFX/dialog and shut down the audio thread.
     quitAudio();
 
+    Profiler::Close();
+
     // Unload preloaded music and free memory
     for (unsigned int i = 0; i < builtInBgmCount; i++)
     {
@@ -453,6 +500,14 @@ void Game::Finish()
         gpRenderer = NULL;
     }
 
+#ifdef HEADLESS
+    if (pHeadlessRenderSurface != NULL)
+    {
+        SDL_FreeSurface(pHeadlessRenderSurface);
+        pHeadlessRenderSurface = NULL;
+    }
+#endif
+
     if (gpWindow != NULL)
     {
         SDL_DestroyWindow(gpWindow);
@@ -0,0 +1,529 @@
+/**
+ * Drives the game without a visible window from a scripted input file,
+ * and records per-subsystem timing and allocation statistics for the run.
+ *
+ * @author GabuEx, dawnmew
+ * @since 1.0.7
+ *
+ * Licensed under the MIT License.
+ *
+ * Copyright (c) 2014 Equestrian Dreamers
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "HeadlessRunner.h"
+
+#ifdef HEADLESS
+
+#include "Image.h"
+#include "MouseHelper.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <sstream>
+
+const int DefaultHeadlessFrameDuration = 16; // ms
+const unsigned int FrameTimeHistogramBucketCount = 100; // 1 ms per bucket, last bucket is overflow
+
+deque<HeadlessRunner::ScriptCommand> HeadlessRunner::scriptCommandQueue;
+int HeadlessRunner::frameDuration = DefaultHeadlessFrameDuration;
+unsigned int HeadlessRunner::frameIndex = 0;
+bool HeadlessRunner::isFinished = false;
+
+bool HeadlessRunner::isLeftMouseButtonDown = false;
+int HeadlessRunner::mouseX = -1;
+int HeadlessRunner::mouseY = -1;
+
+Uint64 HeadlessRunner::frameStartTime = 0;
+Uint64 HeadlessRunner::sectionStartTimes[HeadlessSectionCount];
+Uint64 HeadlessRunner::sectionTotalTimes[HeadlessSectionCount];
+vector<unsigned int> HeadlessRunner::frameTimeHistogram;
+
+SDL_atomic_t HeadlessRunner::currentAllocationSection;
+SDL_atomic_t HeadlessRunner::frameAllocationCounts[HeadlessSectionCount + 1];
+Uint64 HeadlessRunner::totalAllocationCounts[HeadlessSectionCount + 1];
+unsigned int HeadlessRunner::maxFrameAllocationCounts[HeadlessSectionCount + 1];
+
+Uint64 HeadlessRunner::totalDrawCallCount = 0;
+unsigned int HeadlessRunner::maxFrameDrawCallCount = 0;
+
+bool HeadlessRunner::isSaveStartedThisFrame = false;
+unsigned int HeadlessRunner::saveFrameCount = 0;
+double HeadlessRunner::totalSaveFrameTimeMs = 0;
+double HeadlessRunner::maxSaveFrameTimeMs = 0;
+
+// We count every allocation made through the global operator new
+// so that the report can show which subsystems are allocation-heavy.
+void * operator new(size_t size)
+{
+    HeadlessRunner::NotifyAllocation();
+
+    void *p = malloc(size > 0 ? size : 1);
+
+    if (p == NULL)
+    {
+        throw std::bad_alloc();
+    }
+
+    return p;
+}
+
+void * operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+// The standard library's nothrow forms aren't guaranteed to go through the operator new above,
+// so we replace them too to make sure that those allocations are counted and come from malloc.
+void * operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    HeadlessRunner::NotifyAllocation();
+    return malloc(size > 0 ? size : 1);
+}
+
+void * operator new[](size_t size, const std::nothrow_t &nothrow) noexcept
+{
+    return operator new(size, nothrow);
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept
+{
+    free(p);
+}
+
+bool HeadlessRunner::CompareScriptCommandFrames(const ScriptCommand &command1, const ScriptCommand &command2)
+{
+    return command1.frame < command2.frame;
+}
+
+bool HeadlessRunner::Init(const string &scriptFilePath)
+{
+    frameTimeHistogram.clear();
+    frameTimeHistogram.resize(FrameTimeHistogramBucketCount, 0);
+
+    for (int i = 0; i < HeadlessSectionCount; i++)
+    {
+        sectionStartTimes[i] = 0;
+        sectionTotalTimes[i] = 0;
+    }
+
+    SDL_AtomicSet(&currentAllocationSection, HeadlessSectionCount);
+
+    for (int i = 0; i <= HeadlessSectionCount; i++)
+    {
+        SDL_AtomicSet(&frameAllocationCounts[i], 0);
+        totalAllocationCounts[i] = 0;
+        maxFrameAllocationCounts[i] = 0;
+    }
+
+    scriptCommandQueue.clear();
+
+    if (scriptFilePath.length() == 0)
+    {
+        return true;
+    }
+
+    ifstream scriptFile(scriptFilePath.c_str());
+
+    if (!scriptFile.is_open())
+    {
+        return false;
+    }
+
+    vector<ScriptCommand> scriptCommandList;
+    string line;
+    unsigned int lineNumber = 0;
+
+    // Each line of the script is of the form "<frame> <command> [<x> <y> | <action>]",
+    // where the command is one of "move", "press", "release", "click", "keydown", "keyup", "key", "quit", or "frameduration".
+    // Keyboard commands take one of the actions "up", "down", "left", "right", "run", or "click".
+    // Blank lines and lines beginning with '#' are ignored.
+    while (getline(scriptFile, line))
+    {
+        lineNumber++;
+
+        if (line.length() == 0 || line[0] == '#')
+        {
+            continue;
+        }
+
+        istringstream lineStream(line);
+        unsigned int frame = 0;
+        string command;
+        int x = -1;
+        int y = -1;
+        KeyboardHelper::HandledAction action = KeyboardHelper::Count;
+
+        if (!(lineStream >> frame >> command))
+        {
+            continue;
+        }
+
+        if (command == "move" || command == "click")
+        {
+            if (!(lineStream >> x >> y))
+            {
+                cout << "Headless script line " << lineNumber << " is missing coordinates." << endl;
+                return false;
+            }
+        }
+        else if (command == "keydown" || command == "keyup" || command == "key")
+        {
+            string actionName;
+
+            if (!(lineStream >> actionName) || !TryParseKeyboardAction(actionName, &action))
+            {
+                cout << "Headless script line " << lineNumber << " is missing a valid keyboard action." << endl;
+                return false;
+            }
+        }
+
+        if (command == "move")
+        {
+            scriptCommandList.push_back(ScriptCommand(frame, ScriptCommandTypeMove, x, y));
+        }
+        else if (command == "press")
+        {
+            scriptCommandList.push_back(ScriptCommand(frame, ScriptCommandTypePress, x, y));
+        }
+        else if (command == "release")
+        {
+            scriptCommandList.push_back(ScriptCommand(frame, ScriptCommandTypeRelease, x, y));
+        }
+        else if (command == "click")
+        {
+            // A click needs the button to be down for at least one update,
+            // so we release it on the following frame.
+            scriptCommandList.push_back(ScriptCommand(frame, ScriptCommandTypeMove, x, y));
+            scriptCommandList.push_back(ScriptCommand(frame, ScriptCommandTypePress, x, y));
+            scriptCommandList.push_back(ScriptCommand(frame + 1, ScriptCommandTypeRelease, x, y));
+        }
+        else if (command == "keydown")
+        {
+            scriptCommandList.push_back(ScriptCommand(frame, ScriptCommandTypeKeyDown, action));
+        }
+        else if (command == "keyup")
+        {
+            scriptCommandList.push_back(ScriptCommand(frame, ScriptCommandTypeKeyUp, action));
+        }
+        else if (command == "key")
+        {
+            // As with clicks, a key press needs the key to be down for at least one update.
+            scriptCommandList.push_back(ScriptCommand(frame, ScriptCommandTypeKeyDown, action));
+            scriptCommandList.push_back(ScriptCommand(frame + 1, ScriptCommandTypeKeyUp, action));
+        }
+        else if (command == "quit")
+        {
+            scriptCommandList.push_back(ScriptCommand(frame, ScriptCommandTypeQuit, x, y));
+        }
+        else if (command == "frameduration")
+        {
+            lineStream >> frameDuration;
+
+            if (frameDuration <= 0)
+            {
+                frameDuration = DefaultHeadlessFrameDuration;
+            }
+        }
+        else
+        {
+            cout << "Unknown headless script command \"" << command << "\" on line " << lineNumber << "." << endl;
+            return false;
+        }
+    }
+
+    stable_sort(scriptCommandList.begin(), scriptCommandList.end(), CompareScriptCommandFrames);
+    scriptCommandQueue.assign(scriptCommandList.begin(), scriptCommandList.end());
+
+    return true;
+}
+
+void HeadlessRunner::BeginFrame()
+{
+    frameStartTime = SDL_GetPerformanceCounter();
+
+    for (int i = 0; i <= HeadlessSectionCount; i++)
+    {
+        SDL_AtomicSet(&frameAllocationCounts[i], 0);
+    }
+
+    ApplyScriptCommands();
+}
+
+void HeadlessRunner::EndFrame()
+{
+    Uint64 frameTime = SDL_GetPerformanceCounter() - frameStartTime;
+    unsigned int frameTimeMs = (unsigned int)(frameTime * 1000 / SDL_GetPerformanceFrequency());
+
+    frameTimeHistogram[min(frameTimeMs, FrameTimeHistogramBucketCount - 1)]++;
+
+    // Saves are meant to cost the game thread no more than a snapshot,
+    // so we keep separate track of the frames that started one.
+    if (isSaveStartedThisFrame)
+    {
+        double saveFrameTimeMs = frameTime * 1000.0 / SDL_GetPerformanceFrequency();
+
+        saveFrameCount++;
+        totalSaveFrameTimeMs += saveFrameTimeMs;
+        maxSaveFrameTimeMs = max(maxSaveFrameTimeMs, saveFrameTimeMs);
+        isSaveStartedThisFrame = false;
+    }
+
+    for (int i = 0; i <= HeadlessSectionCount; i++)
+    {
+        unsigned int allocationCount = (unsigned int)SDL_AtomicGet(&frameAllocationCounts[i]);
+
+        totalAllocationCounts[i] += allocationCount;
+        maxFrameAllocationCounts[i] = max(maxFrameAllocationCounts[i], allocationCount);
+    }
+
+    // The profiler resets its draw call count at the start of each frame,
+    // so this is everything that the frame sent to the renderer.
+    unsigned int drawCallCount = Profiler::GetFrameDrawCallCount();
+
+    totalDrawCallCount += drawCallCount;
+    maxFrameDrawCallCount = max(maxFrameDrawCallCount, drawCallCount);
+
+    frameIndex++;
+}
+
+void HeadlessRunner::BeginSection(HeadlessSection section)
+{
+    sectionStartTimes[section] = SDL_GetPerformanceCounter();
+    SDL_AtomicSet(&currentAllocationSection, section);
+}
+
+void HeadlessRunner::EndSection(HeadlessSection section)
+{
+    sectionTotalTimes[section] += SDL_GetPerformanceCounter() - sectionStartTimes[section];
+    SDL_AtomicSet(&currentAllocationSection, HeadlessSectionCount);
+}
+
+bool HeadlessRunner::GetIsFinished()
+{
+    return isFinished;
+}
+
+void HeadlessRunner::PrintReport()
+{
+    const char *sectionNames[HeadlessSectionCount + 1] =
+    {
+        "Resource loading",
+        "Update",
+        "Draw",
+        "Present",
+        "Other",
+    };
+
+    double frequency = (double)SDL_GetPerformanceFrequency();
+    unsigned int frameCount = max(frameIndex, 1u);
+
+    cout << "Headless run completed after " << frameIndex << " frames." << endl;
+
+    for (int i = 0; i < HeadlessSectionCount; i++)
+    {
+        double totalMs = sectionTotalTimes[i] * 1000.0 / frequency;
+        cout << "    " << sectionNames[i] << ": " << totalMs << " ms total, " << totalMs / frameCount << " ms per frame" << endl;
+    }
+
+    cout << "Allocations:" << endl;
+
+    for (int i = 0; i <= HeadlessSectionCount; i++)
+    {
+        cout << "    " << sectionNames[i] << ": " << totalAllocationCounts[i] << " total, "
+             << (double)totalAllocationCounts[i] / frameCount << " per frame, "
+             << maxFrameAllocationCounts[i] << " max in one frame" << endl;
+    }
+
+    cout << "Draw calls: " << totalDrawCallCount << " total, "
+         << (double)totalDrawCallCount / frameCount << " per frame, "
+         << maxFrameDrawCallCount << " max in one frame" << endl;
+
+    if (saveFrameCount > 0)
+    {
+        cout << "Saves: " << saveFrameCount << " started, "
+             << totalSaveFrameTimeMs / saveFrameCount << " ms average frame, "
+             << maxSaveFrameTimeMs << " ms worst frame" << endl;
+    }
+
+    cout << "Textures: " << Image::GetResidentTextureByteCount() / 1024 << " KB resident at exit, "
+         << Image::GetTextureEvictionCount() << " evictions, "
+         << Image::GetTextureReloadCount() << " reloads" << endl;
+
+    // Walk the histogram to find the percentiles we care about.
+    const double percentiles[] = { 0.50, 0.95, 0.99 };
+    unsigned int percentileIndex = 0;
+    unsigned int cumulativeFrameCount = 0;
+
+    cout << "Frame time histogram (ms: frames):" << endl;
+
+    for (unsigned int i = 0; i < frameTimeHistogram.size(); i++)
+    {
+        if (frameTimeHistogram[i] == 0)
+        {
+            continue;
+        }
+
+        cumulativeFrameCount += frameTimeHistogram[i];
+        cout << "    " << i << (i == frameTimeHistogram.size() - 1 ? "+" : "") << ": " << frameTimeHistogram[i] << endl;
+
+        while (percentileIndex < sizeof(percentiles) / sizeof(percentiles[0]) &&
+               cumulativeFrameCount >= percentiles[percentileIndex] * frameCount)
+        {
+            cout << "    (p" << (int)(percentiles[percentileIndex] * 100) << " = " << i << " ms)" << endl;
+            percentileIndex++;
+        }
+    }
+}
+
+void HeadlessRunner::NotifyAllocation()
+{
+    SDL_AtomicAdd(&frameAllocationCounts[SDL_AtomicGet(&currentAllocationSection)], 1);
+}
+
+void HeadlessRunner::NotifySaveStarted()
+{
+    isSaveStartedThisFrame = true;
+}
+
+bool HeadlessRunner::TryParseKeyboardAction(const string &actionName, KeyboardHelper::HandledAction *pAction)
+{
+    const char *actionNames[KeyboardHelper::Count] =
+    {
+        "up",
+        "down",
+        "left",
+        "right",
+        "run",
+        "click",
+    };
+
+    for (int i = 0; i < KeyboardHelper::Count; i++)
+    {
+        if (actionName == actionNames[i])
+        {
+            *pAction = (KeyboardHelper::HandledAction)i;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void HeadlessRunner::SetKeyboardActionState(KeyboardHelper::HandledAction action, bool isDown)
+{
+    switch (action)
+    {
+        case KeyboardHelper::Up:
+            KeyboardHelper::SetUpState(isDown);
+            break;
+
+        case KeyboardHelper::Down:
+            KeyboardHelper::SetDownState(isDown);
+            break;
+
+        case KeyboardHelper::Left:
+            KeyboardHelper::SetLeftState(isDown);
+            break;
+
+        case KeyboardHelper::Right:
+            KeyboardHelper::SetRightState(isDown);
+            break;
+
+        case KeyboardHelper::Run:
+            KeyboardHelper::SetRunState(isDown);
+            break;
+
+        case KeyboardHelper::Click:
+            KeyboardHelper::SetClickState(isDown);
+            break;
+
+        default:
+            break;
+    }
+}
+
+void HeadlessRunner::ApplyScriptCommands()
+{
+    bool mouseStateChanged = false;
+
+    while (!scriptCommandQueue.empty() && scriptCommandQueue.front().frame <= frameIndex)
+    {
+        ScriptCommand command = scriptCommandQueue.front();
+        scriptCommandQueue.pop_front();
+
+        switch (command.type)
+        {
+            case ScriptCommandTypeMove:
+                mouseX = command.x;
+                mouseY = command.y;
+                mouseStateChanged = true;
+                break;
+
+            case ScriptCommandTypePress:
+                isLeftMouseButtonDown = true;
+                mouseStateChanged = true;
+                break;
+
+            case ScriptCommandTypeRelease:
+                isLeftMouseButtonDown = false;
+                mouseStateChanged = true;
+                break;
+
+            case ScriptCommandTypeKeyDown:
+                SetKeyboardActionState(command.action, true);
+                break;
+
+            case ScriptCommandTypeKeyUp:
+                SetKeyboardActionState(command.action, false);
+                break;
+
+            case ScriptCommandTypeQuit:
+                isFinished = true;
+                break;
+        }
+    }
+
+    if (mouseStateChanged)
+    {
+        MouseHelper::UpdateState(isLeftMouseButtonDown, mouseX, mouseY, true /* drawCursor */);
+    }
+}
+
+#endif
@@ -0,0 +1,147 @@
+/**
+ * Basic header/include file for HeadlessRunner.cpp.
+ *
+ * @author GabuEx, dawnmew
+ * @since 1.0.7
+ *
+ * Licensed under the MIT License.
+ *
+ * Copyright (c) 2014 Equestrian Dreamers
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef HEADLESSRUNNER_H
+#define HEADLESSRUNNER_H
+
+#ifdef HEADLESS
+
+#include <SDL2/SDL.h>
+
+#include "KeyboardHelper.h"
+
+#include <deque>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+enum HeadlessSection
+{
+    HeadlessSectionResourceLoading,
+    HeadlessSectionUpdate,
+    HeadlessSectionDraw,
+    HeadlessSectionPresent,
+    HeadlessSectionCount,
+};
+
+class HeadlessRunner
+{
+public:
+    static bool Init(const string &scriptFilePath);
+    static int GetFrameDuration() { return HeadlessRunner::frameDuration; }
+
+    static void BeginFrame();
+    static void EndFrame();
+    static void BeginSection(HeadlessSection section);
+    static void EndSection(HeadlessSection section);
+
+    static bool GetIsFinished();
+    static void PrintReport();
+
+    static void NotifyAllocation();
+    static void NotifySaveStarted();
+
+private:
+    enum ScriptCommandType
+    {
+        ScriptCommandTypeMove,
+        ScriptCommandTypePress,
+        ScriptCommandTypeRelease,
+        ScriptCommandTypeKeyDown,
+        ScriptCommandTypeKeyUp,
+        ScriptCommandTypeQuit,
+    };
+
+    class ScriptCommand
+    {
+    public:
+        ScriptCommand(unsigned int frame, ScriptCommandType type, int x, int y)
+        {
+            this->frame = frame;
+            this->type = type;
+            this->x = x;
+            this->y = y;
+            this->action = KeyboardHelper::Count;
+        }
+
+        ScriptCommand(unsigned int frame, ScriptCommandType type, KeyboardHelper::HandledAction action)
+        {
+            this->frame = frame;
+            this->type = type;
+            this->x = -1;
+            this->y = -1;
+            this->action = action;
+        }
+
+        unsigned int frame;
+        ScriptCommandType type;
+        int x;
+        int y;
+        KeyboardHelper::HandledAction action;
+    };
+
+    static bool CompareScriptCommandFrames(const ScriptCommand &command1, const ScriptCommand &command2);
+    static bool TryParseKeyboardAction(const string &actionName, KeyboardHelper::HandledAction *pAction);
+    static void SetKeyboardActionState(KeyboardHelper::HandledAction action, bool isDown);
+    static void ApplyScriptCommands();
+
+    static deque<ScriptCommand> scriptCommandQueue;
+    static int frameDuration;
+    static unsigned int frameIndex;
+    static bool isFinished;
+
+    static bool isLeftMouseButtonDown;
+    static int mouseX;
+    static int mouseY;
+
+    static Uint64 frameStartTime;
+    static Uint64 sectionStartTimes[HeadlessSectionCount];
+    static Uint64 sectionTotalTimes[HeadlessSectionCount];
+    static vector<unsigned int> frameTimeHistogram;
+
+    // Allocations are attributed to whichever section the game thread is in when they happen,
+    // with anything made outside of a section (event handling, other threads) counted last.
+    static SDL_atomic_t currentAllocationSection;
+    static SDL_atomic_t frameAllocationCounts[HeadlessSectionCount + 1];
+    static Uint64 totalAllocationCounts[HeadlessSectionCount + 1];
+    static unsigned int maxFrameAllocationCounts[HeadlessSectionCount + 1];
+
+    static Uint64 totalDrawCallCount;
+    static unsigned int maxFrameDrawCallCount;
+
+    static bool isSaveStartedThisFrame;
+    static unsigned int saveFrameCount;
+    static double totalSaveFrameTimeMs;
+    static double maxSaveFrameTimeMs;
+};
+
+#endif
+
+#endif
@@ -32,6 +32,18 @@
 #include "Rectangle.h"
 #include "XmlReader.h"
 #include <math.h>
+#include <limits.h>
+
+#ifdef MLI_DEBUG
+#include <iostream>
+#endif
+
+const short NotInBoundingPolygonHeight = SHRT_MIN;
+
+// Height maps whose bounding boxes are larger than this are left unrasterized,
+// and are instead evaluated directly.  This keeps unusually large ones from taking up
+// a lot of memory, and they still work correctly, just more slowly.
+const int MaxRasterizedHeightMapPixelCount = 1024 * 1024; // pixels
 
 HeightMap * HeightMap::LoadFromXml(XmlReader *pReader)
 {
@@ -45,7 +57,176 @@ HeightMap * HeightMap::LoadFromXml(XmlReader *pReader)
     return pHeightMap;
 }
 
+bool HeightMap::IsPointInBoundingPolygon(Vector2 point)
+{
+    int x = 0;
+    int y = 0;
+
+    if (heightRaster.empty() || !GetRasterCoordinates(point, &x, &y))
+    {
+        return boundingPolygon.Contains(point);
+    }
+
+    // The height raster covers the whole bounding box, so a pixel outside of it is outside the polygon too.
+    if (x < rasterLeft || x >= rasterLeft + rasterWidth || y < rasterTop || y >= rasterTop + rasterHeight)
+    {
+        return false;
+    }
+
+    return heightRaster[(y - rasterTop) * rasterWidth + (x - rasterLeft)] != NotInBoundingPolygonHeight;
+}
+
+int HeightMap::GetHeightAtPoint(Vector2 point)
+{
+    int x = 0;
+    int y = 0;
+
+    if (heightRaster.empty() || !GetRasterCoordinates(point, &x, &y) ||
+        x < rasterLeft || x >= rasterLeft + rasterWidth || y < rasterTop || y >= rasterTop + rasterHeight)
+    {
+        return ComputeHeightAtPoint(point);
+    }
+
+    short height = heightRaster[(y - rasterTop) * rasterWidth + (x - rasterLeft)];
+
+    #ifdef MLI_DEBUG
+        #ifdef MLI_DEBUG_VALIDATE_HEIGHT_MAPS
+            if (height != NotInBoundingPolygonHeight && height != ComputeHeightAtPoint(point))
+            {
+                cout << "Height map raster mismatch at (" << point.GetX() << ", " << point.GetY() << "): " << height << " rasterized, " << ComputeHeightAtPoint(point) << " computed." << endl;
+            }
+        #endif
+    #endif
+
+    // Callers only ask for heights inside the bounding polygon,
+    // so if we're just outside it due to rounding, we'll just compute the height directly.
+    return height != NotInBoundingPolygonHeight ? height : ComputeHeightAtPoint(point);
+}
+
 Vector2 HeightMap::GetBasePointOffsetFromHeightenedPoint(Vector2 point)
+{
+    int x = 0;
+    int y = 0;
+
+    if (heightRaster.empty() || !GetRasterCoordinates(point, &x, &y) ||
+        x < rasterLeft || x >= rasterLeft + rasterWidth || y < baseOffsetRasterTop || y >= baseOffsetRasterTop + baseOffsetRasterHeight)
+    {
+        return ComputeBasePointOffsetFromHeightenedPoint(point);
+    }
+
+    unsigned short baseOffset = baseOffsetRaster[(y - baseOffsetRasterTop) * rasterWidth + (x - rasterLeft)];
+    Vector2 basePointOffset = baseOffset > 0 ? Vector2(0, baseOffset) : Vector2(-1, -1);
+
+    #ifdef MLI_DEBUG
+        #ifdef MLI_DEBUG_VALIDATE_HEIGHT_MAPS
+            Vector2 computedBasePointOffset = ComputeBasePointOffsetFromHeightenedPoint(point);
+
+            if (basePointOffset != computedBasePointOffset)
+            {
+                cout << "Height map base offset raster mismatch at (" << point.GetX() << ", " << point.GetY() << "): "
+                     << basePointOffset.GetY() << " rasterized, " << computedBasePointOffset.GetY() << " computed." << endl;
+            }
+        #endif
+    #endif
+
+    return basePointOffset;
+}
+
+void HeightMap::Rasterize()
+{
+    ClearRasters();
+
+    RectangleWH boundingBox = boundingPolygon.GetBoundingBox();
+    int highestHeight = GetHighestHeight();
+
+    rasterLeft = (int)floor(boundingBox.GetX());
+    rasterTop = (int)floor(boundingBox.GetY());
+    rasterWidth = (int)ceil(boundingBox.GetX() + boundingBox.GetWidth()) - rasterLeft + 1;
+    rasterHeight = (int)ceil(boundingBox.GetY() + boundingBox.GetHeight()) - rasterTop + 1;
+
+    baseOffsetRasterTop = rasterTop - max(highestHeight, 0) - 1;
+    baseOffsetRasterHeight = rasterHeight + (rasterTop - baseOffsetRasterTop);
+
+    if (rasterWidth * baseOffsetRasterHeight > MaxRasterizedHeightMapPixelCount || highestHeight >= SHRT_MAX)
+    {
+        return;
+    }
+
+    heightRaster.resize(rasterWidth * rasterHeight, NotInBoundingPolygonHeight);
+    baseOffsetRaster.resize(rasterWidth * baseOffsetRasterHeight, 0);
+
+    for (int y = 0; y < rasterHeight; y++)
+    {
+        for (int x = 0; x < rasterWidth; x++)
+        {
+            Vector2 point(rasterLeft + x, rasterTop + y);
+
+            if (boundingPolygon.Contains(point))
+            {
+                heightRaster[y * rasterWidth + x] = (short)ComputeHeightAtPoint(point);
+            }
+        }
+    }
+
+    // Rather than search downwards from each heightened point as the direct computation does,
+    // we'll go the other way: we raise each base point by its height, and then record it
+    // as the base point for each heightened point that the direct computation would accept.
+    // Going from the top down means that the first base point we record for each heightened point
+    // is the nearest one, which is the one that the direct computation would find first.
+    double boundingBoxBottom = boundingBox.GetY() + boundingBox.GetHeight();
+
+    for (int x = 0; x < rasterWidth; x++)
+    {
+        for (int y = 0; y < rasterHeight && rasterTop + y <= boundingBoxBottom; y++)
+        {
+            short height = heightRaster[y * rasterWidth + x];
+
+            if (height == NotInBoundingPolygonHeight)
+            {
+                continue;
+            }
+
+            int basePointY = rasterTop + y;
+            int heightenedPointY = basePointY - height;
+
+            for (int heightenedY = heightenedPointY - 1; heightenedY <= heightenedPointY + 1; heightenedY++)
+            {
+                int baseOffset = basePointY - heightenedY;
+
+                if (baseOffset < 1 || baseOffset > highestHeight ||
+                    heightenedY < baseOffsetRasterTop || heightenedY >= baseOffsetRasterTop + baseOffsetRasterHeight)
+                {
+                    continue;
+                }
+
+                unsigned short *pBaseOffset = &baseOffsetRaster[(heightenedY - baseOffsetRasterTop) * rasterWidth + x];
+
+                if (*pBaseOffset == 0)
+                {
+                    *pBaseOffset = (unsigned short)baseOffset;
+                }
+            }
+        }
+    }
+}
+
+bool HeightMap::GetRasterCoordinates(Vector2 point, int *pX, int *pY)
+{
+    // The rasters only hold values at whole pixels, and neither the height nor the base offset
+    // can be interpolated between them exactly, so points in between are left to the direct computation.
+    *pX = (int)floor(point.GetX());
+    *pY = (int)floor(point.GetY());
+
+    return *pX == point.GetX() && *pY == point.GetY();
+}
+
+void HeightMap::ClearRasters()
+{
+    heightRaster.clear();
+    baseOffsetRaster.clear();
+}
+
+Vector2 HeightMap::ComputeBasePointOffsetFromHeightenedPoint(Vector2 point)
 {
     // Since the function assigning heightened points to base points can sometimes
     // assign the same heightened point to two or more base points, it's
@@ -77,7 +258,7 @@ Vector2 HeightMap::GetBasePointOffsetFromHeightenedPoint(Vector2 point)
         {
             break;
         }
-        else if (fabs(point.GetY() - GetHeightAtPoint(point) - originalPoint.GetY()) <= 1 && IsPointInBoundingPolygon(point))
+        else if (fabs(point.GetY() - ComputeHeightAtPoint(point) - originalPoint.GetY()) <= 1 && boundingPolygon.Contains(point))
         {
             basePointOffset = point - originalPoint;
             break;
@@ -117,9 +298,11 @@ ParabolicHeightMap::ParabolicHeightMap(XmlReader *pReader)
     pReader->EndElement();
 
     pReader->EndElement();
+
+    Rasterize();
 }
 
-int ParabolicHeightMap::GetHeightAtPoint(Vector2 point)
+int ParabolicHeightMap::ComputeHeightAtPoint(Vector2 point)
 {
     Line characterDirectionLine(point, directionVector);
 
@@ -33,27 +33,66 @@
 #include "Line.h"
 #include "Polygon.h"
 
+#include <vector>
+
+using namespace std;
+
 class XmlReader;
 
 class HeightMap
 {
 public:
+    HeightMap()
+    {
+        rasterLeft = 0;
+        rasterTop = 0;
+        rasterWidth = 0;
+        rasterHeight = 0;
+        baseOffsetRasterTop = 0;
+        baseOffsetRasterHeight = 0;
+    }
+
     virtual ~HeightMap() {}
 
-    bool IsPointInBoundingPolygon(Vector2 point) { return this->boundingPolygon.Contains(point); }
-    void SetDirectionVector(Vector2 directionVector) { this->directionVector = directionVector.Normalize(); }
-    void SetBoundingPolygon(GeometricPolygon boundingPolygon) { this->boundingPolygon = boundingPolygon; }
+    void SetDirectionVector(Vector2 directionVector) { this->directionVector = directionVector.Normalize(); ClearRasters(); }
+    void SetBoundingPolygon(GeometricPolygon boundingPolygon) { this->boundingPolygon = boundingPolygon; ClearRasters(); }
 
-    virtual int GetHeightAtPoint(Vector2 point) = 0;
+    // These are read from rasters for points that are exactly on a pixel, and are otherwise
+    // computed directly, which is much slower.  Callers that are fine with the rounding error
+    // should round to the nearest pixel first.
+    bool IsPointInBoundingPolygon(Vector2 point);
+    int GetHeightAtPoint(Vector2 point);
     Vector2 GetBasePointOffsetFromHeightenedPoint(Vector2 point);
     static HeightMap * LoadFromXml(XmlReader *pReader);
 
 protected:
+    virtual int ComputeHeightAtPoint(Vector2 point) = 0;
     virtual int GetHighestHeight() = 0;
     void LoadFromXmlCore(XmlReader *pReader);
+    void Rasterize();
 
     Vector2 directionVector;
     GeometricPolygon boundingPolygon;
+
+private:
+    Vector2 ComputeBasePointOffsetFromHeightenedPoint(Vector2 point);
+    bool GetRasterCoordinates(Vector2 point, int *pX, int *pY);
+    void ClearRasters();
+
+    // The height at every pixel within the bounding box of this height map,
+    // or NotInBoundingPolygonHeight for pixels outside of the bounding polygon.
+    int rasterLeft;
+    int rasterTop;
+    int rasterWidth;
+    int rasterHeight;
+    vector<short> heightRaster;
+
+    // The offset from every pixel that a point could be raised to by this height map
+    // back down to the base point it was raised from, or 0 if no point is raised to it.
+    // This extends above the height raster by the highest height in the height map.
+    int baseOffsetRasterTop;
+    int baseOffsetRasterHeight;
+    vector<unsigned short> baseOffsetRaster;
 };
 
 class ParabolicHeightMap : public HeightMap
@@ -61,9 +100,8 @@ class ParabolicHeightMap : public HeightMap
 public:
     ParabolicHeightMap(XmlReader *pReader);
 
-    virtual int GetHeightAtPoint(Vector2 point);
-
 protected:
+    virtual int ComputeHeightAtPoint(Vector2 point);
     virtual int GetHighestHeight();
 
     class HeightLine : public Line
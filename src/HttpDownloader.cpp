@@ -0,0 +1,379 @@
+/**
+ * Downloads a set of files over HTTP several at a time, streaming each one
+ * to disk and checking its signature as it arrives.  Interrupted downloads
+ * are resumed from where they left off rather than started over.
+ *
+ * @author GabuEx, dawnmew
+ * @since 1.0.7
+ *
+ * Licensed under the MIT License.
+ *
+ * Copyright (c) 2014 Equestrian Dreamers
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef UPDATER
+
+#include "HttpDownloader.h"
+
+#include <algorithm>
+
+const int MaxConcurrentDownloads = 4;
+const unsigned int MaxDownloadAttempts = 3;
+const int MultiWaitTimeout = 100; // ms
+const long ConnectTimeout = 2; // seconds
+const long LowSpeedLimit = 1; // bytes per second
+const long LowSpeedTime = 30; // seconds
+const long HttpPartialContent = 206;
+const long HttpRangeNotSatisfiable = 416;
+const size_t PartialFileReadBufferSize = 65536; // bytes
+
+HttpDownloader::HttpDownloader()
+{
+    pfnProgressCallback = NULL;
+    pProgressCallbackData = NULL;
+    isCanceled = false;
+}
+
+HttpDownloader::~HttpDownloader()
+{
+    for (unsigned int i = 0; i < downloadList.size(); i++)
+    {
+        delete downloadList[i];
+    }
+
+    downloadList.clear();
+    pendingDownloadQueue.clear();
+}
+
+void HttpDownloader::AddDownload(const string &uri, const string &filePath, const string &hexEncodedSignature)
+{
+    Download *pDownload = new Download(this, uri, filePath, hexEncodedSignature);
+
+    downloadList.push_back(pDownload);
+    pendingDownloadQueue.push_back(pDownload);
+}
+
+bool HttpDownloader::Run(PFNPROGRESSCALLBACK pfnProgressCallback, void *pProgressCallbackData)
+{
+    this->pfnProgressCallback = pfnProgressCallback;
+    this->pProgressCallbackData = pProgressCallbackData;
+    isCanceled = false;
+    failedFilePath = "";
+
+    CURLM *pMultiHandle = curl_multi_init();
+
+    if (pMultiHandle == NULL)
+    {
+        return false;
+    }
+
+    vector<Download *> activeDownloadList;
+    bool failed = false;
+
+    while (!failed && !isCanceled && (!pendingDownloadQueue.empty() || !activeDownloadList.empty()))
+    {
+        while ((int)activeDownloadList.size() < MaxConcurrentDownloads && !pendingDownloadQueue.empty())
+        {
+            Download *pDownload = pendingDownloadQueue.front();
+            pendingDownloadQueue.pop_front();
+
+            if (!pDownload->Begin())
+            {
+                failedFilePath = pDownload->GetFilePath();
+                failed = true;
+                break;
+            }
+
+            curl_multi_add_handle(pMultiHandle, pDownload->GetCurlHandle());
+            activeDownloadList.push_back(pDownload);
+        }
+
+        if (failed)
+        {
+            break;
+        }
+
+        int runningHandleCount = 0;
+        curl_multi_perform(pMultiHandle, &runningHandleCount);
+
+        int messageCount = 0;
+        CURLMsg *pMessage = NULL;
+
+        while ((pMessage = curl_multi_info_read(pMultiHandle, &messageCount)) != NULL)
+        {
+            if (pMessage->msg != CURLMSG_DONE)
+            {
+                continue;
+            }
+
+            Download *pDownload = NULL;
+            curl_easy_getinfo(pMessage->easy_handle, CURLINFO_PRIVATE, &pDownload);
+            curl_multi_remove_handle(pMultiHandle, pMessage->easy_handle);
+
+            activeDownloadList.erase(find(activeDownloadList.begin(), activeDownloadList.end(), pDownload));
+
+            DownloadResult result = pDownload->End(pMessage->data.result);
+
+            if (result == DownloadResultRetry)
+            {
+                pendingDownloadQueue.push_back(pDownload);
+            }
+            else if (result == DownloadResultFailed && !failed)
+            {
+                failedFilePath = pDownload->GetFilePath();
+                failed = true;
+            }
+        }
+
+        if (!failed && !isCanceled && !activeDownloadList.empty())
+        {
+            curl_multi_wait(pMultiHandle, NULL, 0, MultiWaitTimeout, NULL);
+        }
+    }
+
+    // Anything still in flight at this point was either canceled or cut short by another failure.
+    // We leave their partial files behind so that the next attempt can pick up where they left off.
+    for (unsigned int i = 0; i < activeDownloadList.size(); i++)
+    {
+        curl_multi_remove_handle(pMultiHandle, activeDownloadList[i]->GetCurlHandle());
+        activeDownloadList[i]->Abort();
+    }
+
+    curl_multi_cleanup(pMultiHandle);
+
+    return !failed && !isCanceled;
+}
+
+size_t HttpDownloader::WriteDataStatic(void *buffer, size_t size, size_t nmemb, void *userp)
+{
+    Download *pDownload = reinterpret_cast<Download *>(userp);
+    return pDownload->Write(reinterpret_cast<const byte *>(buffer), size * nmemb);
+}
+
+HttpDownloader::Download::Download(HttpDownloader *pOwner, const string &uri, const string &filePath, const string &hexEncodedSignature)
+{
+    this->pOwner = pOwner;
+    this->uri = uri;
+    this->filePath = filePath;
+    this->hexEncodedSignature = hexEncodedSignature;
+
+    pCurlHandle = NULL;
+    pFile = NULL;
+
+    resumeOffset = 0;
+    bytesWritten = 0;
+    bytesReported = 0;
+    hasCheckedResponseCode = false;
+    attemptCount = 0;
+}
+
+HttpDownloader::Download::~Download()
+{
+    Abort();
+}
+
+bool HttpDownloader::Download::Begin()
+{
+    attemptCount++;
+
+    if (!ResumeFromPartialFile())
+    {
+        return false;
+    }
+
+    pCurlHandle = curl_easy_init();
+
+    if (pCurlHandle == NULL)
+    {
+        Abort();
+        return false;
+    }
+
+    curl_easy_setopt(pCurlHandle, CURLOPT_URL, uri.c_str());
+    curl_easy_setopt(pCurlHandle, CURLOPT_WRITEFUNCTION, HttpDownloader::WriteDataStatic);
+    curl_easy_setopt(pCurlHandle, CURLOPT_WRITEDATA, this);
+    curl_easy_setopt(pCurlHandle, CURLOPT_PRIVATE, this);
+    curl_easy_setopt(pCurlHandle, CURLOPT_FOLLOWLOCATION, 1L);
+
+    // We don't want error pages ending up in our files.
+    curl_easy_setopt(pCurlHandle, CURLOPT_FAILONERROR, 1L);
+
+    // We'll only wait for two seconds to connect, same as with every other request we make,
+    // but once connected we'll let a slow transfer continue so long as it's still making progress.
+    curl_easy_setopt(pCurlHandle, CURLOPT_CONNECTTIMEOUT, ConnectTimeout);
+    curl_easy_setopt(pCurlHandle, CURLOPT_LOW_SPEED_LIMIT, LowSpeedLimit);
+    curl_easy_setopt(pCurlHandle, CURLOPT_LOW_SPEED_TIME, LowSpeedTime);
+
+    if (resumeOffset > 0)
+    {
+        curl_easy_setopt(pCurlHandle, CURLOPT_RESUME_FROM_LARGE, resumeOffset);
+    }
+
+    hasCheckedResponseCode = false;
+    return true;
+}
+
+size_t HttpDownloader::Download::Write(const byte *pData, size_t dataSize)
+{
+    if (!hasCheckedResponseCode)
+    {
+        long responseCode = 0;
+        curl_easy_getinfo(pCurlHandle, CURLINFO_RESPONSE_CODE, &responseCode);
+        hasCheckedResponseCode = true;
+
+        // If we asked for a range and the server sent us the whole file instead,
+        // then we need to throw away what we had and start from the beginning.
+        if (resumeOffset > 0 && responseCode != HttpPartialContent)
+        {
+            pFile = freopen(GetPartialFilePath().c_str(), "wb", pFile);
+
+            if (pFile == NULL)
+            {
+                return 0;
+            }
+
+            verifier.Restart();
+            resumeOffset = 0;
+            bytesWritten = 0;
+        }
+    }
+
+    if (fwrite(pData, 1, dataSize, pFile) != dataSize)
+    {
+        return 0;
+    }
+
+    verifier.Update(pData, dataSize);
+    bytesWritten += dataSize;
+
+    if (!ReportProgress(bytesWritten))
+    {
+        pOwner->isCanceled = true;
+        return 0;
+    }
+
+    return dataSize;
+}
+
+HttpDownloader::DownloadResult HttpDownloader::Download::End(CURLcode result)
+{
+    long responseCode = 0;
+    curl_easy_getinfo(pCurlHandle, CURLINFO_RESPONSE_CODE, &responseCode);
+
+    Abort();
+
+    if (pOwner->isCanceled)
+    {
+        return DownloadResultFailed;
+    }
+
+    // If the server tells us that the range we asked for doesn't exist,
+    // that means that we already have the whole file, so we can go straight to verifying it.
+    if (result != CURLE_OK && !(resumeOffset > 0 && responseCode == HttpRangeNotSatisfiable))
+    {
+        return attemptCount < MaxDownloadAttempts ? DownloadResultRetry : DownloadResultFailed;
+    }
+
+    if (!verifier.Verify(hexEncodedSignature))
+    {
+        // Something's wrong with what we've got, so we'll throw it away
+        // and start over from the beginning if we have any attempts left.
+        remove(GetPartialFilePath().c_str());
+        ReportProgress(0);
+
+        return attemptCount < MaxDownloadAttempts ? DownloadResultRetry : DownloadResultFailed;
+    }
+
+    remove(filePath.c_str());
+
+    if (rename(GetPartialFilePath().c_str(), filePath.c_str()) != 0)
+    {
+        return DownloadResultFailed;
+    }
+
+    return DownloadResultSucceeded;
+}
+
+void HttpDownloader::Download::Abort()
+{
+    if (pFile != NULL)
+    {
+        fclose(pFile);
+        pFile = NULL;
+    }
+
+    if (pCurlHandle != NULL)
+    {
+        curl_easy_cleanup(pCurlHandle);
+        pCurlHandle = NULL;
+    }
+}
+
+bool HttpDownloader::Download::ResumeFromPartialFile()
+{
+    verifier.Restart();
+    resumeOffset = 0;
+
+    // If a previous attempt left a partial file behind, then we'll run what it contains
+    // through the verifier and ask the server only for the rest.
+    FILE *pPartialFile = fopen(GetPartialFilePath().c_str(), "rb");
+
+    if (pPartialFile != NULL)
+    {
+        vector<byte> buffer(PartialFileReadBufferSize);
+        size_t bytesRead = 0;
+
+        while ((bytesRead = fread(&buffer[0], 1, buffer.size(), pPartialFile)) > 0)
+        {
+            verifier.Update(&buffer[0], bytesRead);
+            resumeOffset += bytesRead;
+        }
+
+        fclose(pPartialFile);
+    }
+
+    bytesWritten = resumeOffset;
+
+    if (!ReportProgress(bytesWritten))
+    {
+        pOwner->isCanceled = true;
+    }
+
+    pFile = fopen(GetPartialFilePath().c_str(), "ab");
+    return pFile != NULL;
+}
+
+bool HttpDownloader::Download::ReportProgress(double bytesDownloaded)
+{
+    // We report only the change since we last reported, so that the progress of every download
+    // can be added together - this can be negative if we've had to throw away what we had.
+    double newBytesDownloaded = bytesDownloaded - bytesReported;
+    bytesReported = bytesDownloaded;
+
+    if (newBytesDownloaded == 0 || pOwner->pfnProgressCallback == NULL)
+    {
+        return true;
+    }
+
+    return pOwner->pfnProgressCallback(pOwner->pProgressCallbackData, bytesDownloaded, newBytesDownloaded, 0, 0) == 0;
+}
+
+#endif
@@ -0,0 +1,117 @@
+/**
+ * Basic header/include file for HttpDownloader.cpp.
+ *
+ * @author GabuEx, dawnmew
+ * @since 1.0.7
+ *
+ * Licensed under the MIT License.
+ *
+ * Copyright (c) 2014 Equestrian Dreamers
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef HTTPDOWNLOADER_H
+#define HTTPDOWNLOADER_H
+
+#ifdef UPDATER
+
+#include "Utils.h"
+
+extern "C"
+{
+    #include <curl/curl.h>
+}
+
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class HttpDownloader
+{
+public:
+    HttpDownloader();
+    ~HttpDownloader();
+
+    void AddDownload(const string &uri, const string &filePath, const string &hexEncodedSignature);
+    bool Run(PFNPROGRESSCALLBACK pfnProgressCallback, void *pProgressCallbackData);
+
+    string GetFailedFilePath() { return failedFilePath; }
+
+private:
+    enum DownloadResult
+    {
+        DownloadResultSucceeded,
+        DownloadResultRetry,
+        DownloadResultFailed,
+    };
+
+    class Download
+    {
+    public:
+        Download(HttpDownloader *pOwner, const string &uri, const string &filePath, const string &hexEncodedSignature);
+        ~Download();
+
+        bool Begin();
+        size_t Write(const byte *pData, size_t dataSize);
+        DownloadResult End(CURLcode result);
+        void Abort();
+
+        CURL * GetCurlHandle() { return pCurlHandle; }
+        string GetFilePath() { return filePath; }
+
+    private:
+        string GetPartialFilePath() { return filePath + ".part"; }
+        bool ResumeFromPartialFile();
+        bool ReportProgress(double bytesDownloaded);
+
+        HttpDownloader *pOwner;
+
+        string uri;
+        string filePath;
+        string hexEncodedSignature;
+
+        CURL *pCurlHandle;
+        FILE *pFile;
+        StreamingSignatureVerifier verifier;
+
+        curl_off_t resumeOffset;
+        curl_off_t bytesWritten;
+        double bytesReported;
+        bool hasCheckedResponseCode;
+        unsigned int attemptCount;
+    };
+
+    static size_t WriteDataStatic(void *buffer, size_t size, size_t nmemb, void *userp);
+
+    vector<Download *> downloadList;
+    deque<Download *> pendingDownloadQueue;
+
+    PFNPROGRESSCALLBACK pfnProgressCallback;
+    void *pProgressCallbackData;
+    bool isCanceled;
+    string failedFilePath;
+};
+
+#endif
+
+#endif
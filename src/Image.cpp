@@ -32,6 +32,7 @@
 #include "globals.h"
 
 #ifdef GAME_EXECUTABLE
+#include "Profiler.h"
 #include "ResourceLoader.h"
 #endif
 
@@ -41,10 +42,28 @@
 using namespace std;
 
 vector<Image *> Image::activeSpriteList;
-vector<Image *> Image::newSpriteList;
-vector<Image *> Image::deletedSpriteList;
 SDL_sem *Image::pSpriteListSemaphore = SDL_CreateSemaphore(1);
-bool Image::isReloadingSprites = false;
+bool Image::isDrawingToTexture = false;
+
+SDL_Texture *Image::pBatchTexture = NULL;
+int Image::batchTextureWidth = 0;
+int Image::batchTextureHeight = 0;
+vector<Image::BatchedQuad> Image::batchedQuadList;
+vector<SDL_Vertex> Image::batchVertexList;
+vector<int> Image::batchIndexList;
+unsigned int Image::batchDepth = 0;
+bool Image::isGeometrySupported = true;
+
+Uint32 Image::currentFrame = 0;
+Uint64 Image::residentTextureByteCount = 0;
+SDL_SpinLock Image::residentTextureByteCountLock = 0;
+Uint64 Image::textureBudgetByteCount = (Uint64)384 * 1024 * 1024; // bytes
+unsigned int Image::textureEvictionCount = 0;
+unsigned int Image::textureReloadCount = 0;
+
+const unsigned int MaxBatchedQuadCount = 1024;
+const int TextureBytesPerPixel = 4;
+const Uint32 MinFramesUndrawnBeforeEviction = 120; // frames
 
 Image::Image(void)
 {
@@ -58,34 +77,24 @@ Image::Image(void)
     textureCountX = 0;
     textureCountY = 0;
 
+    textureByteCount = 0;
+    lastDrawnFrame = currentFrame;
+    needsReload = false;
+
     width = 0;
     height = 0;
     pSource = NULL;
 
-    if (!isReloadingSprites)
-    {
-        SDL_SemWait(pSpriteListSemaphore);
-        activeSpriteList.push_back(this);
-        SDL_SemPost(pSpriteListSemaphore);
-    }
-    else
-    {
-        newSpriteList.push_back(this);
-    }
+    SDL_SemWait(pSpriteListSemaphore);
+    activeSpriteList.push_back(this);
+    SDL_SemPost(pSpriteListSemaphore);
 }
 
 Image::~Image()
 {
-    if (!isReloadingSprites)
-    {
-        SDL_SemWait(pSpriteListSemaphore);
-        activeSpriteList.erase(find(activeSpriteList.begin(), activeSpriteList.end(), this));
-        SDL_SemPost(pSpriteListSemaphore);
-    }
-    else
-    {
-        deletedSpriteList.push_back(this);
-    }
+    SDL_SemWait(pSpriteListSemaphore);
+    activeSpriteList.erase(find(activeSpriteList.begin(), activeSpriteList.end(), this));
+    SDL_SemPost(pSpriteListSemaphore);
 
     UnloadTextures();
 
@@ -115,37 +124,59 @@ Image * Image::Load(const char * file, bool loadImmediately)
 
 void Image::ReloadImages()
 {
-    SDL_SemWait(pSpriteListSemaphore);
+    vector<MLIFont *> fontList;
 
-    isReloadingSprites = true;
+    SDL_SemWait(pSpriteListSemaphore);
 
     for (unsigned int i = 0; i < activeSpriteList.size(); i++)
     {
-        activeSpriteList[i]->ReloadFromSource();
-    }
+        Image *pSprite = activeSpriteList[i];
 
-    isReloadingSprites = false;
+        if (pSprite->pSource == NULL || pSprite->needsReload)
+        {
+            continue;
+        }
 
-    for (unsigned int i = 0; i < deletedSpriteList.size(); i++)
-    {
-        activeSpriteList.erase(find(activeSpriteList.begin(), activeSpriteList.end(), deletedSpriteList[i]));
-    }
+        FontSource *pFontSource = dynamic_cast<FontSource *>(pSprite->pSource);
 
-    for (unsigned int i = 0; i < newSpriteList.size(); i++)
-    {
-        activeSpriteList.push_back(newSpriteList[i]);
+        if (pFontSource != NULL)
+        {
+            // Glyph images are owned by their font, so we'll reinitialize each font once
+            // rather than once per glyph.
+            if (find(fontList.begin(), fontList.end(), pFontSource->GetFont()) == fontList.end())
+            {
+                fontList.push_back(pFontSource->GetFont());
+            }
+        }
+        else if (pSprite->pSource->GetCanEvict())
+        {
+            // These come back from their source the next time they're drawn,
+            // so anything that's not currently on screen won't hold us up.
+            pSprite->UnloadTextures();
+            pSprite->needsReload = true;
+        }
+        else
+        {
+            pSprite->ReloadFromSource();
+        }
     }
 
-    deletedSpriteList.clear();
-    newSpriteList.clear();
-
     SDL_SemPost(pSpriteListSemaphore);
+
+    // Reinitializing a font deletes its glyph images, which removes them from the sprite list,
+    // so we need to wait until we're done with that list before doing it.
+    // The glyphs will then be rendered again as they're needed.
+    for (unsigned int i = 0; i < fontList.size(); i++)
+    {
+        fontList[i]->Reinit();
+    }
 }
 
 void Image::Reload(SDL_Surface *pSurface, bool loadImmediately)
 {
     UnloadTextures();
     this->pSurface = pSurface;
+    needsReload = false;
 
     if (this->pSurface == NULL)
     {
@@ -177,6 +208,24 @@ void Image::Reload(SDL_RWops * ops, bool loadImmediately)
     Reload(IMG_Load_RW(ops, 1), loadImmediately);
 }
 
+void Image::FinishReload(SDL_Surface *pSurface)
+{
+    EnsureUIThread();
+
+    // The surface was decoded on another thread, so all that's left to do is create the textures.
+    if (this->pSurface != NULL)
+    {
+        SDL_FreeSurface(this->pSurface);
+    }
+
+    this->pSurface = pSurface;
+    this->width = this->pSurface->w;
+    this->height = this->pSurface->h;
+
+    needsReload = false;
+    LoadTextures();
+}
+
 void Image::LoadTextures()
 {
     for (vector<SDL_Texture *>::iterator iter = textureList.begin(); iter != textureList.end(); iter++)
@@ -189,6 +238,9 @@ void Image::LoadTextures()
     textureCountX = 0;
     textureCountY = 0;
 
+    AddResidentTextureByteCount(-(Sint64)textureByteCount);
+    textureByteCount = 0;
+
     if (pSurface->w <= gMaxTextureWidth && pSurface->h <= gMaxTextureHeight)
     {
         textureCountX = 1;
@@ -236,9 +288,14 @@ void Image::LoadTextures()
         }
     }
 
+    // The slices cover the surface exactly, so they add up to the same size regardless of how many there are.
+    textureByteCount = (Uint64)pSurface->w * pSurface->h * TextureBytesPerPixel;
+    AddResidentTextureByteCount((Sint64)textureByteCount);
+
     SDL_FreeSurface(pSurface);
     pSurface = NULL;
 
+    lastDrawnFrame = currentFrame;
     valid = true;
 }
 
@@ -265,6 +322,9 @@ void Image::UnloadTextures()
 
     textureCountX = 0;
     textureCountY = 0;
+
+    AddResidentTextureByteCount(-(Sint64)textureByteCount);
+    textureByteCount = 0;
 }
 
 void Image::ReloadFromSource()
@@ -333,6 +393,9 @@ void Image::DrawNineGrid(const Vector2 &position, double drawWidth, double drawH
     double remainingWidth = 0;
     double remainingHeight = 0;
 
+    // All of the pieces come from the same texture, so they can all go out in one draw call.
+    BeginBatch();
+
     // Top-left corner
     Draw(position + Vector2(leftXPosition, topYPosition), RectangleWH(leftX, topY, leftWidth, topHeight), false /* flipHorizontally */, false /* flipVertically */, 1.0, 1.0, Color::White);
 
@@ -408,6 +471,8 @@ void Image::DrawNineGrid(const Vector2 &position, double drawWidth, double drawH
 
     // Bottom-right corner
     Draw(position + Vector2(rightXPosition, bottomYPosition), RectangleWH(rightX, bottomY, rightWidth, bottomHeight), false /* flipHorizontally */, false /* flipVertically */, 1.0, 1.0, Color::White);
+
+    EndBatch();
 }
 
 void Image::Draw(
@@ -421,12 +486,23 @@ void Image::Draw(
 {
     EnsureUIThread();
 
+    // If we unloaded this sprite to stay within our texture budget or because the renderer lost our textures,
+    // then now's the time to bring it back.  It'll show up once its textures are loaded again.
+    if (needsReload)
+    {
+        needsReload = false;
+        textureReloadCount++;
+        ReloadFromSource();
+    }
+
     // If this isn't a valid sprite, then we just won't draw anything.
     if (!valid)
     {
         return;
     }
 
+    lastDrawnFrame = currentFrame;
+
     if (textureList.size() == 1)
     {
         // If we only have one texture, then we can just draw it without any processing.
@@ -530,20 +606,7 @@ void Image::Draw(
     double horizontalScaleToUse = 1.0;
     double verticalScaleToUse = 1.0;
 
-#ifdef GAME_EXECUTABLE
-    if (gIsSavingScreenshot)
-    {
-        horizontalScaleToUse = (double)gScreenshotWidth / gScreenWidth;
-        verticalScaleToUse = (double)gScreenshotHeight / gScreenHeight;
-    }
-    else if (gIsFullscreen)
-    {
-        horizontalOffsetToUse = gHorizontalOffset;
-        verticalOffsetToUse = gVerticalOffset;
-        horizontalScaleToUse = gScreenScale;
-        verticalScaleToUse = gScreenScale;
-    }
-#endif
+    GetScreenTransform(&horizontalOffsetToUse, &verticalOffsetToUse, &horizontalScaleToUse, &verticalScaleToUse);
 
     // Adjust the clip rect such that we're also clipping to the screen as well.
     if (position.GetX() < 0)
@@ -613,36 +676,366 @@ void Image::Draw(
         return;
     }
 
-    SDL_Rect srcRect =
-        {
-            (Sint16)(clipRect.GetX() + 0.5),
-            (Sint16)(clipRect.GetY() + 0.5),
-            (Uint16)(clipRect.GetWidth() + 0.5),
-            (Uint16)(clipRect.GetHeight() + 0.5)
-        };
-    SDL_Rect dstRect =
-        {
-            (Sint16)(horizontalOffsetToUse + position.GetX() * horizontalScaleToUse + 0.5),
-            (Sint16)(verticalOffsetToUse + position.GetY() * verticalScaleToUse + 0.5),
-            (Uint16)(clipRect.GetWidth() * (useScreenScaling ? horizontalScaleToUse : 1.0) * xScale + 0.5),
-            (Uint16)(clipRect.GetHeight() * (useScreenScaling ? verticalScaleToUse : 1.0) * yScale + 0.5)
-        };
+    BatchedQuad quad;
+
+    quad.sourceRect.x = (Sint16)(clipRect.GetX() + 0.5);
+    quad.sourceRect.y = (Sint16)(clipRect.GetY() + 0.5);
+    quad.sourceRect.w = (Uint16)(clipRect.GetWidth() + 0.5);
+    quad.sourceRect.h = (Uint16)(clipRect.GetHeight() + 0.5);
 
-    SDL_RendererFlip flags = SDL_FLIP_NONE;
+    quad.destinationRect.x = (Sint16)(horizontalOffsetToUse + position.GetX() * horizontalScaleToUse + 0.5);
+    quad.destinationRect.y = (Sint16)(verticalOffsetToUse + position.GetY() * verticalScaleToUse + 0.5);
+    quad.destinationRect.w = (Uint16)(clipRect.GetWidth() * (useScreenScaling ? horizontalScaleToUse : 1.0) * xScale + 0.5);
+    quad.destinationRect.h = (Uint16)(clipRect.GetHeight() * (useScreenScaling ? verticalScaleToUse : 1.0) * yScale + 0.5);
+
+    quad.flip = SDL_FLIP_NONE;
 
     if (flipHorizontally)
     {
-        flags = (SDL_RendererFlip)(flags | SDL_FLIP_HORIZONTAL);
+        quad.flip = (SDL_RendererFlip)(quad.flip | SDL_FLIP_HORIZONTAL);
     }
 
     if (flipVertically)
     {
-        flags = (SDL_RendererFlip)(flags | SDL_FLIP_VERTICAL);
+        quad.flip = (SDL_RendererFlip)(quad.flip | SDL_FLIP_VERTICAL);
     }
 
-    SDL_SetTextureColorMod(pTexture, color.GetIntR(), color.GetIntG(), color.GetIntB());
-    SDL_SetTextureAlphaMod(pTexture, color.GetIntA());
-    SDL_RenderCopyEx(gpRenderer, pTexture, &srcRect, &dstRect, 0, NULL, flags);
+    quad.color.r = (Uint8)color.GetIntR();
+    quad.color.g = (Uint8)color.GetIntG();
+    quad.color.b = (Uint8)color.GetIntB();
+    quad.color.a = (Uint8)color.GetIntA();
+
+    AddQuad(pTexture, quad);
+}
+
+bool Image::BeginDrawingToTexture(SDL_Texture *pTexture)
+{
+    // Anything still queued up was meant for whatever we were drawing to before.
+    FlushBatch();
+
+    if (SDL_SetRenderTarget(gpRenderer, pTexture) != 0)
+    {
+        return false;
+    }
+
+    isDrawingToTexture = true;
+
+    SDL_SetRenderDrawColor(gpRenderer, 0, 0, 0, 0);
+    SDL_RenderClear(gpRenderer);
+
+    return true;
+}
+
+void Image::EndDrawingToTexture()
+{
+    FlushBatch();
+
+    SDL_SetRenderTarget(gpRenderer, NULL);
+    isDrawingToTexture = false;
+}
+
+void Image::BeginBatch()
+{
+    batchDepth++;
+}
+
+void Image::EndBatch()
+{
+    if (batchDepth == 0)
+    {
+        return;
+    }
+
+    batchDepth--;
+
+    if (batchDepth == 0)
+    {
+        FlushBatch();
+    }
+}
+
+void Image::FlushBatch()
+{
+    if (batchedQuadList.empty())
+    {
+        return;
+    }
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    if (isGeometrySupported)
+    {
+        batchVertexList.resize(batchedQuadList.size() * 4);
+        batchIndexList.resize(batchedQuadList.size() * 6);
+
+        for (unsigned int i = 0; i < batchedQuadList.size(); i++)
+        {
+            const BatchedQuad &quad = batchedQuadList[i];
+            SDL_Vertex *pVertices = &batchVertexList[i * 4];
+            int *pIndices = &batchIndexList[i * 6];
+
+            float left = (float)quad.destinationRect.x;
+            float top = (float)quad.destinationRect.y;
+            float right = (float)(quad.destinationRect.x + quad.destinationRect.w);
+            float bottom = (float)(quad.destinationRect.y + quad.destinationRect.h);
+
+            float sourceLeft = 0;
+            float sourceTop = 0;
+            float sourceRight = 0;
+            float sourceBottom = 0;
+
+            if (pBatchTexture != NULL)
+            {
+                sourceLeft = (float)quad.sourceRect.x / batchTextureWidth;
+                sourceTop = (float)quad.sourceRect.y / batchTextureHeight;
+                sourceRight = (float)(quad.sourceRect.x + quad.sourceRect.w) / batchTextureWidth;
+                sourceBottom = (float)(quad.sourceRect.y + quad.sourceRect.h) / batchTextureHeight;
+            }
+
+            if ((quad.flip & SDL_FLIP_HORIZONTAL) != 0)
+            {
+                swap(sourceLeft, sourceRight);
+            }
+
+            if ((quad.flip & SDL_FLIP_VERTICAL) != 0)
+            {
+                swap(sourceTop, sourceBottom);
+            }
+
+            pVertices[0].position.x = left;
+            pVertices[0].position.y = top;
+            pVertices[0].tex_coord.x = sourceLeft;
+            pVertices[0].tex_coord.y = sourceTop;
+
+            pVertices[1].position.x = right;
+            pVertices[1].position.y = top;
+            pVertices[1].tex_coord.x = sourceRight;
+            pVertices[1].tex_coord.y = sourceTop;
+
+            pVertices[2].position.x = left;
+            pVertices[2].position.y = bottom;
+            pVertices[2].tex_coord.x = sourceLeft;
+            pVertices[2].tex_coord.y = sourceBottom;
+
+            pVertices[3].position.x = right;
+            pVertices[3].position.y = bottom;
+            pVertices[3].tex_coord.x = sourceRight;
+            pVertices[3].tex_coord.y = sourceBottom;
+
+            for (int j = 0; j < 4; j++)
+            {
+                pVertices[j].color = quad.color;
+            }
+
+            pIndices[0] = i * 4;
+            pIndices[1] = i * 4 + 1;
+            pIndices[2] = i * 4 + 2;
+            pIndices[3] = i * 4 + 2;
+            pIndices[4] = i * 4 + 1;
+            pIndices[5] = i * 4 + 3;
+        }
+
+        // The vertex colors take the place of the texture's color and alpha modulation.
+        if (pBatchTexture != NULL)
+        {
+            SDL_SetTextureColorMod(pBatchTexture, 255, 255, 255);
+            SDL_SetTextureAlphaMod(pBatchTexture, 255);
+        }
+        else
+        {
+            SDL_SetRenderDrawBlendMode(gpRenderer, SDL_BLENDMODE_BLEND);
+        }
+
+        if (SDL_RenderGeometry(gpRenderer, pBatchTexture, &batchVertexList[0], batchVertexList.size(), &batchIndexList[0], batchIndexList.size()) == 0)
+        {
+#ifdef GAME_EXECUTABLE
+            Profiler::NotifyDrawCall();
+#endif
+
+            batchedQuadList.clear();
+            return;
+        }
+
+        // If the renderer can't draw geometry, then we'll stop trying
+        // and just draw each quad on its own from now on.
+        isGeometrySupported = false;
+    }
+#endif
+
+    for (unsigned int i = 0; i < batchedQuadList.size(); i++)
+    {
+        DrawQuad(pBatchTexture, batchedQuadList[i]);
+    }
+
+    batchedQuadList.clear();
+}
+
+void Image::FillRectangle(const RectangleWH &rectangle, const Color &color)
+{
+    double horizontalOffsetToUse = 0.0;
+    double verticalOffsetToUse = 0.0;
+    double horizontalScaleToUse = 1.0;
+    double verticalScaleToUse = 1.0;
+
+    GetScreenTransform(&horizontalOffsetToUse, &verticalOffsetToUse, &horizontalScaleToUse, &verticalScaleToUse);
+
+    BatchedQuad quad;
+
+    quad.sourceRect.x = 0;
+    quad.sourceRect.y = 0;
+    quad.sourceRect.w = 0;
+    quad.sourceRect.h = 0;
+
+    quad.destinationRect.x = (int)(rectangle.GetX() * horizontalScaleToUse + horizontalOffsetToUse + 0.5);
+    quad.destinationRect.y = (int)(rectangle.GetY() * verticalScaleToUse + verticalOffsetToUse + 0.5);
+    quad.destinationRect.w = (int)(rectangle.GetWidth() * horizontalScaleToUse + 0.5);
+    quad.destinationRect.h = (int)(rectangle.GetHeight() * verticalScaleToUse + 0.5);
+
+    quad.flip = SDL_FLIP_NONE;
+
+    quad.color.r = (Uint8)color.GetIntR();
+    quad.color.g = (Uint8)color.GetIntG();
+    quad.color.b = (Uint8)color.GetIntB();
+    quad.color.a = (Uint8)color.GetIntA();
+
+    AddQuad(NULL, quad);
+}
+
+void Image::EnforceTextureBudget()
+{
+    currentFrame++;
+
+    if (GetResidentTextureByteCount() <= textureBudgetByteCount)
+    {
+        return;
+    }
+
+    SDL_SemWait(pSpriteListSemaphore);
+
+    vector<Image *> evictableSpriteList;
+
+    for (unsigned int i = 0; i < activeSpriteList.size(); i++)
+    {
+        Image *pSprite = activeSpriteList[i];
+
+        if (pSprite->valid &&
+            pSprite->pSource != NULL &&
+            pSprite->pSource->GetCanEvict() &&
+            currentFrame - pSprite->lastDrawnFrame >= MinFramesUndrawnBeforeEviction)
+        {
+            evictableSpriteList.push_back(pSprite);
+        }
+    }
+
+    sort(evictableSpriteList.begin(), evictableSpriteList.end(), CompareImagesByLastDrawnFrame);
+
+    for (unsigned int i = 0; i < evictableSpriteList.size() && GetResidentTextureByteCount() > textureBudgetByteCount; i++)
+    {
+        evictableSpriteList[i]->UnloadTextures();
+        evictableSpriteList[i]->needsReload = true;
+        textureEvictionCount++;
+    }
+
+    SDL_SemPost(pSpriteListSemaphore);
+}
+
+Uint64 Image::GetResidentTextureByteCount()
+{
+    SDL_AtomicLock(&residentTextureByteCountLock);
+    Uint64 byteCount = residentTextureByteCount;
+    SDL_AtomicUnlock(&residentTextureByteCountLock);
+
+    return byteCount;
+}
+
+bool Image::CompareImagesByLastDrawnFrame(Image *pImage1, Image *pImage2)
+{
+    return pImage1->lastDrawnFrame < pImage2->lastDrawnFrame;
+}
+
+void Image::AddResidentTextureByteCount(Sint64 byteCount)
+{
+    // Textures can be unloaded from loading threads, so we need to guard the total.
+    SDL_AtomicLock(&residentTextureByteCountLock);
+    residentTextureByteCount = (Uint64)((Sint64)residentTextureByteCount + byteCount);
+    SDL_AtomicUnlock(&residentTextureByteCountLock);
+}
+
+void Image::GetScreenTransform(double *pHorizontalOffset, double *pVerticalOffset, double *pHorizontalScale, double *pVerticalScale)
+{
+    *pHorizontalOffset = 0.0;
+    *pVerticalOffset = 0.0;
+    *pHorizontalScale = 1.0;
+    *pVerticalScale = 1.0;
+
+#ifdef GAME_EXECUTABLE
+    // Textures that we're drawing into are always at the game's native resolution,
+    // so we only need to scale when we're drawing to the screen.
+    if (isDrawingToTexture)
+    {
+        *pHorizontalScale = 1.0;
+        *pVerticalScale = 1.0;
+    }
+    else if (gIsSavingScreenshot)
+    {
+        *pHorizontalScale = (double)gScreenshotWidth / gScreenWidth;
+        *pVerticalScale = (double)gScreenshotHeight / gScreenHeight;
+    }
+    else if (gIsFullscreen)
+    {
+        *pHorizontalOffset = gHorizontalOffset;
+        *pVerticalOffset = gVerticalOffset;
+        *pHorizontalScale = gScreenScale;
+        *pVerticalScale = gScreenScale;
+    }
+#endif
+}
+
+void Image::AddQuad(SDL_Texture *pTexture, const BatchedQuad &quad)
+{
+    if (batchDepth == 0)
+    {
+        DrawQuad(pTexture, quad);
+        return;
+    }
+
+    if (!batchedQuadList.empty() && (pTexture != pBatchTexture || batchedQuadList.size() >= MaxBatchedQuadCount))
+    {
+        FlushBatch();
+    }
+
+    if (batchedQuadList.empty())
+    {
+        pBatchTexture = pTexture;
+        batchTextureWidth = 0;
+        batchTextureHeight = 0;
+
+        if (pBatchTexture != NULL)
+        {
+            SDL_QueryTexture(pBatchTexture, NULL, NULL, &batchTextureWidth, &batchTextureHeight);
+        }
+    }
+
+    batchedQuadList.push_back(quad);
+}
+
+void Image::DrawQuad(SDL_Texture *pTexture, const BatchedQuad &quad)
+{
+    if (pTexture != NULL)
+    {
+        SDL_SetTextureColorMod(pTexture, quad.color.r, quad.color.g, quad.color.b);
+        SDL_SetTextureAlphaMod(pTexture, quad.color.a);
+        SDL_RenderCopyEx(gpRenderer, pTexture, &quad.sourceRect, &quad.destinationRect, 0, NULL, quad.flip);
+    }
+    else
+    {
+        SDL_SetRenderDrawColor(gpRenderer, quad.color.r, quad.color.g, quad.color.b, quad.color.a);
+        SDL_SetRenderDrawBlendMode(gpRenderer, SDL_BLENDMODE_BLEND);
+        SDL_RenderFillRect(gpRenderer, &quad.destinationRect);
+    }
+
+#ifdef GAME_EXECUTABLE
+    Profiler::NotifyDrawCall();
+#endif
 }
 
 void Image::ResourceLoaderSource::DoReload()
@@ -57,9 +57,12 @@ public:
     static Image * Load(SDL_Surface * sdlSurface, bool loadImmediately = false);
     static Image * Load(SDL_RWops * ops, bool loadImmediately = false);
     static Image * Load(const char * file, bool loadImmediately = false);
+    // Called when the renderer has lost our textures.  Images from the resource loader
+    // are brought back the next time they're drawn, so only what's on screen gets reloaded right away.
     static void ReloadImages();
     void Reload(SDL_Surface * sdlSurface, bool loadImmediately = false);
     void Reload(SDL_RWops * ops, bool loadImmediately = false);
+    void FinishReload(SDL_Surface *pSurface);
     void LoadTextures();
     void UnloadTextures();
 
@@ -95,6 +98,29 @@ public:
         const Color &color,
         bool useScreenScaling = true);
 
+    static bool BeginDrawingToTexture(SDL_Texture *pTexture);
+    static void EndDrawingToTexture();
+
+    // While a batch is open, draws are queued up rather than sent straight to the renderer,
+    // and each run of consecutive draws from the same texture goes out as a single draw call.
+    // Batches can be nested - the queue is only flushed at the end of the outermost one.
+    static void BeginBatch();
+    static void EndBatch();
+    static void FlushBatch();
+
+    static void FillRectangle(const RectangleWH &rectangle, const Color &color);
+
+    // Called once per frame.  If the textures we've got loaded add up to more than our budget,
+    // this unloads the ones that have gone the longest without being drawn.
+    // They'll be reloaded from their source the next time something tries to draw them.
+    static void EnforceTextureBudget();
+
+    static Uint64 GetResidentTextureByteCount();
+    static Uint64 GetTextureBudgetByteCount() { return Image::textureBudgetByteCount; }
+    static void SetTextureBudgetByteCount(Uint64 textureBudgetByteCount) { Image::textureBudgetByteCount = textureBudgetByteCount; }
+    static unsigned int GetTextureEvictionCount() { return Image::textureEvictionCount; }
+    static unsigned int GetTextureReloadCount() { return Image::textureReloadCount; }
+
     Uint16 width;
     Uint16 height;
 
@@ -105,10 +131,41 @@ private:
     bool useScreenScaling;
 
     static vector<Image *> activeSpriteList;
-    static vector<Image *> newSpriteList;
-    static vector<Image *> deletedSpriteList;
     static SDL_sem *pSpriteListSemaphore;
-    static bool isReloadingSprites;
+    static bool isDrawingToTexture;
+
+    class BatchedQuad
+    {
+    public:
+        SDL_Rect sourceRect;
+        SDL_Rect destinationRect;
+        SDL_RendererFlip flip;
+        SDL_Color color;
+    };
+
+    static void GetScreenTransform(double *pHorizontalOffset, double *pVerticalOffset, double *pHorizontalScale, double *pVerticalScale);
+    static void AddQuad(SDL_Texture *pTexture, const BatchedQuad &quad);
+    static void DrawQuad(SDL_Texture *pTexture, const BatchedQuad &quad);
+
+    // A null texture means that the batch is made up of solid rectangles.
+    static SDL_Texture *pBatchTexture;
+    static int batchTextureWidth;
+    static int batchTextureHeight;
+    static vector<BatchedQuad> batchedQuadList;
+    static vector<SDL_Vertex> batchVertexList;
+    static vector<int> batchIndexList;
+    static unsigned int batchDepth;
+    static bool isGeometrySupported;
+
+    static bool CompareImagesByLastDrawnFrame(Image *pImage1, Image *pImage2);
+    static void AddResidentTextureByteCount(Sint64 byteCount);
+
+    static Uint32 currentFrame;
+    static Uint64 residentTextureByteCount;
+    static SDL_SpinLock residentTextureByteCountLock;
+    static Uint64 textureBudgetByteCount;
+    static unsigned int textureEvictionCount;
+    static unsigned int textureReloadCount;
 
     bool valid;
     SDL_Surface *pSurface;
@@ -118,11 +175,19 @@ private:
     int textureCountX;
     int textureCountY;
 
+    Uint64 textureByteCount;
+    Uint32 lastDrawnFrame;
+    bool needsReload;
+
     class Source
     {
     public:
         virtual ~Source() {}
         virtual void DoReload() = 0;
+
+        // Only sources that can bring back an image on their own
+        // without any other side effects should allow it to be evicted.
+        virtual bool GetCanEvict() { return false; }
     };
 
     class ResourceLoaderSource : public Source
@@ -140,6 +205,7 @@ private:
         }
 
         void DoReload();
+        bool GetCanEvict() { return true; }
 
     private:
         Image *pSprite;
@@ -160,6 +226,7 @@ private:
         }
 
         void DoReload();
+        MLIFont * GetFont() { return pFont; }
 
     private:
         MLIFont *pFont;
@@ -62,14 +62,15 @@ LocalizableContent::~LocalizableContent()
 LocalizableContent::FontInfo LocalizableContent::GetFontInfo(const string &fontId)
 {
     LocalizableContent::FontInfo returnValue;
+    IdHandle fontHandle = SymbolTable::Find(fontId);
 
     SDL_SemWait(pAccessSemaphore);
-    if (fontIdToFontInfoMap.count(fontId) == 0)
+    if (fontIdToFontInfoMap.count(fontHandle) == 0)
     {
         ThrowException(string("Font info ID not found: ") + fontId);
     }
 
-    returnValue = fontIdToFontInfoMap[fontId];
+    returnValue = fontIdToFontInfoMap[fontHandle];
     SDL_SemPost(pAccessSemaphore);
 
     return returnValue;
@@ -78,14 +79,33 @@ LocalizableContent::FontInfo LocalizableContent::GetFontInfo(const string &fontI
 string LocalizableContent::GetText(const string &textId)
 {
     string returnValue;
+    IdHandle textHandle = SymbolTable::Find(textId);
 
     SDL_SemWait(pAccessSemaphore);
-    if (textIdToTextMap.count(textId) == 0)
+    if (textIdToTextMap.count(textHandle) == 0)
     {
         ThrowException(string("Text ID not found: ") + textId);
     }
 
-    returnValue = textIdToTextMap[textId];
+    returnValue = textIdToTextMap[textHandle];
+    SDL_SemPost(pAccessSemaphore);
+
+    return returnValue;
+}
+
+string LocalizableContent::GetTextOrDefault(const string &textId, const string &defaultText)
+{
+    string returnValue = defaultText;
+    IdHandle textHandle = SymbolTable::Find(textId);
+
+    SDL_SemWait(pAccessSemaphore);
+    unordered_map<IdHandle, string>::iterator iter = textIdToTextMap.find(textHandle);
+
+    if (iter != textIdToTextMap.end())
+    {
+        returnValue = iter->second;
+    }
+
     SDL_SemPost(pAccessSemaphore);
 
     return returnValue;
@@ -94,19 +114,20 @@ string LocalizableContent::GetText(const string &textId)
 bool LocalizableContent::GetBooleanSetting(const string &settingId)
 {
     bool returnValue;
+    IdHandle settingHandle = SymbolTable::Find(settingId);
 
     SDL_SemWait(pAccessSemaphore);
-    if (settingIdToSettingMap.count(settingId) == 0)
+    if (settingIdToSettingMap.count(settingHandle) == 0)
     {
         ThrowException(string("Setting ID not found: ") + settingId);
     }
 
-    if (settingIdToSettingMap[settingId].ValueType != LocalizableContent::Setting::Type::Boolean)
+    if (settingIdToSettingMap[settingHandle].ValueType != LocalizableContent::Setting::Type::Boolean)
     {
         ThrowException(string("Setting ID ") + settingId + string(" is not a Boolean value."));
     }
 
-    returnValue = settingIdToSettingMap[settingId].BooleanValue;
+    returnValue = settingIdToSettingMap[settingHandle].BooleanValue;
     SDL_SemPost(pAccessSemaphore);
 
     return returnValue;
@@ -125,13 +146,13 @@ void LocalizableContent::LoadNewLanguage(XmlReader *pReader)
 
     while (pReader->MoveToNextListItem())
     {
-        string id = pReader->ReadTextAttribute("Id");
+        IdHandle id = SymbolTable::Intern(pReader->ReadTextAttribute("Id"));
         string filename = pReader->ReadTextAttribute("Filename");
         int size = pReader->ReadIntAttribute("Size");
 
         if (fontIdToFontInfoMap.count(id) > 0)
         {
-            ThrowException(string("Duplicate font ID found: ") + id);
+            ThrowException(string("Duplicate font ID found: ") + SymbolTable::GetString(id));
         }
 
         fontIdToFontInfoMap[id] = LocalizableContent::FontInfo(filename, size);
@@ -144,12 +165,12 @@ void LocalizableContent::LoadNewLanguage(XmlReader *pReader)
 
     while (pReader->MoveToNextListItem())
     {
-        string id = pReader->ReadTextAttribute("Id");
+        IdHandle id = SymbolTable::Intern(pReader->ReadTextAttribute("Id"));
         string text = pReader->ReadText();
 
         if (textIdToTextMap.count(id) > 0)
         {
-            ThrowException(string("Duplicate text ID found: ") + id);
+            ThrowException(string("Duplicate text ID found: ") + SymbolTable::GetString(id));
         }
 
         textIdToTextMap[id] = text;
@@ -162,13 +183,13 @@ void LocalizableContent::LoadNewLanguage(XmlReader *pReader)
 
     while (pReader->MoveToNextListItem())
     {
-        string id = pReader->ReadTextAttribute("Id");
+        IdHandle id = SymbolTable::Intern(pReader->ReadTextAttribute("Id"));
         string type = pReader->ReadTextAttribute("Type");
         string value = pReader->ReadTextAttribute("Value");
 
         if (settingIdToSettingMap.count(id) > 0)
         {
-            ThrowException(string("Duplicate setting ID found: ") + id);
+            ThrowException(string("Duplicate setting ID found: ") + SymbolTable::GetString(id));
         }
 
         settingIdToSettingMap[id] = LocalizableContent::Setting(type, value);
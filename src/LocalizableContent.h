@@ -31,10 +31,12 @@
 #define LOCALIZABLECONTENT_H
 
 #include "XmlReader.h"
+#include "SymbolTable.h"
 
 #include <SDL2/SDL.h>
 
 #include <map>
+#include <unordered_map>
 #include <list>
 #include <string>
 #include <algorithm>
@@ -103,6 +105,10 @@ public:
 
     LocalizableContent::FontInfo GetFontInfo(const string &fontId);
     string GetText(const string &textId);
+
+    // For text added after the localized content files that we might be running with,
+    // this returns the given default text instead of failing if the ID isn't there.
+    string GetTextOrDefault(const string &textId, const string &defaultText);
     bool GetBooleanSetting(const string &settingId);
 
     void LoadNewLanguage(XmlReader *pReader);
@@ -136,9 +142,9 @@ public:
 private:
     SDL_sem *pAccessSemaphore;
 
-    map<string, LocalizableContent::FontInfo> fontIdToFontInfoMap;
-    map<string, string> textIdToTextMap;
-    map<string, LocalizableContent::Setting> settingIdToSettingMap;
+    unordered_map<IdHandle, LocalizableContent::FontInfo> fontIdToFontInfoMap;
+    unordered_map<IdHandle, string> textIdToTextMap;
+    unordered_map<IdHandle, LocalizableContent::Setting> settingIdToSettingMap;
 
     list<ILocalizableFont *> localizableFonts;
     list<ILocalizableTextOwner *> localizableTextOwners;
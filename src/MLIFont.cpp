@@ -34,6 +34,10 @@
 #include "Utils.h"
 #include "utf8cpp/utf8.h"
 
+#ifdef GAME_EXECUTABLE
+#include "Profiler.h"
+#endif
+
 #include <vector>
 #include <algorithm>
 
@@ -295,6 +299,10 @@ void MLIFont::Draw(const string &s, Vector2 position, Color color, RectangleWH c
 
 void MLIFont::DrawInternal(const string &s, Vector2 position, Color color, double scale, RectangleWH clipRect)
 {
+#ifdef GAME_EXECUTABLE
+    Profiler::Zone zone("MLIFont::DrawInternal");
+#endif
+
     EnsureUIThread();
 
     // If we're trying to draw an empty string, we can just return -
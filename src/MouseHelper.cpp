@@ -517,12 +517,12 @@ void MouseHelper::UpdateState(bool isLeftButtonDown, int mouseX, int mouseY, boo
 
         if (doubleClickPossible)
         {
-            initialClickTime = SDL_GetTicks();
+            initialClickTime = gSimulationTimeMs;
         }
     }
     else if (currentWasLeftButtonDown && !previousWasLeftButtonDown)
     {
-        initialLeftButtonDownTime = SDL_GetTicks();
+        initialLeftButtonDownTime = gSimulationTimeMs;
         initialLeftButtonDownPosition = previousMousePosition;
         clickPossible = true;
         doubleClickWasPossible = doubleClickPossible;
@@ -540,7 +540,7 @@ void MouseHelper::UpdateTiming()
         // comes in fast enough following the down, and if the
         // cursor didn't move very far.
         clickPossible =
-                SDL_GetTicks() - initialLeftButtonDownTime <= ClickTimeThresholdMs &&
+                gSimulationTimeMs - initialLeftButtonDownTime <= ClickTimeThresholdMs &&
                 (previousMousePosition - initialLeftButtonDownPosition).Length() <= ClickDistanceThresholdPx;
     }
 
@@ -548,7 +548,7 @@ void MouseHelper::UpdateTiming()
     {
         // We should only mark this as a double-click if the
         // second click comes in fast enough following the first.
-        doubleClickPossible = SDL_GetTicks() - initialClickTime <= DoubleClickTimeThresholdMs;
+        doubleClickPossible = gSimulationTimeMs - initialClickTime <= DoubleClickTimeThresholdMs;
     }
 }
 
@@ -0,0 +1,315 @@
+/**
+ * Applies downloaded delta files to the files they update.  Patches to different
+ * files are independent of each other, so they're applied on several threads at once.
+ * Every staged file is recorded in a journal before it's written, so that
+ * an interrupted run can be cleaned up the next time around.
+ *
+ * @author GabuEx, dawnmew
+ * @since 1.0.7
+ *
+ * Licensed under the MIT License.
+ *
+ * Copyright (c) 2014 Equestrian Dreamers
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef UPDATER
+
+#include "PatchApplier.h"
+#include "FileFunctions.h"
+#include "VcdiffDecoder.h"
+
+#include <algorithm>
+#include <cstdio>
+
+PatchApplier::PatchApplier()
+{
+    pSemaphore = SDL_CreateSemaphore(1);
+    nextPatchChainIndex = 0;
+    failed = false;
+}
+
+PatchApplier::~PatchApplier()
+{
+    for (unsigned int i = 0; i < patchChainList.size(); i++)
+    {
+        delete patchChainList[i];
+    }
+
+    patchChainList.clear();
+    patchChainByFilePathMap.clear();
+
+    SDL_DestroySemaphore(pSemaphore);
+    pSemaphore = NULL;
+}
+
+void PatchApplier::SetBaseFilePath(const string &filePath, const string &baseFilePath)
+{
+    // Any patches to this file that come after this will be applied on top of the given file
+    // rather than on top of what's currently on disk - this happens when a file is added
+    // in one version and then updated in a later one.
+    sourceFilePathByFilePathMap[filePath] = baseFilePath;
+}
+
+void PatchApplier::AddPatch(const string &filePath, const string &deltaFilePath, const string &stagedFilePath)
+{
+    PatchChain *pChain = NULL;
+
+    if (patchChainByFilePathMap.count(filePath) > 0)
+    {
+        pChain = patchChainByFilePathMap[filePath];
+    }
+    else
+    {
+        pChain = new PatchChain(filePath);
+        patchChainList.push_back(pChain);
+        patchChainByFilePathMap[filePath] = pChain;
+    }
+
+    string sourceFilePath = filePath;
+
+    if (sourceFilePathByFilePathMap.count(filePath) > 0)
+    {
+        sourceFilePath = sourceFilePathByFilePathMap[filePath];
+    }
+
+    // Patches to the same file have to be applied one after another,
+    // each on top of the output of the last.
+    pChain->patchList.push_back(Patch(sourceFilePath, deltaFilePath, stagedFilePath));
+    sourceFilePathByFilePathMap[filePath] = stagedFilePath;
+}
+
+bool PatchApplier::Run()
+{
+    if (patchChainList.empty())
+    {
+        return true;
+    }
+
+    RollBackInterruptedRun();
+
+    journalFileStream.open(GetJournalFilePath().c_str(), ios_base::out | ios_base::trunc);
+
+    if (!journalFileStream)
+    {
+        failed = true;
+        return false;
+    }
+
+    nextPatchChainIndex = 0;
+    failed = false;
+    failedFilePath = "";
+
+    int threadCount = max(1, min(SDL_GetCPUCount(), (int)patchChainList.size()));
+    vector<SDL_Thread *> threadList;
+
+    for (int i = 0; i < threadCount; i++)
+    {
+        SDL_Thread *pThread = SDL_CreateThread(PatchApplier::ApplyPatchChainsStatic, "PatchApplierThread", this);
+
+        if (pThread != NULL)
+        {
+            threadList.push_back(pThread);
+        }
+    }
+
+    // If we couldn't get any threads at all, we'll just do the work here.
+    if (threadList.empty())
+    {
+        ApplyPatchChains();
+    }
+
+    for (unsigned int i = 0; i < threadList.size(); i++)
+    {
+        SDL_WaitThread(threadList[i], NULL);
+    }
+
+    journalFileStream.close();
+
+    if (failed)
+    {
+        RollBack();
+    }
+    else
+    {
+        // Every patch chain finished, so there's nothing left to roll back.
+        remove(GetJournalFilePath().c_str());
+    }
+
+    return !failed;
+}
+
+void PatchApplier::RollBack()
+{
+    RollBackInterruptedRun();
+
+    for (unsigned int i = 0; i < patchChainList.size(); i++)
+    {
+        for (unsigned int j = 0; j < patchChainList[i]->patchList.size(); j++)
+        {
+            patchChainList[i]->patchList[j].wasApplied = false;
+        }
+    }
+}
+
+bool PatchApplier::GetWasPatchApplied(const string &stagedFilePath)
+{
+    for (unsigned int i = 0; i < patchChainList.size(); i++)
+    {
+        for (unsigned int j = 0; j < patchChainList[i]->patchList.size(); j++)
+        {
+            if (patchChainList[i]->patchList[j].stagedFilePath == stagedFilePath)
+            {
+                return patchChainList[i]->patchList[j].wasApplied;
+            }
+        }
+    }
+
+    return false;
+}
+
+void PatchApplier::RollBackInterruptedRun()
+{
+    ifstream journalFileStream(GetJournalFilePath().c_str());
+
+    if (!journalFileStream)
+    {
+        return;
+    }
+
+    string stagedFilePath;
+
+    while (getline(journalFileStream, stagedFilePath))
+    {
+        if (stagedFilePath.length() > 0)
+        {
+            remove(stagedFilePath.c_str());
+            remove((stagedFilePath + ".tmp").c_str());
+        }
+    }
+
+    journalFileStream.close();
+    remove(GetJournalFilePath().c_str());
+}
+
+string PatchApplier::GetJournalFilePath()
+{
+    return GetTempDirectoryPath() + "update.journal";
+}
+
+int PatchApplier::ApplyPatchChainsStatic(void *pData)
+{
+    PatchApplier *pPatchApplier = reinterpret_cast<PatchApplier *>(pData);
+    pPatchApplier->ApplyPatchChains();
+    return 0;
+}
+
+void PatchApplier::ApplyPatchChains()
+{
+    while (true)
+    {
+        PatchChain *pChain = NULL;
+
+        SDL_SemWait(pSemaphore);
+
+        if (!failed && nextPatchChainIndex < patchChainList.size())
+        {
+            pChain = patchChainList[nextPatchChainIndex];
+            nextPatchChainIndex++;
+        }
+
+        SDL_SemPost(pSemaphore);
+
+        if (pChain == NULL)
+        {
+            break;
+        }
+
+        ApplyPatchChain(pChain);
+    }
+}
+
+void PatchApplier::ApplyPatchChain(PatchChain *pChain)
+{
+    for (unsigned int i = 0; i < pChain->patchList.size(); i++)
+    {
+        Patch &patch = pChain->patchList[i];
+
+        // We can only build on the previous patch's output if we produced it ourselves.
+        if (i > 0 && !pChain->patchList[i - 1].wasApplied)
+        {
+            break;
+        }
+
+        if (!JournalStagedFile(patch.stagedFilePath))
+        {
+            SDL_SemWait(pSemaphore);
+            failed = true;
+            failedFilePath = pChain->filePath;
+            SDL_SemPost(pSemaphore);
+            return;
+        }
+
+        // We write to a temporary file and only rename it into place once it's complete,
+        // so a staged file that exists is always a whole one.
+        string temporaryFilePath = patch.stagedFilePath + ".tmp";
+        VcdiffResult result = VcdiffDecoder::ApplyDelta(patch.sourceFilePath, patch.deltaFilePath, temporaryFilePath);
+
+        if (result == VcdiffResultSucceeded)
+        {
+            remove(patch.stagedFilePath.c_str());
+
+            if (rename(temporaryFilePath.c_str(), patch.stagedFilePath.c_str()) == 0)
+            {
+                patch.wasApplied = true;
+                continue;
+            }
+
+            result = VcdiffResultFailed;
+        }
+
+        if (result == VcdiffResultUnsupported)
+        {
+            // This one (and everything after it for this file) will be left
+            // for the update script to apply with the external tool.
+            break;
+        }
+
+        SDL_SemWait(pSemaphore);
+        failed = true;
+        failedFilePath = pChain->filePath;
+        SDL_SemPost(pSemaphore);
+        return;
+    }
+}
+
+bool PatchApplier::JournalStagedFile(const string &stagedFilePath)
+{
+    SDL_SemWait(pSemaphore);
+
+    journalFileStream << stagedFilePath << endl;
+    bool succeeded = !journalFileStream.fail();
+
+    SDL_SemPost(pSemaphore);
+
+    return succeeded;
+}
+
+#endif
@@ -0,0 +1,111 @@
+/**
+ * Basic header/include file for PatchApplier.cpp.
+ *
+ * @author GabuEx, dawnmew
+ * @since 1.0.7
+ *
+ * Licensed under the MIT License.
+ *
+ * Copyright (c) 2014 Equestrian Dreamers
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PATCHAPPLIER_H
+#define PATCHAPPLIER_H
+
+#ifdef UPDATER
+
+#include <SDL2/SDL.h>
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class PatchApplier
+{
+public:
+    PatchApplier();
+    ~PatchApplier();
+
+    void SetBaseFilePath(const string &filePath, const string &baseFilePath);
+    void AddPatch(const string &filePath, const string &deltaFilePath, const string &stagedFilePath);
+
+    bool Run();
+    void RollBack();
+
+    bool GetWasPatchApplied(const string &stagedFilePath);
+    string GetFailedFilePath() { return failedFilePath; }
+
+    static void RollBackInterruptedRun();
+
+private:
+    class Patch
+    {
+    public:
+        Patch(const string &sourceFilePath, const string &deltaFilePath, const string &stagedFilePath)
+        {
+            this->sourceFilePath = sourceFilePath;
+            this->deltaFilePath = deltaFilePath;
+            this->stagedFilePath = stagedFilePath;
+            this->wasApplied = false;
+        }
+
+        string sourceFilePath;
+        string deltaFilePath;
+        string stagedFilePath;
+        bool wasApplied;
+    };
+
+    class PatchChain
+    {
+    public:
+        PatchChain(const string &filePath)
+        {
+            this->filePath = filePath;
+        }
+
+        string filePath;
+        vector<Patch> patchList;
+    };
+
+    static string GetJournalFilePath();
+    static int ApplyPatchChainsStatic(void *pData);
+
+    void ApplyPatchChains();
+    void ApplyPatchChain(PatchChain *pChain);
+    bool JournalStagedFile(const string &stagedFilePath);
+
+    vector<PatchChain *> patchChainList;
+    map<string, PatchChain *> patchChainByFilePathMap;
+    map<string, string> sourceFilePathByFilePathMap;
+
+    SDL_sem *pSemaphore;
+    ofstream journalFileStream;
+    unsigned int nextPatchChainIndex;
+    bool failed;
+    string failedFilePath;
+};
+
+#endif
+
+#endif
@@ -0,0 +1,534 @@
+/**
+ * Records timing zones on every thread in per-thread ring buffers,
+ * and can display them in an overlay or export them for offline analysis.
+ *
+ * @author GabuEx, dawnmew
+ * @since 1.0.7
+ *
+ * Licensed under the MIT License.
+ *
+ * Copyright (c) 2014 Equestrian Dreamers
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Profiler.h"
+#include "globals.h"
+#include "Color.h"
+#include "Image.h"
+#include "MLIFont.h"
+#include "Vector2.h"
+#include "Video.h"
+#include "CaseInformation/CommonCaseResources.h"
+
+#include <algorithm>
+#include <fstream>
+#include <math.h>
+
+const unsigned int ThreadZoneBufferCapacity = 8192; // zone records
+const int StatisticsWindowDuration = 1000; // ms
+const unsigned int MaxDisplayedZoneCount = 20;
+const unsigned int MaxDisplayedVideoCount = 8;
+const int OverlayMargin = 5; // px
+const unsigned int OverlayHeaderLineCount = 4;
+const double BytesPerMegabyte = 1024.0 * 1024.0;
+
+const Color OverlayTextColor = Color(1.0, 1.0, 1.0, 1.0);
+const Color OverlayHeaderTextColor = Color(1.0, 1.0, 1.0, 0.2);
+
+bool Profiler::isInitialized = false;
+bool Profiler::isRecording = false;
+bool Profiler::isOverlayShowing = false;
+
+SDL_TLSID Profiler::threadZoneBufferTlsId = 0;
+vector<Profiler::ThreadZoneBuffer *> Profiler::threadZoneBufferList;
+vector<Profiler::ThreadZoneBuffer *> Profiler::freeThreadZoneBufferList;
+SDL_sem *Profiler::pThreadZoneBufferListSemaphore = NULL;
+
+Uint64 Profiler::frameStartTime = 0;
+Uint64 Profiler::statisticsWindowStartTime = 0;
+unsigned int Profiler::drawCallCount = 0;
+unsigned int Profiler::collisionTestCount = 0;
+unsigned int Profiler::collisionCount = 0;
+unsigned int Profiler::updateStepCount = 0;
+unsigned int Profiler::statisticsFrameCount = 0;
+unsigned int Profiler::statisticsDrawCallCount = 0;
+unsigned int Profiler::statisticsCollisionTestCount = 0;
+unsigned int Profiler::statisticsCollisionCount = 0;
+unsigned int Profiler::statisticsUpdateStepCount = 0;
+double Profiler::statisticsMaxFrameTimeMs = 0;
+double Profiler::statisticsFrameTimeSquaredSum = 0;
+map<string, Profiler::ZoneStatistics> Profiler::zoneStatisticsByNameMap;
+
+vector<pair<string, Profiler::ZoneStatistics> > Profiler::displayedZoneStatisticsList;
+double Profiler::displayedFrameTimeMs = 0;
+double Profiler::displayedDrawCallCount = 0;
+double Profiler::displayedCollisionTestCount = 0;
+double Profiler::displayedCollisionCount = 0;
+double Profiler::displayedUpdateStepCount = 0;
+double Profiler::displayedMaxFrameTimeMs = 0;
+double Profiler::displayedFrameTimeDeviationMs = 0;
+unsigned int Profiler::displayedStatisticsFrameCount = 1;
+
+unsigned int Profiler::prefetchHitCount = 0;
+unsigned int Profiler::prefetchMissCount = 0;
+Uint64 Profiler::prefetchedByteCount = 0;
+
+Profiler::Zone::Zone(const char *pName)
+{
+    this->pName = pName;
+    this->isRecording = Profiler::isRecording;
+
+    if (isRecording)
+    {
+        Profiler::GetThreadZoneBuffer()->depth++;
+        startTime = SDL_GetPerformanceCounter();
+    }
+    else
+    {
+        startTime = 0;
+    }
+}
+
+Profiler::Zone::~Zone()
+{
+    if (isRecording)
+    {
+        ZoneRecord record;
+
+        record.endTime = SDL_GetPerformanceCounter();
+        record.startTime = startTime;
+        record.pName = pName;
+        record.threadId = SDL_ThreadID();
+
+        ThreadZoneBuffer *pBuffer = Profiler::GetThreadZoneBuffer();
+
+        pBuffer->depth--;
+        record.depth = pBuffer->depth;
+        pBuffer->AddRecord(record);
+    }
+}
+
+Profiler::ThreadZoneBuffer::ThreadZoneBuffer()
+{
+    zoneRecordRing.resize(ThreadZoneBufferCapacity);
+    nextRecordIndex = 0;
+    recordCount = 0;
+    depth = 0;
+    lock = 0;
+}
+
+void Profiler::ThreadZoneBuffer::AddRecord(const ZoneRecord &record)
+{
+    // The lock is only ever contended while the UI thread is reading this buffer,
+    // so this is almost always an uncontended atomic operation.
+    SDL_AtomicLock(&lock);
+
+    zoneRecordRing[nextRecordIndex] = record;
+    nextRecordIndex = (nextRecordIndex + 1) % zoneRecordRing.size();
+    recordCount = min(recordCount + 1, (unsigned int)zoneRecordRing.size());
+
+    SDL_AtomicUnlock(&lock);
+}
+
+void Profiler::Init()
+{
+    if (isInitialized)
+    {
+        return;
+    }
+
+    threadZoneBufferTlsId = SDL_TLSCreate();
+    pThreadZoneBufferListSemaphore = SDL_CreateSemaphore(1);
+    frameStartTime = SDL_GetPerformanceCounter();
+    statisticsWindowStartTime = frameStartTime;
+    isInitialized = true;
+
+#ifdef MLI_DEBUG
+    // Zones are cheap enough to record all the time in debug builds,
+    // which means that a trace can be exported whether or not the overlay has ever been shown.
+    isRecording = true;
+#endif
+}
+
+void Profiler::Close()
+{
+    if (!isInitialized)
+    {
+        return;
+    }
+
+    isRecording = false;
+    isOverlayShowing = false;
+
+    // Thread-local pointers to these buffers may still be around on threads that are still running,
+    // so we leave the buffers themselves alone - the process is about to exit anyway.
+    SDL_DestroySemaphore(pThreadZoneBufferListSemaphore);
+    pThreadZoneBufferListSemaphore = NULL;
+    isInitialized = false;
+}
+
+void Profiler::ToggleOverlay()
+{
+    if (!isInitialized)
+    {
+        return;
+    }
+
+    isOverlayShowing = !isOverlayShowing;
+
+    zoneStatisticsByNameMap.clear();
+    displayedZoneStatisticsList.clear();
+    statisticsFrameCount = 0;
+    statisticsDrawCallCount = 0;
+    statisticsCollisionTestCount = 0;
+    statisticsCollisionCount = 0;
+    statisticsUpdateStepCount = 0;
+    statisticsMaxFrameTimeMs = 0;
+    statisticsFrameTimeSquaredSum = 0;
+    statisticsWindowStartTime = SDL_GetPerformanceCounter();
+}
+
+void Profiler::BeginFrame()
+{
+    if (!isInitialized)
+    {
+        return;
+    }
+
+    Uint64 now = SDL_GetPerformanceCounter();
+
+    // We only pay for summarizing zones while someone is looking at them.
+    if (isOverlayShowing)
+    {
+        AccumulateZoneStatistics(frameStartTime, now);
+
+        double frameTimeMs = (now - frameStartTime) * 1000.0 / SDL_GetPerformanceFrequency();
+
+        statisticsFrameCount++;
+        statisticsDrawCallCount += drawCallCount;
+        statisticsCollisionTestCount += collisionTestCount;
+        statisticsCollisionCount += collisionCount;
+        statisticsUpdateStepCount += updateStepCount;
+        statisticsMaxFrameTimeMs = max(statisticsMaxFrameTimeMs, frameTimeMs);
+        statisticsFrameTimeSquaredSum += frameTimeMs * frameTimeMs;
+
+        // Once per statistics window, we publish the averages for the overlay to display,
+        // so the numbers are stable enough to actually read.
+        if ((now - statisticsWindowStartTime) * 1000 / SDL_GetPerformanceFrequency() >= (Uint64)StatisticsWindowDuration)
+        {
+            double frequency = (double)SDL_GetPerformanceFrequency();
+
+            displayedFrameTimeMs = (now - statisticsWindowStartTime) * 1000.0 / frequency / statisticsFrameCount;
+            displayedDrawCallCount = (double)statisticsDrawCallCount / statisticsFrameCount;
+            displayedCollisionTestCount = (double)statisticsCollisionTestCount / statisticsFrameCount;
+            displayedCollisionCount = (double)statisticsCollisionCount / statisticsFrameCount;
+            displayedUpdateStepCount = (double)statisticsUpdateStepCount / statisticsFrameCount;
+            displayedMaxFrameTimeMs = statisticsMaxFrameTimeMs;
+
+            // The standard deviation of the frame time tells us how evenly paced our frames are.
+            double frameTimeVariance = statisticsFrameTimeSquaredSum / statisticsFrameCount - displayedFrameTimeMs * displayedFrameTimeMs;
+            displayedFrameTimeDeviationMs = frameTimeVariance > 0 ? sqrt(frameTimeVariance) : 0;
+            displayedStatisticsFrameCount = statisticsFrameCount;
+            displayedZoneStatisticsList.assign(zoneStatisticsByNameMap.begin(), zoneStatisticsByNameMap.end());
+            sort(displayedZoneStatisticsList.begin(), displayedZoneStatisticsList.end(), CompareZoneStatisticsByTime);
+
+            zoneStatisticsByNameMap.clear();
+            statisticsFrameCount = 0;
+            statisticsDrawCallCount = 0;
+            statisticsCollisionTestCount = 0;
+            statisticsCollisionCount = 0;
+            statisticsUpdateStepCount = 0;
+            statisticsMaxFrameTimeMs = 0;
+            statisticsFrameTimeSquaredSum = 0;
+            statisticsWindowStartTime = now;
+        }
+    }
+
+    frameStartTime = now;
+    drawCallCount = 0;
+    collisionTestCount = 0;
+    collisionCount = 0;
+    updateStepCount = 0;
+}
+
+void Profiler::NotifyCollisionTest(bool isCollision)
+{
+    collisionTestCount++;
+
+    if (isCollision)
+    {
+        collisionCount++;
+    }
+}
+
+void Profiler::SetPrefetchStatistics(unsigned int prefetchHitCount, unsigned int prefetchMissCount, Uint64 prefetchedByteCount)
+{
+    Profiler::prefetchHitCount = prefetchHitCount;
+    Profiler::prefetchMissCount = prefetchMissCount;
+    Profiler::prefetchedByteCount = prefetchedByteCount;
+}
+
+void Profiler::Draw()
+{
+    if (!isOverlayShowing)
+    {
+        return;
+    }
+
+    MLIFont *pFont = CommonCaseResources::GetInstance()->GetFontManager()->GetFontFromId("MouseOverFont");
+
+    if (pFont == NULL)
+    {
+        return;
+    }
+
+    double lineHeight = pFont->GetLineHeight();
+    unsigned int displayedZoneCount = min((unsigned int)displayedZoneStatisticsList.size(), MaxDisplayedZoneCount);
+
+    vector<Video::Statistics> videoStatisticsList;
+    Video::GetStatisticsList(&videoStatisticsList);
+
+    unsigned int displayedVideoCount = min((unsigned int)videoStatisticsList.size(), MaxDisplayedVideoCount);
+
+    SDL_Rect rect =
+    {
+        0,
+        0,
+        gScreenWidth / 2,
+        (int)(lineHeight * (displayedZoneCount + displayedVideoCount + OverlayHeaderLineCount) + 2 * OverlayMargin),
+    };
+
+    if (gIsFullscreen)
+    {
+        rect.x = (int)(rect.x * gScreenScale + gHorizontalOffset + 0.5);
+        rect.y = (int)(rect.y * gScreenScale + gVerticalOffset + 0.5);
+        rect.w = (int)(rect.w * gScreenScale + 0.5);
+        rect.h = (int)(rect.h * gScreenScale + 0.5);
+    }
+
+    SDL_SetRenderDrawColor(gpRenderer, 0, 0, 0, 192);
+    SDL_SetRenderDrawBlendMode(gpRenderer, SDL_BLENDMODE_BLEND);
+    SDL_RenderFillRect(gpRenderer, &rect);
+
+    char line[256];
+    double frequency = (double)SDL_GetPerformanceFrequency();
+
+    snprintf(line, 256, "Frame: %.2f ms, %.0f draw calls, %.1f collision tests (%.1f hits)", displayedFrameTimeMs, displayedDrawCallCount, displayedCollisionTestCount, displayedCollisionCount);
+    pFont->Draw(line, Vector2(OverlayMargin, OverlayMargin), OverlayHeaderTextColor);
+
+    snprintf(line, 256, "Textures: %.1f / %.1f MB resident, %u evictions, %u reloads",
+        Image::GetResidentTextureByteCount() / BytesPerMegabyte,
+        Image::GetTextureBudgetByteCount() / BytesPerMegabyte,
+        Image::GetTextureEvictionCount(),
+        Image::GetTextureReloadCount());
+    pFont->Draw(line, Vector2(OverlayMargin, OverlayMargin + lineHeight), OverlayHeaderTextColor);
+
+    snprintf(line, 256, "Pacing: %.2f ms worst frame, %.2f ms deviation, %.2f updates per frame%s",
+        displayedMaxFrameTimeMs,
+        displayedFrameTimeDeviationMs,
+        displayedUpdateStepCount,
+        gIsVsyncEnabled ? " (vsync)" : "");
+    pFont->Draw(line, Vector2(OverlayMargin, OverlayMargin + lineHeight * 2), OverlayHeaderTextColor);
+
+    unsigned int prefetchRequestCount = prefetchHitCount + prefetchMissCount;
+
+    snprintf(line, 256, "Prefetch: %u / %u hits (%.0f%%), %.1f / %d MB prefetched",
+        prefetchHitCount,
+        prefetchRequestCount,
+        prefetchRequestCount > 0 ? prefetchHitCount * 100.0 / prefetchRequestCount : 0.0,
+        prefetchedByteCount / BytesPerMegabyte,
+        gPrefetchBudgetMegabytes);
+    pFont->Draw(line, Vector2(OverlayMargin, OverlayMargin + lineHeight * 3), OverlayHeaderTextColor);
+
+    for (unsigned int i = 0; i < displayedZoneCount; i++)
+    {
+        const ZoneStatistics &statistics = displayedZoneStatisticsList[i].second;
+        double msPerFrame = statistics.totalTime * 1000.0 / frequency / displayedStatisticsFrameCount;
+        double callsPerFrame = (double)statistics.callCount / displayedStatisticsFrameCount;
+
+        snprintf(line, 256, "%s: %.3f ms (%.1f calls)", displayedZoneStatisticsList[i].first.c_str(), msPerFrame, callsPerFrame);
+        pFont->Draw(line, Vector2(OverlayMargin, OverlayMargin + lineHeight * (i + OverlayHeaderLineCount)), OverlayTextColor);
+    }
+
+    for (unsigned int i = 0; i < displayedVideoCount; i++)
+    {
+        const Video::Statistics &statistics = videoStatisticsList[i];
+
+        snprintf(line, 256, "Video %s: %ux%u, %u KB texture, decoder %s",
+            statistics.name.c_str(),
+            statistics.width,
+            statistics.height,
+            statistics.textureByteCount / 1024,
+            statistics.hasDecoder ? "open" : "closed");
+        pFont->Draw(line, Vector2(OverlayMargin, OverlayMargin + lineHeight * (i + displayedZoneCount + OverlayHeaderLineCount)), OverlayTextColor);
+    }
+}
+
+bool Profiler::ExportChromeTrace(const string &filePath)
+{
+    if (!isInitialized)
+    {
+        return false;
+    }
+
+    ofstream traceFileStream(filePath.c_str());
+
+    if (!traceFileStream.is_open())
+    {
+        return false;
+    }
+
+    double frequency = (double)SDL_GetPerformanceFrequency();
+    bool isFirstEvent = true;
+
+    // This is the "JSON array" flavor of the Chrome trace event format -
+    // each zone becomes a complete ("X") event with microsecond timestamps.
+    traceFileStream << "{\"traceEvents\":[" << endl;
+
+    SDL_SemWait(pThreadZoneBufferListSemaphore);
+
+    for (unsigned int i = 0; i < threadZoneBufferList.size(); i++)
+    {
+        ThreadZoneBuffer *pBuffer = threadZoneBufferList[i];
+
+        SDL_AtomicLock(&pBuffer->lock);
+
+        unsigned int firstRecordIndex = (pBuffer->nextRecordIndex + pBuffer->zoneRecordRing.size() - pBuffer->recordCount) % pBuffer->zoneRecordRing.size();
+
+        for (unsigned int j = 0; j < pBuffer->recordCount; j++)
+        {
+            const ZoneRecord &record = pBuffer->zoneRecordRing[(firstRecordIndex + j) % pBuffer->zoneRecordRing.size()];
+
+            if (!isFirstEvent)
+            {
+                traceFileStream << "," << endl;
+            }
+
+            traceFileStream
+                << "{\"name\":\"" << record.pName
+                << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << record.threadId
+                << ",\"ts\":" << (Uint64)(record.startTime * 1000000.0 / frequency)
+                << ",\"dur\":" << (Uint64)((record.endTime - record.startTime) * 1000000.0 / frequency)
+                << "}";
+
+            isFirstEvent = false;
+        }
+
+        SDL_AtomicUnlock(&pBuffer->lock);
+    }
+
+    SDL_SemPost(pThreadZoneBufferListSemaphore);
+
+    if (!isFirstEvent)
+    {
+        traceFileStream << "," << endl;
+    }
+
+    traceFileStream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << gUiThreadId << ",\"args\":{\"name\":\"UI\"}}" << endl;
+    traceFileStream << "]}" << endl;
+
+    return true;
+}
+
+Profiler::ThreadZoneBuffer * Profiler::GetThreadZoneBuffer()
+{
+    ThreadZoneBuffer *pBuffer = reinterpret_cast<ThreadZoneBuffer *>(SDL_TLSGet(threadZoneBufferTlsId));
+
+    if (pBuffer == NULL)
+    {
+        SDL_SemWait(pThreadZoneBufferListSemaphore);
+
+        // Threads like the pathfinding threads come and go all the time,
+        // so we hand out buffers from threads that have exited before making new ones.
+        // The records already in the buffer stay, since each one knows which thread it came from.
+        if (!freeThreadZoneBufferList.empty())
+        {
+            pBuffer = freeThreadZoneBufferList.back();
+            freeThreadZoneBufferList.pop_back();
+        }
+        else
+        {
+            pBuffer = new ThreadZoneBuffer();
+            threadZoneBufferList.push_back(pBuffer);
+        }
+
+        SDL_SemPost(pThreadZoneBufferListSemaphore);
+
+        pBuffer->depth = 0;
+        SDL_TLSSet(threadZoneBufferTlsId, pBuffer, Profiler::ReleaseThreadZoneBuffer);
+    }
+
+    return pBuffer;
+}
+
+void Profiler::ReleaseThreadZoneBuffer(void *pData)
+{
+    if (pThreadZoneBufferListSemaphore == NULL)
+    {
+        return;
+    }
+
+    SDL_SemWait(pThreadZoneBufferListSemaphore);
+    freeThreadZoneBufferList.push_back(reinterpret_cast<ThreadZoneBuffer *>(pData));
+    SDL_SemPost(pThreadZoneBufferListSemaphore);
+}
+
+void Profiler::AccumulateZoneStatistics(Uint64 windowStartTime, Uint64 windowEndTime)
+{
+    SDL_SemWait(pThreadZoneBufferListSemaphore);
+
+    for (unsigned int i = 0; i < threadZoneBufferList.size(); i++)
+    {
+        ThreadZoneBuffer *pBuffer = threadZoneBufferList[i];
+
+        SDL_AtomicLock(&pBuffer->lock);
+
+        // Records are added when zones end, so walking backwards from the newest record
+        // lets us stop as soon as we reach one that ended before this window.
+        for (unsigned int j = 1; j <= pBuffer->recordCount; j++)
+        {
+            const ZoneRecord &record = pBuffer->zoneRecordRing[(pBuffer->nextRecordIndex + pBuffer->zoneRecordRing.size() - j) % pBuffer->zoneRecordRing.size()];
+
+            if (record.endTime < windowStartTime)
+            {
+                break;
+            }
+
+            if (record.endTime >= windowEndTime)
+            {
+                continue;
+            }
+
+            ZoneStatistics &statistics = zoneStatisticsByNameMap[record.pName];
+
+            statistics.totalTime += record.endTime - record.startTime;
+            statistics.callCount++;
+        }
+
+        SDL_AtomicUnlock(&pBuffer->lock);
+    }
+
+    SDL_SemPost(pThreadZoneBufferListSemaphore);
+}
+
+bool Profiler::CompareZoneStatisticsByTime(const pair<string, ZoneStatistics> &pair1, const pair<string, ZoneStatistics> &pair2)
+{
+    return pair1.second.totalTime > pair2.second.totalTime;
+}
@@ -0,0 +1,156 @@
+/**
+ * Basic header/include file for Profiler.cpp.
+ *
+ * @author GabuEx, dawnmew
+ * @since 1.0.7
+ *
+ * Licensed under the MIT License.
+ *
+ * Copyright (c) 2014 Equestrian Dreamers
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <SDL2/SDL.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class Profiler
+{
+public:
+    // Declaring one of these at the top of a scope records how long that scope took.
+    // The name must be a string literal, since we hold onto the pointer.
+    class Zone
+    {
+    public:
+        Zone(const char *pName);
+        ~Zone();
+
+    private:
+        const char *pName;
+        Uint64 startTime;
+        bool isRecording;
+    };
+
+    static void Init();
+    static void Close();
+
+    static bool GetIsRecording() { return Profiler::isRecording; }
+
+    static void ToggleOverlay();
+    static void BeginFrame();
+    static void NotifyDrawCall() { Profiler::drawCallCount++; }
+    static unsigned int GetFrameDrawCallCount() { return Profiler::drawCallCount; }
+    static void NotifyUpdateStep() { Profiler::updateStepCount++; }
+    static void NotifyCollisionTest(bool isCollision);
+    static void SetPrefetchStatistics(unsigned int prefetchHitCount, unsigned int prefetchMissCount, Uint64 prefetchedByteCount);
+    static void Draw();
+
+    static bool ExportChromeTrace(const string &filePath);
+
+private:
+    class ZoneRecord
+    {
+    public:
+        const char *pName;
+        Uint64 startTime;
+        Uint64 endTime;
+        unsigned int depth;
+        SDL_threadID threadId;
+    };
+
+    class ThreadZoneBuffer
+    {
+    public:
+        ThreadZoneBuffer();
+
+        void AddRecord(const ZoneRecord &record);
+
+        vector<ZoneRecord> zoneRecordRing;
+        unsigned int nextRecordIndex;
+        unsigned int recordCount;
+        unsigned int depth;
+        SDL_SpinLock lock;
+    };
+
+    class ZoneStatistics
+    {
+    public:
+        ZoneStatistics()
+        {
+            totalTime = 0;
+            callCount = 0;
+        }
+
+        Uint64 totalTime;
+        unsigned int callCount;
+    };
+
+    static ThreadZoneBuffer * GetThreadZoneBuffer();
+    static void ReleaseThreadZoneBuffer(void *pData);
+    static void AccumulateZoneStatistics(Uint64 windowStartTime, Uint64 windowEndTime);
+    static bool CompareZoneStatisticsByTime(const pair<string, ZoneStatistics> &pair1, const pair<string, ZoneStatistics> &pair2);
+
+    static bool isInitialized;
+    static bool isRecording;
+    static bool isOverlayShowing;
+
+    static SDL_TLSID threadZoneBufferTlsId;
+    static vector<ThreadZoneBuffer *> threadZoneBufferList;
+    static vector<ThreadZoneBuffer *> freeThreadZoneBufferList;
+    static SDL_sem *pThreadZoneBufferListSemaphore;
+
+    static Uint64 frameStartTime;
+    static Uint64 statisticsWindowStartTime;
+    static unsigned int drawCallCount;
+    static unsigned int collisionTestCount;
+    static unsigned int collisionCount;
+    static unsigned int updateStepCount;
+    static unsigned int statisticsFrameCount;
+    static unsigned int statisticsDrawCallCount;
+    static unsigned int statisticsCollisionTestCount;
+    static unsigned int statisticsCollisionCount;
+    static unsigned int statisticsUpdateStepCount;
+    static double statisticsMaxFrameTimeMs;
+    static double statisticsFrameTimeSquaredSum;
+    static map<string, ZoneStatistics> zoneStatisticsByNameMap;
+
+    static vector<pair<string, ZoneStatistics> > displayedZoneStatisticsList;
+    static double displayedFrameTimeMs;
+    static double displayedDrawCallCount;
+    static double displayedCollisionTestCount;
+    static double displayedCollisionCount;
+    static double displayedUpdateStepCount;
+    static double displayedMaxFrameTimeMs;
+    static double displayedFrameTimeDeviationMs;
+    static unsigned int displayedStatisticsFrameCount;
+
+    static unsigned int prefetchHitCount;
+    static unsigned int prefetchMissCount;
+    static Uint64 prefetchedByteCount;
+};
+
+#endif
@@ -35,6 +35,7 @@
 
 #ifdef GAME_EXECUTABLE
 #include "mli_audio.h"
+#include "Profiler.h"
 #include "CaseInformation/Case.h"
 #endif
 
@@ -42,6 +43,11 @@
 
 ResourceLoader * ResourceLoader::pInstance = NULL;
 
+#ifdef GAME_EXECUTABLE
+const int MaxImageReloadThreadCount = 4;
+const unsigned int MaxImageReloadsFinishedPerFrame = 8;
+#endif
+
 #ifdef GAME_EXECUTABLE
 void ResourceLoader::LoadImageStep::Execute()
 {
@@ -332,8 +338,58 @@ Image * ResourceLoader::LoadImage(const string &relativeFilePath)
 
 void ResourceLoader::ReloadImage(Image *pSprite, const string &originFilePath)
 {
+#ifdef HEADLESS
+    SDL_Surface *pSurface = DecodeImageReloadSurface(originFilePath);
+
+    if (pSurface != NULL)
+    {
+        pSprite->FinishReload(pSurface);
+    }
+#else
+    if (imageReloadThreadList.empty())
+    {
+        StartImageReloadThreads();
+    }
+
+    SDL_SemWait(pImageReloadQueueSemaphore);
+
+    ImageReloadRequest request;
+    request.id = nextImageReloadRequestId++;
+    request.pImage = pSprite;
+    request.originFilePath = originFilePath;
+    request.pSurface = NULL;
+
+    pendingImageReloadQueue.push_back(request);
+
+    SDL_SemPost(pImageReloadQueueSemaphore);
+    SDL_SemPost(pImageReloadRequestCountSemaphore);
+#endif
+}
+
+void ResourceLoader::FinishImageReloads()
+{
+    // We hold onto the queue semaphore while creating textures so that
+    // an image can't be deleted out from under us in the meantime.
+    SDL_SemWait(pImageReloadQueueSemaphore);
+
+    for (unsigned int i = 0; i < MaxImageReloadsFinishedPerFrame && !decodedImageReloadQueue.empty(); i++)
+    {
+        ImageReloadRequest request = decodedImageReloadQueue.front();
+        decodedImageReloadQueue.pop_front();
+
+        request.pImage->FinishReload(request.pSurface);
+    }
+
+    SDL_SemPost(pImageReloadQueueSemaphore);
+}
+
+SDL_Surface * ResourceLoader::DecodeImageReloadSurface(const string &originFilePath)
+{
+    Profiler::Zone zone("ResourceLoader::DecodeImageReloadSurface");
+
     SDL_RWops *pRW = NULL;
     void *pMemToFree = NULL;
+    SDL_Surface *pSurface = NULL;
 
     SDL_SemWait(pLoadingSemaphore);
     pRW = pCommonResourcesSource->LoadFile(originFilePath, &pMemToFree);
@@ -344,16 +400,151 @@ void ResourceLoader::ReloadImage(Image *pSprite, const string &originFilePath)
     }
     SDL_SemPost(pLoadingSemaphore);
 
-    if (pRW == NULL)
+    if (pRW != NULL)
     {
-        pSprite->UnloadTextures();
+        pSurface = IMG_Load_RW(pRW, 1);
     }
-    else
+
+    free(pMemToFree);
+    return pSurface;
+}
+
+int ResourceLoader::ImageReloadThreadStatic(void *pData)
+{
+    ResourceLoader *pResourceLoader = reinterpret_cast<ResourceLoader *>(pData);
+    pResourceLoader->RunImageReloadThread();
+    return 0;
+}
+
+void ResourceLoader::RunImageReloadThread()
+{
+    while (true)
     {
-        pSprite->Reload(pRW, false /* loadImmediately */);
+        SDL_SemWait(pImageReloadRequestCountSemaphore);
+        SDL_SemWait(pImageReloadQueueSemaphore);
+
+        if (isStoppingImageReloadThreads)
+        {
+            SDL_SemPost(pImageReloadQueueSemaphore);
+            break;
+        }
+
+        // The request might have been removed if its image was unloaded in the meantime.
+        if (pendingImageReloadQueue.empty())
+        {
+            SDL_SemPost(pImageReloadQueueSemaphore);
+            continue;
+        }
+
+        ImageReloadRequest request = pendingImageReloadQueue.front();
+        pendingImageReloadQueue.pop_front();
+        decodingImageReloadList.push_back(request);
+
+        SDL_SemPost(pImageReloadQueueSemaphore);
+
+        SDL_Surface *pSurface = DecodeImageReloadSurface(request.originFilePath);
+
+        SDL_SemWait(pImageReloadQueueSemaphore);
+
+        bool requestIsStillWanted = false;
+
+        for (vector<ImageReloadRequest>::iterator iter = decodingImageReloadList.begin(); iter != decodingImageReloadList.end(); iter++)
+        {
+            if (iter->id == request.id)
+            {
+                decodingImageReloadList.erase(iter);
+                requestIsStillWanted = true;
+                break;
+            }
+        }
+
+        if (requestIsStillWanted && pSurface != NULL)
+        {
+            request.pSurface = pSurface;
+            decodedImageReloadQueue.push_back(request);
+        }
+        else if (pSurface != NULL)
+        {
+            SDL_FreeSurface(pSurface);
+        }
+
+        SDL_SemPost(pImageReloadQueueSemaphore);
     }
+}
 
-    free(pMemToFree);
+void ResourceLoader::StartImageReloadThreads()
+{
+    // We'll leave one core for the UI thread.
+    int threadCount = max(1, min(SDL_GetCPUCount() - 1, MaxImageReloadThreadCount));
+
+    isStoppingImageReloadThreads = false;
+
+    for (int i = 0; i < threadCount; i++)
+    {
+        imageReloadThreadList.push_back(SDL_CreateThread(ResourceLoader::ImageReloadThreadStatic, "ImageReloadThread", this));
+    }
+}
+
+void ResourceLoader::StopImageReloadThreads()
+{
+    SDL_SemWait(pImageReloadQueueSemaphore);
+    isStoppingImageReloadThreads = true;
+    SDL_SemPost(pImageReloadQueueSemaphore);
+
+    for (unsigned int i = 0; i < imageReloadThreadList.size(); i++)
+    {
+        SDL_SemPost(pImageReloadRequestCountSemaphore);
+    }
+
+    for (unsigned int i = 0; i < imageReloadThreadList.size(); i++)
+    {
+        SDL_WaitThread(imageReloadThreadList[i], NULL);
+    }
+
+    imageReloadThreadList.clear();
+
+    for (unsigned int i = 0; i < decodedImageReloadQueue.size(); i++)
+    {
+        SDL_FreeSurface(decodedImageReloadQueue[i].pSurface);
+    }
+
+    pendingImageReloadQueue.clear();
+    decodingImageReloadList.clear();
+    decodedImageReloadQueue.clear();
+}
+
+void ResourceLoader::RemoveImageReloadRequests(Image *pImage)
+{
+    SDL_SemWait(pImageReloadQueueSemaphore);
+
+    for (int i = static_cast<int>(pendingImageReloadQueue.size()) - 1; i >= 0; i--)
+    {
+        if (pendingImageReloadQueue[i].pImage == pImage)
+        {
+            pendingImageReloadQueue.erase(pendingImageReloadQueue.begin() + i);
+        }
+    }
+
+    // Requests that are being decoded right now will be thrown away when they finish,
+    // once the decoding thread sees they're no longer in this list.
+    for (int i = static_cast<int>(decodingImageReloadList.size()) - 1; i >= 0; i--)
+    {
+        if (decodingImageReloadList[i].pImage == pImage)
+        {
+            decodingImageReloadList.erase(decodingImageReloadList.begin() + i);
+        }
+    }
+
+    for (int i = static_cast<int>(decodedImageReloadQueue.size()) - 1; i >= 0; i--)
+    {
+        if (decodedImageReloadQueue[i].pImage == pImage)
+        {
+            SDL_FreeSurface(decodedImageReloadQueue[i].pSurface);
+            decodedImageReloadQueue.erase(decodedImageReloadQueue.begin() + i);
+        }
+    }
+
+    SDL_SemPost(pImageReloadQueueSemaphore);
 }
 #endif
 
@@ -690,6 +881,8 @@ void ResourceLoader::RemoveImage(Image *pImage)
     }
 
     SDL_SemPost(pQueueSemaphore);
+
+    RemoveImageReloadRequests(pImage);
 }
 
 void ResourceLoader::TryLoadOneImageTexture()
@@ -855,6 +1048,10 @@ bool ResourceLoader::HasLoadStep()
 
 void ResourceLoader::TryRunOneLoadStep()
 {
+#ifdef GAME_EXECUTABLE
+    Profiler::Zone zone("ResourceLoader::TryRunOneLoadStep");
+#endif
+
     if (HasLoadStep())
     {
         LoadResourceStep *pStep = cachedLoadResourceStepList.front();
@@ -879,12 +1076,20 @@ ResourceLoader::ResourceLoader()
     pLoadingSemaphore = SDL_CreateSemaphore(1);
     pQueueSemaphore = SDL_CreateSemaphore(1);
     pLoadQueueSemaphore = SDL_CreateSemaphore(1);
+
+    nextImageReloadRequestId = 0;
+    pImageReloadQueueSemaphore = SDL_CreateSemaphore(1);
+    pImageReloadRequestCountSemaphore = SDL_CreateSemaphore(0);
+    isStoppingImageReloadThreads = false;
 #endif
 }
 
 ResourceLoader::~ResourceLoader()
 {
 #ifdef GAME_EXECUTABLE
+    // The reload threads read from the archives, so they need to be stopped before those go away.
+    StopImageReloadThreads();
+
     delete pCommonResourcesSource;
     pCommonResourcesSource = NULL;
 #endif
@@ -902,6 +1107,10 @@ ResourceLoader::~ResourceLoader()
     pQueueSemaphore = NULL;
     SDL_DestroySemaphore(pLoadQueueSemaphore);
     pLoadQueueSemaphore = NULL;
+    SDL_DestroySemaphore(pImageReloadQueueSemaphore);
+    pImageReloadQueueSemaphore = NULL;
+    SDL_DestroySemaphore(pImageReloadRequestCountSemaphore);
+    pImageReloadRequestCountSemaphore = NULL;
 
     smartSpriteQueue.clear();
     deleteTextureQueue.clear();
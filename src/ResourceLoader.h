@@ -309,7 +309,12 @@ public:
 
     SDL_Surface * LoadRawSurface(const string &relativeFilePath);
     Image * LoadImage(const string &relativeFilePath);
+
+    // Reloads are decoded on a pool of background threads,
+    // and then have their textures created on the UI thread in FinishImageReloads().
+    // Headless runs decode and finish them immediately instead, so that they play out the same every time.
     void ReloadImage(Image *pSprite, const string &originFilePath);
+    void FinishImageReloads();
 #endif
     tinyxml2::XMLDocument * LoadDocument(const string &relativeFilePath);
 #if defined(GAME_EXECUTABLE) || defined(UPDATER)
@@ -372,6 +377,22 @@ private:
 #endif
 
 #ifdef GAME_EXECUTABLE
+    class ImageReloadRequest
+    {
+    public:
+        Uint32 id;
+        Image *pImage;
+        string originFilePath;
+        SDL_Surface *pSurface;
+    };
+
+    SDL_Surface * DecodeImageReloadSurface(const string &originFilePath);
+    static int ImageReloadThreadStatic(void *pData);
+    void RunImageReloadThread();
+    void StartImageReloadThreads();
+    void StopImageReloadThreads();
+    void RemoveImageReloadRequests(Image *pImage);
+
     SDL_sem *pLoadingSemaphore;
 
     map<string, void *> musicIdToMemToFreeMap;
@@ -383,6 +404,15 @@ private:
     deque<LoadResourceStep *> loadResourceStepList;
     deque<LoadResourceStep *> cachedLoadResourceStepList;
     SDL_sem *pLoadQueueSemaphore;
+
+    deque<ImageReloadRequest> pendingImageReloadQueue;
+    vector<ImageReloadRequest> decodingImageReloadList;
+    deque<ImageReloadRequest> decodedImageReloadQueue;
+    Uint32 nextImageReloadRequestId;
+    SDL_sem *pImageReloadQueueSemaphore;
+    SDL_sem *pImageReloadRequestCountSemaphore;
+    vector<SDL_Thread *> imageReloadThreadList;
+    bool isStoppingImageReloadThreads;
 #endif
 };
 
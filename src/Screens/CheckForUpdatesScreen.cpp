@@ -32,11 +32,14 @@
 #include "CheckForUpdatesScreen.h"
 #include "../XmlReader.h"
 #include "../FileFunctions.h"
+#include "../HttpDownloader.h"
+#include "../PatchApplier.h"
 #include "../globals.h"
 #include "../CaseInformation/CommonCaseResources.h"
 
 #include <cstdio>
 #include <fstream>
+#include <map>
 
 const int DotsUpdateDelayMs = 500;
 
@@ -66,74 +69,65 @@ string CheckForUpdatesScreen::PendingUpdate::PendingFileUpdate::GetFilePath()
     return filePath;
 }
 
-CheckForUpdatesScreen::ScheduledAction * CheckForUpdatesScreen::PendingUpdate::PendingFileUpdate::ScheduleAction()
+string CheckForUpdatesScreen::PendingUpdate::PendingFileUpdate::GetDownloadFilePath()
 {
-    CheckForUpdatesScreen::ScheduledAction *pScheduledAction = NULL;
+    string downloadFilePath = "";
 
     if (action == ActionUpdate)
     {
-        byte *pDeltaContent = NULL;
-        size_t deltaContentSize = 0;
-
-        bool retrievedUpdateContent = RetrieveDataFromUriHttp(deltaLocation, &pDeltaContent, &deltaContentSize, CheckForUpdatesScreen::DownloadUpdatesProgressCallback, static_cast<CheckForUpdatesScreen *>(pOwningScreen));
-
-        if (retrievedUpdateContent &&
-#ifdef MLI_DEBUG
-            DebugSignatureIsValid((const byte *)pDeltaContent, deltaContentSize, signature)
-#else
-            SignatureIsValid((const byte *)pDeltaContent, deltaContentSize, signature)
-#endif
-            )
-        {
-            string localDeltaFilePath = GetTempDirectoryPath() + GetFileNameFromUri(deltaLocation);
-
-            ofstream deltaFileStream(localDeltaFilePath.c_str(), ios_base::out | ios_base::trunc | ios_base::binary);
-
-            if (deltaFileStream)
-            {
-                deltaFileStream.write((const char *)pDeltaContent, deltaContentSize);
-                deltaFileStream.close();
-
-                pScheduledAction = new CheckForUpdatesScreen::ScheduledUpdate(GetFilePath() + ".pre" + newVersionString, localDeltaFilePath, GetFilePath());
-            }
-
-            delete [] pDeltaContent;
-        }
+        downloadFilePath = GetTempDirectoryPath() + GetFileNameFromUri(deltaLocation);
     }
     else if (action == ActionAdd)
     {
-        byte *pFileContent = NULL;
-        size_t fileContentSize = 0;
+        downloadFilePath = GetTempDirectoryPath() + GetFileNameFromFilePath(GetFilePath()) + ".toadd";
+    }
 
-        bool retrievedFileContent = RetrieveDataFromUriHttp(deltaLocation, &pFileContent, &fileContentSize, CheckForUpdatesScreen::DownloadUpdatesProgressCallback, static_cast<CheckForUpdatesScreen *>(pOwningScreen));
+    return downloadFilePath;
+}
 
-        if (retrievedFileContent &&
-#ifdef MLI_DEBUG
-            DebugSignatureIsValid((const byte *)pFileContent, fileContentSize, signature)
-#else
-            SignatureIsValid((const byte *)pFileContent, fileContentSize, signature)
-#endif
-            )
-        {
-            string stagingFilePath = GetTempDirectoryPath() + GetFileNameFromFilePath(GetFilePath()) + ".toadd";
-            ofstream fileStream(stagingFilePath.c_str(), ios_base::out | ios_base::trunc | ios_base::binary);
+string CheckForUpdatesScreen::PendingUpdate::PendingFileUpdate::GetStagedFilePath()
+{
+    return GetFilePath() + ".new" + newVersionString;
+}
 
-            if (fileStream)
-            {
-                fileStream.write((const char *)pFileContent, fileContentSize);
-                fileStream.close();
+void CheckForUpdatesScreen::PendingUpdate::PendingFileUpdate::QueueDownload(HttpDownloader *pDownloader)
+{
+    if (action == ActionUpdate || action == ActionAdd)
+    {
+        pDownloader->AddDownload(deltaLocation, GetDownloadFilePath(), signature);
+    }
+}
 
-                delete [] pFileContent;
-            }
-            else
-            {
-                delete [] pFileContent;
+void CheckForUpdatesScreen::PendingUpdate::PendingFileUpdate::QueuePatch(PatchApplier *pPatchApplier)
+{
+    if (action == ActionUpdate)
+    {
+        pPatchApplier->AddPatch(GetFilePath(), GetDownloadFilePath(), GetStagedFilePath());
+    }
+    else if (action == ActionAdd)
+    {
+        // Later updates to a file we're adding need to be applied to the downloaded copy,
+        // since the file won't be where it belongs until the update script runs.
+        pPatchApplier->SetBaseFilePath(GetFilePath(), GetDownloadFilePath());
+    }
+}
 
-                return NULL;
-            }
+CheckForUpdatesScreen::ScheduledAction * CheckForUpdatesScreen::PendingUpdate::PendingFileUpdate::ScheduleAction(PatchApplier *pPatchApplier)
+{
+    CheckForUpdatesScreen::ScheduledAction *pScheduledAction = NULL;
 
-            pScheduledAction = new CheckForUpdatesScreen::ScheduledAdd(stagingFilePath, GetFilePath(), pFileContent, fileContentSize);
-        }
+    // By the time we get here, the downloader has already put the file in place
+    // and checked its signature, so all we need to do is record what to do with it.
+    if (action == ActionUpdate)
+    {
+        // If we've already applied the delta ourselves, the script only needs to move
+        // the result into place; otherwise, it'll apply the delta itself.
+        string stagedFilePath = pPatchApplier->GetWasPatchApplied(GetStagedFilePath()) ? GetStagedFilePath() : "";
+        pScheduledAction = new CheckForUpdatesScreen::ScheduledUpdate(GetFilePath() + ".pre" + newVersionString, GetDownloadFilePath(), stagedFilePath, GetFilePath());
+    }
+    else if (action == ActionAdd)
+    {
+        pScheduledAction = new CheckForUpdatesScreen::ScheduledAdd(GetDownloadFilePath(), GetFilePath());
     }
     else if (action == ActionRemove)
     {
@@ -152,7 +146,16 @@ string CheckForUpdatesScreen::ScheduledUpdate::GetApplyScriptFileInstrunctions(u
     string scriptFileInstructions = GetPrintStringScriptInstructions(buf);
     scriptFileInstructions += GetRenameFileScriptInstructions(newFilePath, oldFilePath);
     scriptFileInstructions += GetCheckReturnValueScriptInstructions(versionUpdateIndex, versionUpdateSubIndex);
-    scriptFileInstructions += GetApplyDeltaFileScriptInstructions(oldFilePath, deltaFilePath, newFilePath);
+
+    if (stagedFilePath.length() > 0)
+    {
+        scriptFileInstructions += GetRenameFileScriptInstructions(stagedFilePath, newFilePath);
+    }
+    else
+    {
+        scriptFileInstructions += GetApplyDeltaFileScriptInstructions(oldFilePath, deltaFilePath, newFilePath);
+    }
+
     scriptFileInstructions += GetCheckReturnValueScriptInstructions(versionUpdateIndex, versionUpdateSubIndex);
     scriptFileInstructions += GetMakeExecutableScriptInstructions(newFilePath);
     scriptFileInstructions += GetRemoveFileScriptInstructions(deltaFilePath);
@@ -653,10 +656,75 @@ void CheckForUpdatesScreen::DownloadUpdates()
 
     unsigned int versionUpdateIndex = 1;
 
+    // If a previous run was cut off partway through patching, we'll clean up
+    // whatever it left behind before we start.
+    PatchApplier::RollBackInterruptedRun();
+
+    vector<PendingUpdate> pendingUpdateList;
+
     while (!pendingUpdateStack.empty())
     {
-        PendingUpdate pendingUpdate = pendingUpdateStack.top();
+        pendingUpdateList.push_back(pendingUpdateStack.top());
         pendingUpdateStack.pop();
+    }
+
+    // We download every file we'll need up front, several at a time,
+    // before scheduling any of the actions that use them.
+    HttpDownloader downloader;
+    map<string, string> filePathByDownloadFilePathMap;
+
+    for (unsigned int i = 0; i < pendingUpdateList.size(); i++)
+    {
+        PendingUpdate &pendingUpdate = pendingUpdateList[i];
+        pendingUpdate.BeginFileUpdateIteration();
+
+        while (pendingUpdate.MoveToNextFileUpdate())
+        {
+            pendingUpdate.QueueFileUpdateDownload(&downloader);
+            filePathByDownloadFilePathMap[pendingUpdate.GetFileUpdateDownloadFilePath()] = pendingUpdate.GetFileUpdateFilePath();
+        }
+    }
+
+    if (!downloader.Run(CheckForUpdatesScreen::DownloadUpdatesProgressCallback, this))
+    {
+        SDL_SemWait(pInteropSemaphore);
+        downloadComplete = true;
+        wasErrorInDownload = true;
+        problemUpdateFileForDownload = filePathByDownloadFilePathMap[downloader.GetFailedFilePath()];
+        SDL_SemPost(pInteropSemaphore);
+
+        return;
+    }
+
+    // Now that we have every delta, we'll apply as many of them as we can right here,
+    // with updates to different files being applied in parallel.
+    PatchApplier patchApplier;
+
+    for (unsigned int i = 0; i < pendingUpdateList.size(); i++)
+    {
+        PendingUpdate &pendingUpdate = pendingUpdateList[i];
+        pendingUpdate.BeginFileUpdateIteration();
+
+        while (pendingUpdate.MoveToNextFileUpdate())
+        {
+            pendingUpdate.QueueFileUpdatePatch(&patchApplier);
+        }
+    }
+
+    if (!patchApplier.Run())
+    {
+        SDL_SemWait(pInteropSemaphore);
+        downloadComplete = true;
+        wasErrorInDownload = true;
+        problemUpdateFileForDownload = patchApplier.GetFailedFilePath();
+        SDL_SemPost(pInteropSemaphore);
+
+        return;
+    }
+
+    for (unsigned int i = 0; i < pendingUpdateList.size(); i++)
+    {
+        PendingUpdate &pendingUpdate = pendingUpdateList[i];
 
         string newVersionString = pendingUpdate.GetNewVersionString();
 
@@ -669,7 +737,7 @@ void CheckForUpdatesScreen::DownloadUpdates()
 
         while (pendingUpdate.MoveToNextFileUpdate())
         {
-            CheckForUpdatesScreen::ScheduledAction *pScheduledAction = pendingUpdate.ScheduleFileUpdate();
+            CheckForUpdatesScreen::ScheduledAction *pScheduledAction = pendingUpdate.ScheduleFileUpdate(&patchApplier);
 
             if (pScheduledAction != NULL)
             {
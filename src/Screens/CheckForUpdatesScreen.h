@@ -43,7 +43,9 @@
 
 using namespace std;
 
+class HttpDownloader;
 class MLIFont;
+class PatchApplier;
 
 class CheckForUpdatesScreen : public MLIScreen
 {
@@ -123,8 +125,12 @@ private:
             int GetDeltaSize() { return this->deltaSize; }
             string GetDeltaLocation() { return this->deltaLocation; }
             string GetSignature() { return this->signature; }
+            string GetDownloadFilePath();
+            string GetStagedFilePath();
 
-            ScheduledAction * ScheduleAction();
+            void QueueDownload(HttpDownloader *pDownloader);
+            void QueuePatch(PatchApplier *pPatchApplier);
+            ScheduledAction * ScheduleAction(PatchApplier *pPatchApplier);
 
         private:
             string fileName;
@@ -176,9 +182,19 @@ private:
             return true;
         }
 
-        ScheduledAction * ScheduleFileUpdate()
+        void QueueFileUpdateDownload(HttpDownloader *pDownloader)
         {
-            return pCurrentFileUpdate->ScheduleAction();
+            pCurrentFileUpdate->QueueDownload(pDownloader);
+        }
+
+        void QueueFileUpdatePatch(PatchApplier *pPatchApplier)
+        {
+            pCurrentFileUpdate->QueuePatch(pPatchApplier);
+        }
+
+        ScheduledAction * ScheduleFileUpdate(PatchApplier *pPatchApplier)
+        {
+            return pCurrentFileUpdate->ScheduleAction(pPatchApplier);
         }
 
         string GetFileUpdateFilePath()
@@ -186,6 +202,11 @@ private:
             return pCurrentFileUpdate->GetFilePath();
         }
 
+        string GetFileUpdateDownloadFilePath()
+        {
+            return pCurrentFileUpdate->GetDownloadFilePath();
+        }
+
     private:
         vector<PendingFileUpdate> pendingFileUpdates;
         vector<PendingFileUpdate>::iterator pendingFileUpdatesIterator;
@@ -217,11 +238,12 @@ private:
     class ScheduledUpdate : public ScheduledAction
     {
     public:
-        ScheduledUpdate(string oldFilePath, string deltaFilePath, string newFilePath)
+        ScheduledUpdate(string oldFilePath, string deltaFilePath, string stagedFilePath, string newFilePath)
             : ScheduledAction(newFilePath)
         {
             this->oldFilePath = oldFilePath;
             this->deltaFilePath = deltaFilePath;
+            this->stagedFilePath = stagedFilePath;
             this->newFilePath = newFilePath;
         }
 
@@ -232,19 +254,18 @@ private:
     private:
         string oldFilePath;
         string deltaFilePath;
+        string stagedFilePath;
         string newFilePath;
     };
 
     class ScheduledAdd : public ScheduledAction
     {
     public:
-        ScheduledAdd(string stagingFilePath, string newFilePath, byte *pFileContent, size_t fileContentSize)
+        ScheduledAdd(string stagingFilePath, string newFilePath)
             : ScheduledAction(newFilePath)
         {
             this->stagingFilePath = stagingFilePath;
             this->newFilePath = newFilePath;
-            this->pFileContent = pFileContent;
-            this->fileContentSize = fileContentSize;
         }
 
         virtual string GetApplyScriptFileInstrunctions(unsigned int versionUpdateIndex, unsigned int versionUpdateSubIndex);
@@ -254,8 +275,6 @@ private:
     private:
         string stagingFilePath;
         string newFilePath;
-        byte *pFileContent;
-        size_t fileContentSize;
     };
 
     class ScheduledRemove : public ScheduledAction
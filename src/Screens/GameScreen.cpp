@@ -117,8 +117,13 @@ void GameScreen::Update(int delta)
 {
     if (!caseIsReady && gCaseFilePath.length() > 0)
     {
+    #ifdef HEADLESS
+        // Headless runs load on this thread so that every run reaches each frame in the same state.
+        GameScreen::LoadCaseStatic(new LoadCaseParameters(gCaseFilePath));
+    #else
         SDL_Thread *pThread = SDL_CreateThread(GameScreen::LoadCaseStatic, "LoadCaseThread", new LoadCaseParameters(gCaseFilePath));
         SDL_DetachThread(pThread);
+    #endif
         gCaseFilePath = "";
     }
 
@@ -191,12 +196,18 @@ void GameScreen::Update(int delta)
         caseNeedsReset = false;
     }
 
+    Case::GetInstance()->UpdatePrefetch();
+
     if (Case::GetInstance()->GetIsFinished())
     {
         stopMusic();
         isFinishing = true;
+    #ifdef HEADLESS
+        GameScreen::UnloadCaseStatic(this);
+    #else
         SDL_Thread *pThread = SDL_CreateThread(GameScreen::UnloadCaseStatic, "UnloadCaseThread", this);
         SDL_DetachThread(pThread);
+    #endif
         return;
     }
 
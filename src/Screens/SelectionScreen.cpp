@@ -276,6 +276,9 @@ void SelectionScreen::Init()
 {
     MLIScreen::Init();
 
+    // Make sure that any save that's still being written shows up in the list.
+    Case::WaitForPendingSaves();
+
     fadeOpacity = 1;
     pFadeInEase->Begin();
     pFadeOutEase->Reset();
@@ -31,6 +31,7 @@
 #include "../FileFunctions.h"
 #include "../globals.h"
 #include "../ResourceLoader.h"
+#include "../CaseInformation/Case.h"
 #include "../CaseInformation/CommonCaseResources.h"
 
 const string CandleAnimationId = "TitleScreenCandleAnimation";
@@ -230,6 +231,9 @@ void TitleScreen::Init()
 {
     MLIScreen::Init();
 
+    // If we've just come from a case, its last autosave may still be being written.
+    Case::WaitForPendingSaves();
+
     if (SaveFileExists())
     {
         pLoadGameButton->SetIsEnabled(true);
@@ -0,0 +1,202 @@
+/**
+ * Class for a uniform grid that finds which items' bounds contain a point
+ * without needing to check every item.
+ *
+ * @author GabuEx, dawnmew
+ * @since 1.0.7
+ *
+ * Licensed under the MIT License.
+ *
+ * Copyright (c) 2014 Equestrian Dreamers
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include "Rectangle.h"
+#include "Vector2.h"
+
+#include <math.h>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+template <typename ItemType>
+class SpatialGrid
+{
+public:
+    SpatialGrid(int cellSize) : cellSize(cellSize)
+    {
+        version = 1;
+    }
+
+    // Returns a number that changes whenever any item is added, moved or removed,
+    // so callers can tell whether results they got previously are still valid.
+    // This is never zero, so zero can be used to mean "no results yet".
+    unsigned int GetVersion() const { return this->version; }
+
+    bool Contains(const ItemType &item) const { return boundsByItemMap.find(item) != boundsByItemMap.end(); }
+
+    void Update(const ItemType &item, const RectangleWH &bounds)
+    {
+        typename unordered_map<ItemType, RectangleWH>::iterator iter = boundsByItemMap.find(item);
+
+        if (iter != boundsByItemMap.end())
+        {
+            // Items that haven't moved are by far the common case,
+            // so we only touch the cells if something has actually changed.
+            if (iter->second == bounds)
+            {
+                return;
+            }
+
+            RemoveFromCells(item, iter->second);
+            iter->second = bounds;
+        }
+        else
+        {
+            boundsByItemMap[item] = bounds;
+        }
+
+        AddToCells(item, bounds);
+        version++;
+    }
+
+    void Remove(const ItemType &item)
+    {
+        typename unordered_map<ItemType, RectangleWH>::iterator iter = boundsByItemMap.find(item);
+
+        if (iter == boundsByItemMap.end())
+        {
+            return;
+        }
+
+        RemoveFromCells(item, iter->second);
+        boundsByItemMap.erase(iter);
+        version++;
+    }
+
+    void Clear()
+    {
+        boundsByItemMap.clear();
+        itemListByCellMap.clear();
+        version++;
+    }
+
+    void GetItemsAtPoint(const Vector2 &point, vector<ItemType> *pItemList) const
+    {
+        pItemList->clear();
+
+        typename unordered_map<long long, vector<ItemType> >::const_iterator cellIter = itemListByCellMap.find(GetCellKey(GetCellCoordinate(point.GetX()), GetCellCoordinate(point.GetY())));
+
+        if (cellIter == itemListByCellMap.end())
+        {
+            return;
+        }
+
+        const vector<ItemType> &itemList = cellIter->second;
+
+        for (unsigned int i = 0; i < itemList.size(); i++)
+        {
+            const RectangleWH &bounds = boundsByItemMap.find(itemList[i])->second;
+
+            if (point.GetX() >= bounds.GetX() && point.GetX() <= bounds.GetX() + bounds.GetWidth() &&
+                point.GetY() >= bounds.GetY() && point.GetY() <= bounds.GetY() + bounds.GetHeight())
+            {
+                pItemList->push_back(itemList[i]);
+            }
+        }
+    }
+
+private:
+    int GetCellCoordinate(double coordinate) const
+    {
+        return (int)floor(coordinate / cellSize);
+    }
+
+    static long long GetCellKey(int cellX, int cellY)
+    {
+        return ((long long)cellX << 32) | (unsigned int)cellY;
+    }
+
+    void AddToCells(const ItemType &item, const RectangleWH &bounds)
+    {
+        int left = GetCellCoordinate(bounds.GetX());
+        int top = GetCellCoordinate(bounds.GetY());
+        int right = GetCellCoordinate(bounds.GetX() + bounds.GetWidth());
+        int bottom = GetCellCoordinate(bounds.GetY() + bounds.GetHeight());
+
+        for (int cellY = top; cellY <= bottom; cellY++)
+        {
+            for (int cellX = left; cellX <= right; cellX++)
+            {
+                itemListByCellMap[GetCellKey(cellX, cellY)].push_back(item);
+            }
+        }
+    }
+
+    void RemoveFromCells(const ItemType &item, const RectangleWH &bounds)
+    {
+        int left = GetCellCoordinate(bounds.GetX());
+        int top = GetCellCoordinate(bounds.GetY());
+        int right = GetCellCoordinate(bounds.GetX() + bounds.GetWidth());
+        int bottom = GetCellCoordinate(bounds.GetY() + bounds.GetHeight());
+
+        for (int cellY = top; cellY <= bottom; cellY++)
+        {
+            for (int cellX = left; cellX <= right; cellX++)
+            {
+                typename unordered_map<long long, vector<ItemType> >::iterator cellIter = itemListByCellMap.find(GetCellKey(cellX, cellY));
+
+                if (cellIter == itemListByCellMap.end())
+                {
+                    continue;
+                }
+
+                vector<ItemType> &itemList = cellIter->second;
+
+                for (unsigned int i = 0; i < itemList.size(); i++)
+                {
+                    if (itemList[i] == item)
+                    {
+                        itemList[i] = itemList.back();
+                        itemList.pop_back();
+                        break;
+                    }
+                }
+
+                if (itemList.empty())
+                {
+                    itemListByCellMap.erase(cellIter);
+                }
+            }
+        }
+    }
+
+    const int cellSize;
+    unsigned int version;
+
+    unordered_map<ItemType, RectangleWH> boundsByItemMap;
+    unordered_map<long long, vector<ItemType> > itemListByCellMap;
+};
+
+#endif // SPATIALGRID_H
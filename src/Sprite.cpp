@@ -32,10 +32,9 @@
 #include "CaseInformation/CommonCaseResources.h"
 #include "XmlReader.h"
 
-const string CommonFilesId = "CommonFiles";
-
 Sprite::Sprite(XmlReader *pReader)
 {
+    spriteSheetImageHandle = InvalidIdHandle;
     pSpriteSheetImage = NULL;
     spriteDrawOffset = Vector2(0, 0);
     pSpriteSheetSemaphore = SDL_CreateSemaphore(1);
@@ -46,6 +45,7 @@ Sprite::Sprite(XmlReader *pReader)
     if (pReader->ElementExists("SpriteSheetImageId"))
     {
         spriteSheetImageId = pReader->ReadTextElement("SpriteSheetImageId");
+        spriteSheetImageHandle = SymbolTable::Intern(spriteSheetImageId);
 
         pReader->StartElement("SpriteClipRect");
         spriteClipRect = RectangleWH(pReader);
@@ -182,38 +182,11 @@ void Sprite::DrawClipped(Vector2 position, RectangleWH clipRect, bool flipHorizo
         color);
 }
 
-void Sprite::UpdateReadiness(const string &newLocationId, bool *pLoadSprite, bool *pDeleteSprite)
+void Sprite::ClearCachedSpriteSheetImage()
 {
-    vector<string> parentLocationList = Case::GetInstance()->GetParentLocationListForSpriteSheetId(spriteSheetImageId);
-    bool isNeeded = false;
-
-    *pLoadSprite = false;
-    *pDeleteSprite = false;
-
-    for (unsigned int i = 0; i < parentLocationList.size(); i++)
-    {
-        if (parentLocationList[i] == newLocationId ||
-            parentLocationList[i] == CommonFilesId ||
-            parentLocationList[i] == Case::GetInstance()->GetPartnerManager()->GetCurrentPartnerId())
-        {
-            isNeeded = true;
-        }
-    }
-
-    bool isReady = IsReady();
-
-    if (isNeeded && !isReady)
-    {
-        *pLoadSprite = true;
-    }
-    else if (!isNeeded && isReady)
-    {
-        *pDeleteSprite = true;
-
-        SDL_SemWait(pSpriteSheetSemaphore);
-        pSpriteSheetImage = NULL;
-        SDL_SemPost(pSpriteSheetSemaphore);
-    }
+    SDL_SemWait(pSpriteSheetSemaphore);
+    pSpriteSheetImage = NULL;
+    SDL_SemPost(pSpriteSheetSemaphore);
 }
 
 bool Sprite::IsReady()
@@ -264,5 +237,5 @@ Image * Sprite::GetSpriteSheetImageNoCache()
             break;
     }
 
-    return pSpriteManager->GetImageFromId(spriteSheetImageId);
+    return pSpriteManager->GetImageFromId(spriteSheetImageHandle);
 }
@@ -35,6 +35,7 @@
 #include "Rectangle.h"
 #include "Vector2.h"
 #include "Image.h"
+#include "SymbolTable.h"
 
 class XmlReader;
 
@@ -43,6 +44,7 @@ class Sprite
 public:
     Sprite()
     {
+        spriteSheetImageHandle = InvalidIdHandle;
         pSpriteSheetImage = NULL;
         pSpriteSheetSemaphore = NULL;
         managerSource = ManagerSourceCommonResources;
@@ -51,6 +53,7 @@ public:
     Sprite(const string &spriteSheetImageId, const RectangleWH &spriteClipRect)
     {
         this->spriteSheetImageId = spriteSheetImageId;
+        this->spriteSheetImageHandle = SymbolTable::Intern(spriteSheetImageId);
         this->spriteClipRect = spriteClipRect;
         pSpriteSheetImage = NULL;
         pSpriteSheetSemaphore = SDL_CreateSemaphore(1);
@@ -63,6 +66,7 @@ public:
     void SetManagerSource(ManagerSource managerSource) { this->managerSource = managerSource; }
 
     string GetSpriteSheetImageId() const;
+    IdHandle GetSpriteSheetImageHandle() const { return this->spriteSheetImageHandle; }
     RectangleWH GetSpriteClipRect() const;
     double GetWidth();
     double GetHeight();
@@ -73,7 +77,7 @@ public:
     void DrawClipped(Vector2 position, RectangleWH clipRect, bool flipHorizontally);
     void DrawClipped(Vector2 position, RectangleWH clipRect, bool flipHorizontally, Color color);
 
-    void UpdateReadiness(const string &newLocationId, bool *pLoadSprite, bool *pDeleteSprite);
+    void ClearCachedSpriteSheetImage();
     bool IsReady();
 
 //private:
@@ -81,6 +85,7 @@ public:
     Image * GetSpriteSheetImageNoCache();
 
     string spriteSheetImageId;
+    IdHandle spriteSheetImageHandle;
     Image *pSpriteSheetImage;
     Vector2 spriteDrawOffset;
     Vector2 originalSize;
@@ -31,6 +31,7 @@
 #define STATE_H
 
 #include "enums.h"
+#include "SymbolTable.h"
 #include "TransitionRequest.h"
 #include "CaseInformation/DialogCutsceneManager.h"
 #include "CaseContent/Conversation.h"
@@ -47,6 +48,7 @@ public:
         , actionIndexSet(false)
         , speakerPosition(CharacterPositionNone)
         , leftCharacterId("")
+        , leftCharacterHandle(InvalidIdHandle)
         , leftCharacterEmotionId("")
         , isLeftCharacterTalking(false)
         , shouldLeftCharacterChangeMouth(false)
@@ -54,9 +56,11 @@ public:
         , pLeftCharacterXOffsetEasingFunction(NULL)
         , isLeftCharacterZoomed(false)
         , leftReplacementCharacterId("")
+        , leftReplacementCharacterHandle(InvalidIdHandle)
         , leftReplacementCharacterEmotionId("")
         , pLeftReplacementCharacterXOffsetEasingFunction(NULL)
         , rightCharacterId("")
+        , rightCharacterHandle(InvalidIdHandle)
         , rightCharacterEmotionId("")
         , isRightCharacterTalking(false)
         , shouldRightCharacterChangeMouth(false)
@@ -64,6 +68,7 @@ public:
         , pRightCharacterXOffsetEasingFunction(NULL)
         , isRightCharacterZoomed(false)
         , rightReplacementCharacterId("")
+        , rightReplacementCharacterHandle(InvalidIdHandle)
         , rightReplacementCharacterEmotionId("")
         , pRightReplacementCharacterXOffsetEasingFunction(NULL)
         , lastNavigationDirection(DirectNavigationDirectionNone)
@@ -121,7 +126,8 @@ public:
     void SetSpeakerPosition(CharacterPosition speakerPosition) { this->speakerPosition = speakerPosition; }
 
     string GetLeftCharacterId() const { return this->leftCharacterId; }
-    void SetLeftCharacterId(const string &leftCharacterId) { this->leftCharacterId = leftCharacterId; }
+    IdHandle GetLeftCharacterHandle() const { return this->leftCharacterHandle; }
+    void SetLeftCharacterId(const string &leftCharacterId) { this->leftCharacterId = leftCharacterId; this->leftCharacterHandle = GetCharacterHandle(leftCharacterId); }
 
     string GetLeftCharacterEmotionId() const { return this->leftCharacterEmotionId; }
     void SetLeftCharacterEmotionId(const string &leftCharacterEmotionId) { this->leftCharacterEmotionId = leftCharacterEmotionId; }
@@ -142,7 +148,8 @@ public:
     void SetIsLeftCharacterZoomed(bool isLeftCharacterZoomed) { this->isLeftCharacterZoomed = isLeftCharacterZoomed; }
 
     string GetLeftReplacementCharacterId() const { return this->leftReplacementCharacterId; }
-    void SetLeftReplacementCharacterId(const string &leftReplacementCharacterId) { this->leftReplacementCharacterId = leftReplacementCharacterId; }
+    IdHandle GetLeftReplacementCharacterHandle() const { return this->leftReplacementCharacterHandle; }
+    void SetLeftReplacementCharacterId(const string &leftReplacementCharacterId) { this->leftReplacementCharacterId = leftReplacementCharacterId; this->leftReplacementCharacterHandle = GetCharacterHandle(leftReplacementCharacterId); }
 
     string GetLeftReplacementCharacterEmotionId() const { return this->leftReplacementCharacterEmotionId; }
     void SetLeftReplacementCharacterEmotionId(const string &leftReplacementCharacterEmotionId) { this->leftReplacementCharacterEmotionId = leftReplacementCharacterEmotionId; }
@@ -151,7 +158,8 @@ public:
     void SetLeftReplacementCharacterXOffsetEasingFunction(EasingFunction *pLeftReplacementCharacterXOffsetEasingFunction) { this->pLeftReplacementCharacterXOffsetEasingFunction = pLeftReplacementCharacterXOffsetEasingFunction; }
 
     string GetRightCharacterId() const { return this->rightCharacterId; }
-    void SetRightCharacterId(const string &rightCharacterId) { this->rightCharacterId = rightCharacterId; }
+    IdHandle GetRightCharacterHandle() const { return this->rightCharacterHandle; }
+    void SetRightCharacterId(const string &rightCharacterId) { this->rightCharacterId = rightCharacterId; this->rightCharacterHandle = GetCharacterHandle(rightCharacterId); }
 
     string GetRightCharacterEmotionId() const { return this->rightCharacterEmotionId; }
     void SetRightCharacterEmotionId(const string &rightCharacterEmotionId) { this->rightCharacterEmotionId = rightCharacterEmotionId; }
@@ -172,7 +180,8 @@ public:
     void SetIsRightCharacterZoomed(bool isRightCharacterZoomed) { this->isRightCharacterZoomed = isRightCharacterZoomed; }
 
     string GetRightReplacementCharacterId() const { return this->rightReplacementCharacterId; }
-    void SetRightReplacementCharacterId(const string &rightReplacementCharacterId) { this->rightReplacementCharacterId = rightReplacementCharacterId; }
+    IdHandle GetRightReplacementCharacterHandle() const { return this->rightReplacementCharacterHandle; }
+    void SetRightReplacementCharacterId(const string &rightReplacementCharacterId) { this->rightReplacementCharacterId = rightReplacementCharacterId; this->rightReplacementCharacterHandle = GetCharacterHandle(rightReplacementCharacterId); }
 
     string GetRightReplacementCharacterEmotionId() const { return this->rightReplacementCharacterEmotionId; }
     void SetRightReplacementCharacterEmotionId(const string &rightReplacementCharacterEmotionId) { this->rightReplacementCharacterEmotionId = rightReplacementCharacterEmotionId; }
@@ -296,6 +305,10 @@ public:
 private:
     void SetActionIndexSet(bool actionIndexSet) { this->actionIndexSet = actionIndexSet; }
 
+    // The dialog characters are looked up every frame, so we resolve their handles
+    // whenever they change rather than each time they're drawn.
+    static IdHandle GetCharacterHandle(const string &characterId) { return characterId.length() > 0 ? SymbolTable::Find(characterId) : InvalidIdHandle; }
+
     State *pCachedState;
     State *pCachedStateForConfrontationRestart;
     int cachedActionIndex;
@@ -305,6 +318,7 @@ private:
     bool actionIndexSet;
     CharacterPosition speakerPosition;
     string leftCharacterId;
+    IdHandle leftCharacterHandle;
     string leftCharacterEmotionId;
     bool isLeftCharacterTalking;
     bool shouldLeftCharacterChangeMouth;
@@ -312,9 +326,11 @@ private:
     EasingFunction *pLeftCharacterXOffsetEasingFunction;
     bool isLeftCharacterZoomed;
     string leftReplacementCharacterId;
+    IdHandle leftReplacementCharacterHandle;
     string leftReplacementCharacterEmotionId;
     EasingFunction *pLeftReplacementCharacterXOffsetEasingFunction;
     string rightCharacterId;
+    IdHandle rightCharacterHandle;
     string rightCharacterEmotionId;
     bool isRightCharacterTalking;
     bool shouldRightCharacterChangeMouth;
@@ -322,6 +338,7 @@ private:
     EasingFunction *pRightCharacterXOffsetEasingFunction;
     bool isRightCharacterZoomed;
     string rightReplacementCharacterId;
+    IdHandle rightReplacementCharacterHandle;
     string rightReplacementCharacterEmotionId;
     EasingFunction *pRightReplacementCharacterXOffsetEasingFunction;
     DirectNavigationDirection lastNavigationDirection;
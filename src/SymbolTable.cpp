@@ -0,0 +1,203 @@
+/**
+ * Process-wide table of interned ID strings.
+ * IDs are interned when content is loaded, after which lookups
+ * can be done by handle rather than by comparing strings.
+ *
+ * @author GabuEx, dawnmew
+ * @since 1.0.7
+ *
+ * Licensed under the MIT License.
+ *
+ * Copyright (c) 2014 Equestrian Dreamers
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "SymbolTable.h"
+#include "MLIException.h"
+
+#include <functional>
+
+const unsigned int EntryChunkSize = 4096;
+const unsigned int MaxEntryChunkCount = 1024;
+const unsigned int InitialSlotCount = 8192;
+
+SymbolTable::Entry *SymbolTable::pEntryChunks[MaxEntryChunkCount];
+SDL_atomic_t SymbolTable::entryCount;
+
+void *SymbolTable::pCurrentSlotTable = NULL;
+vector<SymbolTable::SlotTable *> SymbolTable::retiredSlotTableList;
+
+SDL_sem *SymbolTable::pTableSemaphore = SDL_CreateSemaphore(1);
+
+SymbolTable::SlotTable::SlotTable(unsigned int slotCount)
+{
+    this->slotCount = slotCount;
+    pSlots = new SDL_atomic_t[slotCount];
+
+    for (unsigned int i = 0; i < slotCount; i++)
+    {
+        SDL_AtomicSet(&pSlots[i], 0);
+    }
+}
+
+IdHandle SymbolTable::Intern(const string &id)
+{
+    IdHandle handle = Find(id);
+
+    if (handle != InvalidIdHandle)
+    {
+        return handle;
+    }
+
+    size_t hash = std::hash<string>()(id);
+
+    SDL_SemWait(pTableSemaphore);
+
+    SlotTable *pSlotTable = reinterpret_cast<SlotTable *>(SDL_AtomicGetPtr(&pCurrentSlotTable));
+
+    if (pSlotTable == NULL)
+    {
+        pSlotTable = new SlotTable(InitialSlotCount);
+        SDL_AtomicSetPtr(&pCurrentSlotTable, pSlotTable);
+    }
+
+    // Someone else may have interned this ID while we were waiting on the lock.
+    handle = FindInSlotTable(pSlotTable, id, hash);
+
+    if (handle == InvalidIdHandle)
+    {
+        handle = (IdHandle)SDL_AtomicGet(&entryCount);
+
+        if (handle % EntryChunkSize == 0)
+        {
+            // The chunk list is fixed-size so that it never moves under a lookup,
+            // which means there's a hard cap on how many IDs we can ever intern.
+            if (handle / EntryChunkSize >= MaxEntryChunkCount)
+            {
+                SDL_SemPost(pTableSemaphore);
+                ThrowException("Too many IDs have been interned in the symbol table.");
+            }
+
+            pEntryChunks[handle / EntryChunkSize] = new Entry[EntryChunkSize];
+        }
+
+        Entry &entry = GetEntry(handle);
+        entry.id = id;
+        entry.hash = hash;
+
+        SDL_AtomicSet(&entryCount, handle + 1);
+
+        // We keep the table at most half full so that probe sequences stay short.
+        // Once it would go past that, we'll copy everything into a table twice the size
+        // and then publish it in place of the old one.
+        if ((handle + 1) * 2 > pSlotTable->slotCount)
+        {
+            SlotTable *pNewSlotTable = new SlotTable(pSlotTable->slotCount * 2);
+
+            for (IdHandle i = 0; i <= handle; i++)
+            {
+                AddToSlotTable(pNewSlotTable, i);
+            }
+
+            SDL_AtomicSetPtr(&pCurrentSlotTable, pNewSlotTable);
+
+            // Another thread may still be partway through a lookup in the old table,
+            // so we can't free it out from under them.
+            retiredSlotTableList.push_back(pSlotTable);
+        }
+        else
+        {
+            AddToSlotTable(pSlotTable, handle);
+        }
+    }
+
+    SDL_SemPost(pTableSemaphore);
+
+    return handle;
+}
+
+IdHandle SymbolTable::Find(const string &id)
+{
+    SlotTable *pSlotTable = reinterpret_cast<SlotTable *>(SDL_AtomicGetPtr(&pCurrentSlotTable));
+
+    if (pSlotTable == NULL)
+    {
+        return InvalidIdHandle;
+    }
+
+    return FindInSlotTable(pSlotTable, id, std::hash<string>()(id));
+}
+
+const string & SymbolTable::GetString(IdHandle handle)
+{
+    static const string emptyString = "";
+
+    if (handle == InvalidIdHandle || handle >= (IdHandle)SDL_AtomicGet(&entryCount))
+    {
+        return emptyString;
+    }
+
+    // Entries never move or change once they've been added,
+    // so there's no need to lock anything to read one.
+    return GetEntry(handle).id;
+}
+
+SymbolTable::Entry & SymbolTable::GetEntry(IdHandle handle)
+{
+    return pEntryChunks[handle / EntryChunkSize][handle % EntryChunkSize];
+}
+
+IdHandle SymbolTable::FindInSlotTable(SlotTable *pSlotTable, const string &id, size_t hash)
+{
+    unsigned int slotMask = pSlotTable->slotCount - 1;
+
+    for (unsigned int slotIndex = (unsigned int)hash & slotMask; ; slotIndex = (slotIndex + 1) & slotMask)
+    {
+        int slotValue = SDL_AtomicGet(&pSlotTable->pSlots[slotIndex]);
+
+        if (slotValue == 0)
+        {
+            return InvalidIdHandle;
+        }
+
+        IdHandle handle = (IdHandle)(slotValue - 1);
+        Entry &entry = GetEntry(handle);
+
+        if (entry.hash == hash && entry.id == id)
+        {
+            return handle;
+        }
+    }
+}
+
+void SymbolTable::AddToSlotTable(SlotTable *pSlotTable, IdHandle handle)
+{
+    unsigned int slotMask = pSlotTable->slotCount - 1;
+    unsigned int slotIndex = (unsigned int)GetEntry(handle).hash & slotMask;
+
+    while (SDL_AtomicGet(&pSlotTable->pSlots[slotIndex]) != 0)
+    {
+        slotIndex = (slotIndex + 1) & slotMask;
+    }
+
+    // The entry is fully written before this, so anyone who sees the slot filled in
+    // will also see the entry that it refers to.
+    SDL_AtomicSet(&pSlotTable->pSlots[slotIndex], (int)handle + 1);
+}
@@ -0,0 +1,89 @@
+/**
+ * Basic header/include file for SymbolTable.cpp.
+ *
+ * @author GabuEx, dawnmew
+ * @since 1.0.7
+ *
+ * Licensed under the MIT License.
+ *
+ * Copyright (c) 2014 Equestrian Dreamers
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SYMBOLTABLE_H
+#define SYMBOLTABLE_H
+
+#include <SDL2/SDL_atomic.h>
+#include <SDL2/SDL_thread.h>
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// A handle is a small, dense integer standing in for an interned ID string.
+// Two handles are equal if and only if the strings they were interned from are equal.
+typedef unsigned int IdHandle;
+
+const IdHandle InvalidIdHandle = 0xFFFFFFFF;
+
+// IDs are interned as content is loaded, but they're looked up from the game thread
+// and from loader threads alike, so lookups never take a lock. Only interning a new ID does.
+class SymbolTable
+{
+public:
+    static IdHandle Intern(const string &id);
+    static IdHandle Find(const string &id);
+    static const string & GetString(IdHandle handle);
+
+private:
+    class Entry
+    {
+    public:
+        string id;
+        size_t hash;
+    };
+
+    // An open-addressed table of slots, each of which holds either zero for an empty slot
+    // or one more than the handle stored in it. When it fills up, we build a larger table
+    // and swap it in, so a lookup already in progress can keep reading the old one.
+    class SlotTable
+    {
+    public:
+        SlotTable(unsigned int slotCount);
+
+        unsigned int slotCount;
+        SDL_atomic_t *pSlots;
+    };
+
+    static Entry & GetEntry(IdHandle handle);
+    static IdHandle FindInSlotTable(SlotTable *pSlotTable, const string &id, size_t hash);
+    static void AddToSlotTable(SlotTable *pSlotTable, IdHandle handle);
+
+    static Entry *pEntryChunks[];
+    static SDL_atomic_t entryCount;
+
+    static void *pCurrentSlotTable;
+    static vector<SlotTable *> retiredSlotTableList;
+
+    static SDL_sem *pTableSemaphore;
+};
+
+#endif
@@ -607,6 +607,8 @@ void ButtonArray::Draw()
 
 void ButtonArray::Draw(double xOffset, double yOffset)
 {
+    Image::BeginBatch();
+
     if (GetIsCancelable())
     {
         pBackTab->Draw(xOffset, yOffset);
@@ -633,6 +635,8 @@ void ButtonArray::Draw(double xOffset, double yOffset)
         pUpArrow->Draw(xOffset, yOffset);
         pDownArrow->Draw(xOffset, yOffset);
     }
+
+    Image::EndBatch();
 }
 
 void ButtonArray::ReorderOutAnimations(int newFirstOutButtonId)
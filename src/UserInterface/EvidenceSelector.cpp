@@ -587,6 +587,8 @@ void EvidenceSelector::Draw()
 
 void EvidenceSelector::Draw(double yOffset)
 {
+    Image::BeginBatch();
+
     pLeftArrow->Draw(animationOffset, yOffset);
     pRightArrow->Draw(animationOffset, yOffset);
 
@@ -626,6 +628,8 @@ void EvidenceSelector::Draw(double yOffset)
     {
         pCancelTab->Draw();
     }
+
+    Image::EndBatch();
 }
 
 void EvidenceSelector::Reset()
@@ -327,6 +327,8 @@ void PromptOverlay::Update(int delta)
 
 void PromptOverlay::Draw()
 {
+    Image::BeginBatch();
+
     pDarkeningImage->Draw(Vector2(0, 0), Color(fadeOpacity * 0.75, 1, 1, 1));
 
     if (allowsTextEntry)
@@ -336,27 +338,13 @@ void PromptOverlay::Draw()
 
         if (TextInputHelper::GetIsCaretShowing())
         {
-            SDL_Rect rect =
-            {
+            RectangleWH caretRect(
                 (int)(textEnteredPosition.GetX() + pTextEntryFont->GetWidth(textEntered.substr(0, TextInputHelper::GetCaretPosition()))),
                 (int)textEnteredPosition.GetY(),
                 2,
-                (int)pTextEntryFont->GetLineHeight()
-            };
-
-            // If we're in fullscreen mode, then we'll want to apply the screen scale and offsets,
-            // rounding to the nearest pixel.
-            if (gIsFullscreen)
-            {
-                rect.x = (int)(rect.x * gScreenScale + gHorizontalOffset + 0.5);
-                rect.y = (int)(rect.y * gScreenScale + gVerticalOffset + 0.5);
-                rect.w = (int)(rect.w * gScreenScale + 0.5);
-                rect.h = (int)(rect.h * gScreenScale + 0.5);
-            }
+                (int)pTextEntryFont->GetLineHeight());
 
-            SDL_SetRenderDrawColor(gpRenderer, 255, 255, 255, (Uint8)(fadeOpacity * 255));
-            SDL_SetRenderDrawBlendMode(gpRenderer, SDL_BLENDMODE_BLEND);
-            SDL_RenderFillRect(gpRenderer, &rect);
+            Image::FillRectangle(caretRect, Color(fadeOpacity, 1, 1, 1));
         }
     }
 
@@ -371,6 +359,8 @@ void PromptOverlay::Draw()
     {
         buttonList[i]->Draw(fadeOpacity);
     }
+
+    Image::EndBatch();
 }
 
 void PromptOverlay::Reset()
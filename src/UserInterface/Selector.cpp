@@ -286,6 +286,8 @@ void Selector::Draw()
     EnsureFonts();
     GetCurrentSectionAndIndex(&currentSection, &currentSectionStartIndex, &currentIndex);
 
+    Image::BeginBatch();
+
     // If we have a header, we'll draw that first.
     if (sectionList[currentSection]->GetTitle().length() > 0 && currentIndex - currentSectionStartIndex != 0)
     {
@@ -366,6 +368,8 @@ void Selector::Draw()
             pDownArrow->Draw();
         }
     }
+
+    Image::EndBatch();
 }
 
 void Selector::Reset()
@@ -43,6 +43,12 @@
 using namespace CryptoPP;
 using namespace std;
 
+const char *SignatureModulus = "23568332026097843589330224341232423824489227725618860714509096199525106220740317569413957190650367349886057276376951603027658474222300018538090882724127806422184385919973062121722991179344505183372523752666554302712122813070863946812173550830454356506133615226034873458142962497061909667034748542366872519001572246306747534032691513595335005177558602926751208654397458873075388398851331968483672593974371591236988537248649056651919444044050631175982858540930336744213602080363401671845205556669413373412866688398634151430976573005566658278720024181234244924513150893829727777179327452060753074929344789195138168478643";
+
+#ifdef MLI_DEBUG
+const char *DebugSignatureModulus = "25127550240698433095456861988330612763387201409434421689410230045576627300533253347003299422312409321939063771565520166677266132946889259805475875457912566611783652986808237532553682683789515572694559242247439051695593484936715091742187570641518452133088944600044756293341354836155070690166125642594312595564841652324658495660745417566243132555200969728548505121950277833708148480158904433374343859430094303995119766697126334610873165773273009440153681362153575480639032412566051309955491362037122138751878281498715320431839915865944665823918661112744515392927188947653483025773057100031684779035929432237780622316107";
+#endif
+
 #ifndef GAME_EXECUTABLE
 extern "C"
 {
@@ -308,7 +314,7 @@ string UuidFromSHA256Hash(byte hash[CryptoPP::SHA256::DIGESTSIZE])
 
 bool SignatureIsValid(const byte *pFileData, unsigned int fileSize, const string &hexEncodedSignature)
 {
-    Integer modulus("23568332026097843589330224341232423824489227725618860714509096199525106220740317569413957190650367349886057276376951603027658474222300018538090882724127806422184385919973062121722991179344505183372523752666554302712122813070863946812173550830454356506133615226034873458142962497061909667034748542366872519001572246306747534032691513595335005177558602926751208654397458873075388398851331968483672593974371591236988537248649056651919444044050631175982858540930336744213602080363401671845205556669413373412866688398634151430976573005566658278720024181234244924513150893829727777179327452060753074929344789195138168478643");
+    Integer modulus(SignatureModulus);
     Integer publicExponent("17");
 
     string signatureString;
@@ -331,7 +337,7 @@ bool SignatureIsValid(const byte *pFileData, unsigned int fileSize, const string
 #ifdef MLI_DEBUG
 bool DebugSignatureIsValid(const byte *pFileData, unsigned int fileSize, const string &hexEncodedSignature)
 {
-    Integer modulus("25127550240698433095456861988330612763387201409434421689410230045576627300533253347003299422312409321939063771565520166677266132946889259805475875457912566611783652986808237532553682683789515572694559242247439051695593484936715091742187570641518452133088944600044756293341354836155070690166125642594312595564841652324658495660745417566243132555200969728548505121950277833708148480158904433374343859430094303995119766697126334610873165773273009440153681362153575480639032412566051309955491362037122138751878281498715320431839915865944665823918661112744515392927188947653483025773057100031684779035929432237780622316107");
+    Integer modulus(DebugSignatureModulus);
     Integer publicExponent("17");
 
     string signatureString;
@@ -353,6 +359,64 @@ bool DebugSignatureIsValid(const byte *pFileData, unsigned int fileSize, const s
 #endif
 
 #ifndef GAME_EXECUTABLE
+typedef RSASS<PKCS1v15, SHA256>::Verifier SignatureVerifier;
+
+SignatureVerifier * CreateSignatureVerifier()
+{
+#ifdef MLI_DEBUG
+    Integer modulus(DebugSignatureModulus);
+#else
+    Integer modulus(SignatureModulus);
+#endif
+    Integer publicExponent("17");
+
+    RSA::PublicKey publicKey;
+    publicKey.Initialize(modulus, publicExponent);
+
+    return new SignatureVerifier(publicKey);
+}
+
+StreamingSignatureVerifier::StreamingSignatureVerifier()
+{
+    SignatureVerifier *pVerifier = CreateSignatureVerifier();
+    pAccumulator = pVerifier->NewVerificationAccumulator();
+    delete pVerifier;
+}
+
+StreamingSignatureVerifier::~StreamingSignatureVerifier()
+{
+    delete pAccumulator;
+    pAccumulator = NULL;
+}
+
+void StreamingSignatureVerifier::Update(const byte *pData, size_t dataSize)
+{
+    pAccumulator->Update(pData, dataSize);
+}
+
+void StreamingSignatureVerifier::Restart()
+{
+    delete pAccumulator;
+
+    SignatureVerifier *pVerifier = CreateSignatureVerifier();
+    pAccumulator = pVerifier->NewVerificationAccumulator();
+    delete pVerifier;
+}
+
+bool StreamingSignatureVerifier::Verify(const string &hexEncodedSignature)
+{
+    string signatureString;
+    CryptoPP::StringSource(hexEncodedSignature, true, new CryptoPP::HexDecoder(new CryptoPP::StringSink(signatureString)));
+
+    SignatureVerifier *pVerifier = CreateSignatureVerifier();
+
+    pVerifier->InputSignature(*pAccumulator, (const byte *)signatureString.c_str(), signatureString.length());
+    bool isValid = pVerifier->VerifyAndRestart(*pAccumulator);
+
+    delete pVerifier;
+    return isValid;
+}
+
 PFNPROGRESSCALLBACK pfnProgressCallbackCurrent = NULL;
 void *pProgressCallbackDataCurrent = NULL;
 
@@ -66,6 +66,30 @@ bool DebugSignatureIsValid(const byte *pFileData, unsigned int fileSize, const s
 
 string UuidFromSHA256Hash(byte hash[]);
 
+#ifndef GAME_EXECUTABLE
+namespace CryptoPP
+{
+    class PK_MessageAccumulator;
+}
+
+// Checks a signature against data that arrives a piece at a time,
+// so that the data never needs to be held in memory all at once.
+// This uses the same key as SignatureIsValid() (or DebugSignatureIsValid() in debug builds).
+class StreamingSignatureVerifier
+{
+public:
+    StreamingSignatureVerifier();
+    ~StreamingSignatureVerifier();
+
+    void Update(const byte *pData, size_t dataSize);
+    void Restart();
+    bool Verify(const string &hexEncodedSignature);
+
+private:
+    CryptoPP::PK_MessageAccumulator *pAccumulator;
+};
+#endif
+
 #ifndef GAME_EXECUTABLE
 bool RetrieveDataFromUriHttp(const string &uri, byte **ppByteDataFromUriHttp, size_t *pByteDataSize, PFNPROGRESSCALLBACK pfnProgressCallback = NULL, void *pProgressCallbackData = NULL);
 bool RetrieveStringFromUriHttp(const string &uri, string *pReturnString, PFNPROGRESSCALLBACK pfnProgressCallback = NULL, void *pProgressCallbackData = NULL);
@@ -0,0 +1,629 @@
+/**
+ * Applies VCDIFF (RFC 3284) delta files, such as those produced by xdelta3,
+ * without needing to run an external tool.
+ *
+ * @author GabuEx, dawnmew
+ * @since 1.0.7
+ *
+ * Licensed under the MIT License.
+ *
+ * Copyright (c) 2014 Equestrian Dreamers
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Patched files can be larger than 2 GB, so we need 64-bit file offsets on 32-bit POSIX builds.
+#ifndef __WINDOWS
+#define _FILE_OFFSET_BITS 64
+#endif
+
+#ifdef UPDATER
+
+#include "VcdiffDecoder.h"
+
+#include <cstring>
+
+const byte VcdiffMagic[] = { 0xD6, 0xC3, 0xC4, 0x00 };
+
+// Header indicator bits.
+const byte VcdDecompress = 0x01;
+const byte VcdCodeTable = 0x02;
+const byte VcdAppHeader = 0x04;
+
+// Window indicator bits.  The checksum bit is an xdelta3 extension.
+const byte VcdSource = 0x01;
+const byte VcdTarget = 0x02;
+const byte VcdAdler32 = 0x04;
+
+const unsigned int Adler32Modulus = 65521;
+
+VcdiffResult VcdiffDecoder::ApplyDelta(const string &sourceFilePath, const string &deltaFilePath, const string &targetFilePath)
+{
+    FILE *pDeltaFile = fopen(deltaFilePath.c_str(), "rb");
+
+    if (pDeltaFile == NULL)
+    {
+        return VcdiffResultFailed;
+    }
+
+    FILE *pSourceFile = fopen(sourceFilePath.c_str(), "rb");
+
+    if (pSourceFile == NULL)
+    {
+        fclose(pDeltaFile);
+        return VcdiffResultFailed;
+    }
+
+    // We'll need to read back what we've already written for windows
+    // that copy from earlier in the target, so this needs to be opened for both.
+    FILE *pTargetFile = fopen(targetFilePath.c_str(), "w+b");
+
+    if (pTargetFile == NULL)
+    {
+        fclose(pSourceFile);
+        fclose(pDeltaFile);
+        return VcdiffResultFailed;
+    }
+
+    VcdiffDecoder decoder(pSourceFile, pTargetFile);
+
+    SeekFile(pDeltaFile, 0, SEEK_END);
+    long long deltaFileSize = TellFile(pDeltaFile);
+    SeekFile(pDeltaFile, 0, SEEK_SET);
+
+    VcdiffResult result = VcdiffResultFailed;
+
+    if (deltaFileSize > 0)
+    {
+        decoder.deltaData.resize(deltaFileSize);
+
+        if (fread(&decoder.deltaData[0], 1, deltaFileSize, pDeltaFile) == (size_t)deltaFileSize)
+        {
+            result = decoder.Decode();
+        }
+    }
+
+    fclose(pDeltaFile);
+    fclose(pSourceFile);
+
+    if (fclose(pTargetFile) != 0 && result == VcdiffResultSucceeded)
+    {
+        result = VcdiffResultFailed;
+    }
+
+    if (result != VcdiffResultSucceeded)
+    {
+        remove(targetFilePath.c_str());
+    }
+
+    return result;
+}
+
+// fseek() and ftell() only take a long, which is 32 bits on Windows,
+// so we use the 64-bit versions of each wherever they're available.
+int VcdiffDecoder::SeekFile(FILE *pFile, long long offset, int origin)
+{
+#ifdef __WINDOWS
+    return _fseeki64(pFile, offset, origin);
+#else
+    return fseeko(pFile, (off_t)offset, origin);
+#endif
+}
+
+long long VcdiffDecoder::TellFile(FILE *pFile)
+{
+#ifdef __WINDOWS
+    return _ftelli64(pFile);
+#else
+    return (long long)ftello(pFile);
+#endif
+}
+
+VcdiffDecoder::VcdiffDecoder(FILE *pSourceFile, FILE *pTargetFile)
+{
+    this->pSourceFile = pSourceFile;
+    this->pTargetFile = pTargetFile;
+
+    deltaPosition = 0;
+
+    dataPosition = 0;
+    dataEnd = 0;
+    instructionPosition = 0;
+    instructionEnd = 0;
+    addressPosition = 0;
+    addressEnd = 0;
+
+    BuildDefaultCodeTable(codeTable);
+    ResetAddressCache();
+}
+
+VcdiffResult VcdiffDecoder::Decode()
+{
+    if (deltaData.size() < sizeof(VcdiffMagic) || memcmp(&deltaData[0], VcdiffMagic, sizeof(VcdiffMagic)) != 0)
+    {
+        return VcdiffResultFailed;
+    }
+
+    deltaPosition = sizeof(VcdiffMagic);
+
+    byte headerIndicator = 0;
+
+    if (!ReadByte(&deltaPosition, deltaData.size(), &headerIndicator))
+    {
+        return VcdiffResultFailed;
+    }
+
+    // We only understand deltas that use the default code table without secondary compression.
+    // Anything else we'll leave for the external tool to handle.
+    if ((headerIndicator & VcdDecompress) != 0 || (headerIndicator & VcdCodeTable) != 0)
+    {
+        return VcdiffResultUnsupported;
+    }
+
+    if ((headerIndicator & VcdAppHeader) != 0)
+    {
+        size_t appHeaderLength = 0;
+
+        if (!ReadInteger(&deltaPosition, deltaData.size(), &appHeaderLength) || appHeaderLength > deltaData.size() - deltaPosition)
+        {
+            return VcdiffResultFailed;
+        }
+
+        deltaPosition += appHeaderLength;
+    }
+
+    while (deltaPosition < deltaData.size())
+    {
+        VcdiffResult result = DecodeWindow();
+
+        if (result != VcdiffResultSucceeded)
+        {
+            return result;
+        }
+    }
+
+    return VcdiffResultSucceeded;
+}
+
+VcdiffResult VcdiffDecoder::DecodeWindow()
+{
+    byte windowIndicator = 0;
+
+    if (!ReadByte(&deltaPosition, deltaData.size(), &windowIndicator))
+    {
+        return VcdiffResultFailed;
+    }
+
+    if ((windowIndicator & VcdSource) != 0 && (windowIndicator & VcdTarget) != 0)
+    {
+        return VcdiffResultFailed;
+    }
+
+    size_t sourceSegmentLength = 0;
+    size_t sourceSegmentPosition = 0;
+
+    sourceSegment.clear();
+
+    if ((windowIndicator & (VcdSource | VcdTarget)) != 0)
+    {
+        if (!ReadInteger(&deltaPosition, deltaData.size(), &sourceSegmentLength) ||
+            !ReadInteger(&deltaPosition, deltaData.size(), &sourceSegmentPosition))
+        {
+            return VcdiffResultFailed;
+        }
+
+        // The source segment comes either from the file we're patching
+        // or from the part of the target that we've already written.
+        FILE *pSegmentFile = (windowIndicator & VcdSource) != 0 ? pSourceFile : pTargetFile;
+
+        sourceSegment.resize(sourceSegmentLength);
+        fflush(pSegmentFile);
+
+        if (SeekFile(pSegmentFile, (long long)sourceSegmentPosition, SEEK_SET) != 0 ||
+            (sourceSegmentLength > 0 && fread(&sourceSegment[0], 1, sourceSegmentLength, pSegmentFile) != sourceSegmentLength))
+        {
+            return VcdiffResultFailed;
+        }
+
+        if (pSegmentFile == pTargetFile)
+        {
+            SeekFile(pTargetFile, 0, SEEK_END);
+        }
+    }
+
+    size_t deltaEncodingLength = 0;
+
+    if (!ReadInteger(&deltaPosition, deltaData.size(), &deltaEncodingLength) || deltaEncodingLength > deltaData.size() - deltaPosition)
+    {
+        return VcdiffResultFailed;
+    }
+
+    size_t deltaEncodingEnd = deltaPosition + deltaEncodingLength;
+    size_t targetWindowLength = 0;
+    byte deltaIndicator = 0;
+    size_t dataLength = 0;
+    size_t instructionLength = 0;
+    size_t addressLength = 0;
+
+    if (!ReadInteger(&deltaPosition, deltaEncodingEnd, &targetWindowLength) ||
+        !ReadByte(&deltaPosition, deltaEncodingEnd, &deltaIndicator) ||
+        !ReadInteger(&deltaPosition, deltaEncodingEnd, &dataLength) ||
+        !ReadInteger(&deltaPosition, deltaEncodingEnd, &instructionLength) ||
+        !ReadInteger(&deltaPosition, deltaEncodingEnd, &addressLength))
+    {
+        return VcdiffResultFailed;
+    }
+
+    // Secondary compression of the individual sections isn't something we handle.
+    if (deltaIndicator != 0)
+    {
+        return VcdiffResultUnsupported;
+    }
+
+    unsigned int expectedChecksum = 0;
+
+    if ((windowIndicator & VcdAdler32) != 0)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            byte checksumByte = 0;
+
+            if (!ReadByte(&deltaPosition, deltaEncodingEnd, &checksumByte))
+            {
+                return VcdiffResultFailed;
+            }
+
+            expectedChecksum = (expectedChecksum << 8) | checksumByte;
+        }
+    }
+
+    if (dataLength + instructionLength + addressLength != deltaEncodingEnd - deltaPosition)
+    {
+        return VcdiffResultFailed;
+    }
+
+    dataPosition = deltaPosition;
+    dataEnd = dataPosition + dataLength;
+    instructionPosition = dataEnd;
+    instructionEnd = instructionPosition + instructionLength;
+    addressPosition = instructionEnd;
+    addressEnd = addressPosition + addressLength;
+
+    targetWindow.clear();
+    targetWindow.reserve(targetWindowLength);
+    ResetAddressCache();
+
+    while (instructionPosition < instructionEnd)
+    {
+        byte codeTableIndex = 0;
+        ReadByte(&instructionPosition, instructionEnd, &codeTableIndex);
+
+        const CodeTableEntry &entry = codeTable[codeTableIndex];
+
+        // Each code table entry holds up to two instructions.
+        // A size of zero means that the real size follows in the instruction section.
+        for (int i = 0; i < 2; i++)
+        {
+            byte type = i == 0 ? entry.type1 : entry.type2;
+            size_t size = i == 0 ? entry.size1 : entry.size2;
+            byte mode = i == 0 ? entry.mode1 : entry.mode2;
+
+            if (type == InstructionTypeNoOp)
+            {
+                continue;
+            }
+
+            if (size == 0 && !ReadInteger(&instructionPosition, instructionEnd, &size))
+            {
+                return VcdiffResultFailed;
+            }
+
+            if (!ExecuteInstruction(type, size, mode, sourceSegmentLength, targetWindowLength))
+            {
+                return VcdiffResultFailed;
+            }
+        }
+    }
+
+    if (targetWindow.size() != targetWindowLength || dataPosition != dataEnd || addressPosition != addressEnd)
+    {
+        return VcdiffResultFailed;
+    }
+
+    if ((windowIndicator & VcdAdler32) != 0 && ComputeAdler32(targetWindow) != expectedChecksum)
+    {
+        return VcdiffResultFailed;
+    }
+
+    if (targetWindowLength > 0 && fwrite(&targetWindow[0], 1, targetWindowLength, pTargetFile) != targetWindowLength)
+    {
+        return VcdiffResultFailed;
+    }
+
+    deltaPosition = deltaEncodingEnd;
+    return VcdiffResultSucceeded;
+}
+
+bool VcdiffDecoder::ExecuteInstruction(byte type, size_t size, byte mode, size_t sourceSegmentLength, size_t targetWindowLength)
+{
+    if (size > targetWindowLength - targetWindow.size())
+    {
+        return false;
+    }
+
+    switch (type)
+    {
+        case InstructionTypeAdd:
+            if (size > dataEnd - dataPosition)
+            {
+                return false;
+            }
+
+            targetWindow.insert(targetWindow.end(), deltaData.begin() + dataPosition, deltaData.begin() + dataPosition + size);
+            dataPosition += size;
+            break;
+
+        case InstructionTypeRun:
+            {
+                byte runByte = 0;
+
+                if (!ReadByte(&dataPosition, dataEnd, &runByte))
+                {
+                    return false;
+                }
+
+                targetWindow.insert(targetWindow.end(), size, runByte);
+            }
+            break;
+
+        case InstructionTypeCopy:
+            {
+                size_t here = sourceSegmentLength + targetWindow.size();
+                size_t address = 0;
+
+                if (!DecodeAddress(here, mode, &address) || address >= here)
+                {
+                    return false;
+                }
+
+                // Copies from the target window can overlap the bytes they're producing,
+                // so this has to go one byte at a time.
+                for (size_t i = 0; i < size; i++)
+                {
+                    size_t position = address + i;
+
+                    if (position < sourceSegmentLength)
+                    {
+                        targetWindow.push_back(sourceSegment[position]);
+                    }
+                    else
+                    {
+                        targetWindow.push_back(targetWindow[position - sourceSegmentLength]);
+                    }
+                }
+            }
+            break;
+
+        default:
+            return false;
+    }
+
+    return true;
+}
+
+bool VcdiffDecoder::ReadByte(size_t *pPosition, size_t end, byte *pValue)
+{
+    if (*pPosition >= end)
+    {
+        return false;
+    }
+
+    *pValue = deltaData[*pPosition];
+    (*pPosition)++;
+    return true;
+}
+
+bool VcdiffDecoder::ReadInteger(size_t *pPosition, size_t end, size_t *pValue)
+{
+    // Integers are stored big-endian in base 128, with the high bit set on every byte but the last.
+    size_t value = 0;
+    byte currentByte = 0;
+
+    do
+    {
+        if (!ReadByte(pPosition, end, &currentByte) || value > (((size_t)-1) >> 7))
+        {
+            return false;
+        }
+
+        value = (value << 7) | (currentByte & 0x7F);
+    } while ((currentByte & 0x80) != 0);
+
+    *pValue = value;
+    return true;
+}
+
+bool VcdiffDecoder::DecodeAddress(size_t here, byte mode, size_t *pAddress)
+{
+    size_t address = 0;
+
+    if (mode == 0)
+    {
+        // VCD_SELF - the address is stored as-is.
+        if (!ReadInteger(&addressPosition, addressEnd, &address))
+        {
+            return false;
+        }
+    }
+    else if (mode == 1)
+    {
+        // VCD_HERE - the address is stored relative to the current position.
+        size_t offset = 0;
+
+        if (!ReadInteger(&addressPosition, addressEnd, &offset) || offset > here)
+        {
+            return false;
+        }
+
+        address = here - offset;
+    }
+    else if (mode < 2 + VcdiffNearCacheSize)
+    {
+        size_t offset = 0;
+
+        if (!ReadInteger(&addressPosition, addressEnd, &offset))
+        {
+            return false;
+        }
+
+        address = nearAddressCache[mode - 2] + offset;
+    }
+    else if (mode < 2 + VcdiffNearCacheSize + VcdiffSameCacheSize)
+    {
+        byte sameIndex = 0;
+
+        if (!ReadByte(&addressPosition, addressEnd, &sameIndex))
+        {
+            return false;
+        }
+
+        address = sameAddressCache[(mode - (2 + VcdiffNearCacheSize)) * 256 + sameIndex];
+    }
+    else
+    {
+        return false;
+    }
+
+    nearAddressCache[nextNearAddressSlot] = address;
+    nextNearAddressSlot = (nextNearAddressSlot + 1) % VcdiffNearCacheSize;
+    sameAddressCache[address % (VcdiffSameCacheSize * 256)] = address;
+
+    *pAddress = address;
+    return true;
+}
+
+void VcdiffDecoder::ResetAddressCache()
+{
+    for (unsigned int i = 0; i < VcdiffNearCacheSize; i++)
+    {
+        nearAddressCache[i] = 0;
+    }
+
+    for (unsigned int i = 0; i < VcdiffSameCacheSize * 256; i++)
+    {
+        sameAddressCache[i] = 0;
+    }
+
+    nextNearAddressSlot = 0;
+}
+
+void VcdiffDecoder::BuildDefaultCodeTable(CodeTableEntry codeTable[])
+{
+    // This is the default instruction code table from section 5.6 of RFC 3284.
+    const byte ModeCount = 2 + VcdiffNearCacheSize + VcdiffSameCacheSize;
+    unsigned int index = 0;
+
+    memset(codeTable, 0, sizeof(CodeTableEntry) * 256);
+
+    // RUN with its size in the instruction section.
+    codeTable[index].type1 = InstructionTypeRun;
+    index++;
+
+    // ADD of size 0 (size follows) and sizes 1 through 17.
+    for (byte size = 0; size <= 17; size++)
+    {
+        codeTable[index].type1 = InstructionTypeAdd;
+        codeTable[index].size1 = size;
+        index++;
+    }
+
+    // COPY of size 0 (size follows) and sizes 4 through 18, in each mode.
+    for (byte mode = 0; mode < ModeCount; mode++)
+    {
+        codeTable[index].type1 = InstructionTypeCopy;
+        codeTable[index].mode1 = mode;
+        index++;
+
+        for (byte size = 4; size <= 18; size++)
+        {
+            codeTable[index].type1 = InstructionTypeCopy;
+            codeTable[index].size1 = size;
+            codeTable[index].mode1 = mode;
+            index++;
+        }
+    }
+
+    // ADD of sizes 1 through 4 followed by COPY of sizes 4 through 6, in the first six modes.
+    for (byte mode = 0; mode < 6; mode++)
+    {
+        for (byte addSize = 1; addSize <= 4; addSize++)
+        {
+            for (byte copySize = 4; copySize <= 6; copySize++)
+            {
+                codeTable[index].type1 = InstructionTypeAdd;
+                codeTable[index].size1 = addSize;
+                codeTable[index].type2 = InstructionTypeCopy;
+                codeTable[index].size2 = copySize;
+                codeTable[index].mode2 = mode;
+                index++;
+            }
+        }
+    }
+
+    // ADD of sizes 1 through 4 followed by COPY of size 4, in the same-cache modes.
+    for (byte mode = 6; mode < ModeCount; mode++)
+    {
+        for (byte addSize = 1; addSize <= 4; addSize++)
+        {
+            codeTable[index].type1 = InstructionTypeAdd;
+            codeTable[index].size1 = addSize;
+            codeTable[index].type2 = InstructionTypeCopy;
+            codeTable[index].size2 = 4;
+            codeTable[index].mode2 = mode;
+            index++;
+        }
+    }
+
+    // COPY of size 4 in each mode followed by ADD of size 1.
+    for (byte mode = 0; mode < ModeCount; mode++)
+    {
+        codeTable[index].type1 = InstructionTypeCopy;
+        codeTable[index].size1 = 4;
+        codeTable[index].mode1 = mode;
+        codeTable[index].type2 = InstructionTypeAdd;
+        codeTable[index].size2 = 1;
+        index++;
+    }
+}
+
+unsigned int VcdiffDecoder::ComputeAdler32(const vector<byte> &data)
+{
+    unsigned int a = 1;
+    unsigned int b = 0;
+
+    for (size_t i = 0; i < data.size(); i++)
+    {
+        a = (a + data[i]) % Adler32Modulus;
+        b = (b + a) % Adler32Modulus;
+    }
+
+    return (b << 16) | a;
+}
+
+#endif
@@ -0,0 +1,119 @@
+/**
+ * Basic header/include file for VcdiffDecoder.cpp.
+ *
+ * @author GabuEx, dawnmew
+ * @since 1.0.7
+ *
+ * Licensed under the MIT License.
+ *
+ * Copyright (c) 2014 Equestrian Dreamers
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef VCDIFFDECODER_H
+#define VCDIFFDECODER_H
+
+#ifdef UPDATER
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+typedef unsigned char byte;
+
+using namespace std;
+
+const unsigned int VcdiffNearCacheSize = 4;
+const unsigned int VcdiffSameCacheSize = 3;
+
+enum VcdiffResult
+{
+    VcdiffResultSucceeded,
+    VcdiffResultUnsupported,
+    VcdiffResultFailed,
+};
+
+class VcdiffDecoder
+{
+public:
+    static VcdiffResult ApplyDelta(const string &sourceFilePath, const string &deltaFilePath, const string &targetFilePath);
+
+private:
+    enum InstructionType
+    {
+        InstructionTypeNoOp = 0,
+        InstructionTypeAdd = 1,
+        InstructionTypeRun = 2,
+        InstructionTypeCopy = 3,
+    };
+
+    class CodeTableEntry
+    {
+    public:
+        byte type1;
+        byte size1;
+        byte mode1;
+        byte type2;
+        byte size2;
+        byte mode2;
+    };
+
+    VcdiffDecoder(FILE *pSourceFile, FILE *pTargetFile);
+
+    VcdiffResult Decode();
+    VcdiffResult DecodeWindow();
+    bool ExecuteInstruction(byte type, size_t size, byte mode, size_t sourceSegmentLength, size_t targetWindowLength);
+
+    bool ReadByte(size_t *pPosition, size_t end, byte *pValue);
+    bool ReadInteger(size_t *pPosition, size_t end, size_t *pValue);
+    bool DecodeAddress(size_t here, byte mode, size_t *pAddress);
+    void ResetAddressCache();
+
+    static int SeekFile(FILE *pFile, long long offset, int origin);
+    static long long TellFile(FILE *pFile);
+    static void BuildDefaultCodeTable(CodeTableEntry codeTable[]);
+    static unsigned int ComputeAdler32(const vector<byte> &data);
+
+    FILE *pSourceFile;
+    FILE *pTargetFile;
+
+    vector<byte> deltaData;
+    size_t deltaPosition;
+
+    vector<byte> sourceSegment;
+    vector<byte> targetWindow;
+
+    size_t dataPosition;
+    size_t dataEnd;
+    size_t instructionPosition;
+    size_t instructionEnd;
+    size_t addressPosition;
+    size_t addressEnd;
+
+    CodeTableEntry codeTable[256];
+
+    size_t nearAddressCache[VcdiffNearCacheSize];
+    unsigned int nextNearAddressSlot;
+    size_t sameAddressCache[VcdiffSameCacheSize * 256];
+};
+
+#endif
+
+#endif
@@ -29,9 +29,11 @@
 
 #include "Video.h"
 #include "globals.h"
+#include "Profiler.h"
 #include "ResourceLoader.h"
 #include "CaseInformation/Case.h"
 #include "XmlReader.h"
+#include <algorithm>
 #include <math.h>
 
 #if LIBAVUTIL_VERSION_INT < AV_VERSION_INT(51,42,0)
@@ -48,7 +50,14 @@
 #define av_frame_free avcodec_free_frame
 #endif
 
-const string CommonFilesId = "CommonFiles";
+const unsigned int MaxOpenDecoderCount = 6;
+const Uint32 MinFramesUndrawnBeforeDecoderClose = 5; // frames
+const Uint32 MinFramesUndrawnBeforeTextureRelease = 30; // frames
+const int MaxFramesDecodedToCatchUp = 10; // frames
+
+vector<Video *> Video::loadedVideoList;
+SDL_sem *Video::pLoadedVideoListSemaphore = SDL_CreateSemaphore(1);
+Uint32 Video::currentFrame = 0;
 
 bool IsYUVFormat(AVPixelFormat pixelFormat)
 {
@@ -70,10 +79,13 @@ Video::Video(bool shouldLoop)
     pFrame = NULL;
     pMemToFree = NULL;
     pImageConvertContext = NULL;
-    pCachedTexturePixels = NULL;
-    pTexture = NULL;
+    isYUVFormat = false;
+
+    writtenFrameIndex = -1;
+    decoderFrameIndex = 0;
 
-    this->texturesRecreatedCount = gTexturesRecreatedCount;
+    pTexture = NULL;
+    lastDrawnFrame = 0;
 }
 
 Video::Video(XmlReader *pReader)
@@ -90,10 +102,13 @@ Video::Video(XmlReader *pReader)
     pFrame = NULL;
     pMemToFree = NULL;
     pImageConvertContext = NULL;
-    pCachedTexturePixels = NULL;
-    pTexture = NULL;
+    isYUVFormat = false;
+
+    writtenFrameIndex = -1;
+    decoderFrameIndex = 0;
 
-    this->texturesRecreatedCount = gTexturesRecreatedCount;
+    pTexture = NULL;
+    lastDrawnFrame = 0;
 
     pReader->StartElement("Video");
     id = pReader->ReadTextElement("Id");
@@ -194,27 +209,22 @@ void Video::Draw(const Vector2 &position, bool flipHorizontally, const Color &co
         return;
     }
 
+    lastDrawnFrame = currentFrame;
+
+    // We only decode frames when we actually need to show them,
+    // so videos that aren't being drawn don't cost us anything.
+    if (!EnsureCurrentFrameWritten())
+    {
+        return;
+    }
+
     Image::Draw(pTexture, position, clipRect, flipHorizontally, false /* flipVertically */, 1.0 /* scale */, 1.0 /* scale */, color);
 }
 
 void Video::Reset()
 {
-    bool shouldRewriteFrame = curFrameIndex > 0 || texturesRecreatedCount != gTexturesRecreatedCount;
-
     curFrameIndex = 0;
     pCurFrame = frameList[0];
-
-    if (pFormatContext != NULL)
-    {
-        av_seek_frame(pFormatContext, videoStream, 0, AVSEEK_FLAG_ANY);
-
-        if (shouldRewriteFrame)
-        {
-            WriteNextFrame();
-        }
-    }
-
-    texturesRecreatedCount = gTexturesRecreatedCount;
 }
 
 void Video::Finish()
@@ -238,42 +248,14 @@ void Video::LoadFile()
 {
     if (!isReady)
     {
-        ResourceLoader::GetInstance()->LoadVideo(
-            videoRelativeFilePath,
-            &pRWOpsIOContext,
-            &pFormatContext,
-            &videoStream,
-            &pCodecContext,
-            &pCodec,
-            &pMemToFree);
-
-        pFrame = av_frame_alloc();
-
-        pImageConvertContext =
-            sws_getContext(
-                width,
-                height,
-                pCodecContext->pix_fmt == AV_PIX_FMT_BGRA ? AV_PIX_FMT_ARGB : pCodecContext->pix_fmt,
-                width,
-                height,
-                IsYUVFormat(pCodecContext->pix_fmt) ? AV_PIX_FMT_YUV420P : AV_PIX_FMT_ARGB,
-                SWS_BICUBIC,
-                NULL,
-                NULL,
-                NULL);
-
-        pTexture =
-            SDL_CreateTexture(
-                gpRenderer,
-                IsYUVFormat(pCodecContext->pix_fmt) ? SDL_PIXELFORMAT_YV12 : SDL_PIXELFORMAT_ARGB8888,
-                SDL_TEXTUREACCESS_STREAMING,
-                width,
-                height);
-        SDL_SetTextureBlendMode(pTexture, SDL_BLENDMODE_BLEND);
+        SDL_SemWait(pLoadedVideoListSemaphore);
+        loadedVideoList.push_back(this);
+        SDL_SemPost(pLoadedVideoListSemaphore);
 
-        pCachedTexturePixels = new unsigned char[width * height * 4];
-
-        WriteNextFrame();
+        // We'll count this as having just been drawn so that
+        // opening other decoders doesn't immediately push this one out of the pool.
+        lastDrawnFrame = currentFrame;
+        OpenDecoder();
 
         isReady = true;
     }
@@ -285,61 +267,73 @@ void Video::UnloadFile()
     {
         isReady = false;
 
-        delete[] pCachedTexturePixels;
-        pCachedTexturePixels = NULL;
+        SDL_SemWait(pLoadedVideoListSemaphore);
+        loadedVideoList.erase(find(loadedVideoList.begin(), loadedVideoList.end(), this));
+        CloseDecoder();
+        SDL_SemPost(pLoadedVideoListSemaphore);
+
         SDL_DestroyTexture(pTexture);
         pTexture = NULL;
-        sws_freeContext(pImageConvertContext);
-        pImageConvertContext = NULL;
-        av_frame_free(&pFrame);
-        avcodec_close(pCodecContext);
-        pCodecContext = NULL;
-        avformat_close_input(&pFormatContext);
-        delete pRWOpsIOContext;
-        pRWOpsIOContext = NULL;
-        free(pMemToFree);
-        pMemToFree = NULL;
+        writtenFrameIndex = -1;
     }
 }
 
-bool Video::IsReady()
-{
-    return pCurFrame != NULL;
-}
-
-bool Video::IsFinished() const
-{
-    return curFrameIndex == frameList.size();
-}
-
-void Video::UpdateReadiness(const string &newLocationId, bool *pLoadFrames, bool *pDeleteFrames)
+void Video::ReleaseIdleTextures()
 {
-    vector<string> parentLocationList = Case::GetInstance()->GetParentLocationListForVideoId(id);
-    bool isNeeded = false;
+    currentFrame++;
 
-    *pLoadFrames = false;
-    *pDeleteFrames = false;
+    SDL_SemWait(pLoadedVideoListSemaphore);
 
-    for (unsigned int i = 0; i < parentLocationList.size(); i++)
+    for (unsigned int i = 0; i < loadedVideoList.size(); i++)
     {
-        if (parentLocationList[i] == newLocationId ||
-            parentLocationList[i] == CommonFilesId ||
-            parentLocationList[i] == Case::GetInstance()->GetPartnerManager()->GetCurrentPartnerId())
+        Video *pVideo = loadedVideoList[i];
+
+        if (pVideo->pTexture != NULL && currentFrame - pVideo->lastDrawnFrame >= MinFramesUndrawnBeforeTextureRelease)
         {
-            isNeeded = true;
+            SDL_DestroyTexture(pVideo->pTexture);
+            pVideo->pTexture = NULL;
+            pVideo->writtenFrameIndex = -1;
         }
     }
 
-    bool isReady = IsAnimationReady();
+    // If we had to go over the decoder limit because too many videos were being drawn at once,
+    // then we'll come back down to it as those videos stop being drawn.
+    CloseIdleDecoders(MaxOpenDecoderCount, NULL);
 
-    if (isNeeded && !isReady)
-    {
-        *pLoadFrames = true;
-    }
-    else if (!isNeeded && isReady)
+    SDL_SemPost(pLoadedVideoListSemaphore);
+}
+
+void Video::GetStatisticsList(vector<Statistics> *pStatisticsList)
+{
+    pStatisticsList->clear();
+
+    SDL_SemWait(pLoadedVideoListSemaphore);
+
+    for (unsigned int i = 0; i < loadedVideoList.size(); i++)
     {
-        *pDeleteFrames = true;
+        Video *pVideo = loadedVideoList[i];
+        Statistics statistics;
+
+        statistics.name = pVideo->id.length() > 0 ? pVideo->id : pVideo->videoRelativeFilePath;
+        statistics.width = pVideo->width;
+        statistics.height = pVideo->height;
+        statistics.textureByteCount = pVideo->pTexture != NULL ? pVideo->GetTextureByteCount() : 0;
+        statistics.hasDecoder = pVideo->pFormatContext != NULL;
+
+        pStatisticsList->push_back(statistics);
     }
+
+    SDL_SemPost(pLoadedVideoListSemaphore);
+}
+
+bool Video::IsReady()
+{
+    return pCurFrame != NULL;
+}
+
+bool Video::IsFinished() const
+{
+    return curFrameIndex == frameList.size();
 }
 
 bool Video::IsAnimationReady()
@@ -447,45 +441,246 @@ void Video::MoveToNextFrame()
     if (IsFinished() && shouldLoop)
     {
         curFrameIndex = 0;
-        av_seek_frame(pFormatContext, videoStream, 0, AVSEEK_FLAG_ANY);
     }
 
     if (!IsFinished())
     {
         pCurFrame = frameList[curFrameIndex];
         pCurFrame->Begin(overflowDuration);
+    }
+}
+
+bool Video::OpenDecoder()
+{
+    // Decoders hold onto a fair bit of memory, so we'll only keep a limited number of them open at once.
+    // If we're at that limit, then we'll make room for this one.
+    SDL_SemWait(pLoadedVideoListSemaphore);
+    CloseIdleDecoders(MaxOpenDecoderCount - 1, this);
+    SDL_SemPost(pLoadedVideoListSemaphore);
+
+    ResourceLoader::GetInstance()->LoadVideo(
+        videoRelativeFilePath,
+        &pRWOpsIOContext,
+        &pFormatContext,
+        &videoStream,
+        &pCodecContext,
+        &pCodec,
+        &pMemToFree);
 
-        WriteNextFrame();
+    if (pCodecContext == NULL)
+    {
+        return false;
     }
+
+    isYUVFormat = IsYUVFormat(pCodecContext->pix_fmt);
+    pFrame = av_frame_alloc();
+
+    pImageConvertContext =
+        sws_getContext(
+            width,
+            height,
+            pCodecContext->pix_fmt == AV_PIX_FMT_BGRA ? AV_PIX_FMT_ARGB : pCodecContext->pix_fmt,
+            width,
+            height,
+            isYUVFormat ? AV_PIX_FMT_YUV420P : AV_PIX_FMT_ARGB,
+            SWS_BICUBIC,
+            NULL,
+            NULL,
+            NULL);
+
+    decoderFrameIndex = 0;
+    return true;
 }
 
-void Video::WriteNextFrame()
+void Video::CloseDecoder()
 {
-    int frameFinished = 0;
-    AVPacket packet;
+    if (pFormatContext == NULL)
+    {
+        return;
+    }
+
+    sws_freeContext(pImageConvertContext);
+    pImageConvertContext = NULL;
+    av_frame_free(&pFrame);
+    avcodec_close(pCodecContext);
+    pCodecContext = NULL;
+    avformat_close_input(&pFormatContext);
+    delete pRWOpsIOContext;
+    pRWOpsIOContext = NULL;
+    free(pMemToFree);
+    pMemToFree = NULL;
+}
 
-    if (texturesRecreatedCount != gTexturesRecreatedCount)
+void Video::CloseIdleDecoders(unsigned int maxOpenDecoderCount, Video *pVideoToKeep)
+{
+    // We close the decoders belonging to whichever videos have gone the longest without being drawn,
+    // until we're within the limit.  They'll be reopened if those videos are drawn again.
+    // Videos drawn within the last few frames keep their decoders even if that leaves us over the limit,
+    // since otherwise drawing more videos at once than the limit allows would close and reopen decoders every frame.
+    // The caller needs to hold the loaded video list semaphore.
+    while (true)
     {
-        texturesRecreatedCount = gTexturesRecreatedCount;
+        unsigned int openDecoderCount = 0;
+        Video *pLeastRecentlyDrawnVideo = NULL;
 
-        SDL_DestroyTexture(pTexture);
+        for (unsigned int i = 0; i < loadedVideoList.size(); i++)
+        {
+            Video *pVideo = loadedVideoList[i];
+
+            if (pVideo == pVideoToKeep || pVideo->pFormatContext == NULL)
+            {
+                continue;
+            }
+
+            openDecoderCount++;
+
+            if (pLeastRecentlyDrawnVideo == NULL || pVideo->lastDrawnFrame < pLeastRecentlyDrawnVideo->lastDrawnFrame)
+            {
+                pLeastRecentlyDrawnVideo = pVideo;
+            }
+        }
+
+        if (openDecoderCount <= maxOpenDecoderCount ||
+            pLeastRecentlyDrawnVideo == NULL ||
+            currentFrame - pLeastRecentlyDrawnVideo->lastDrawnFrame < MinFramesUndrawnBeforeDecoderClose)
+        {
+            break;
+        }
+
+        pLeastRecentlyDrawnVideo->CloseDecoder();
+    }
+}
+
+bool Video::EnsureCurrentFrameWritten()
+{
+    if (!isReady)
+    {
+        return false;
+    }
+
+    if (pTexture != NULL && writtenFrameIndex == (int)curFrameIndex)
+    {
+        return true;
+    }
+
+    if (pFormatContext == NULL && !OpenDecoder())
+    {
+        return false;
+    }
+
+    if (pTexture == NULL)
+    {
         pTexture =
             SDL_CreateTexture(
                 gpRenderer,
-                IsYUVFormat(pCodecContext->pix_fmt) ? SDL_PIXELFORMAT_YV12 : SDL_PIXELFORMAT_ARGB8888,
+                isYUVFormat ? SDL_PIXELFORMAT_YV12 : SDL_PIXELFORMAT_ARGB8888,
                 SDL_TEXTUREACCESS_STREAMING,
                 width,
                 height);
         SDL_SetTextureBlendMode(pTexture, SDL_BLENDMODE_BLEND);
 
-        unsigned char *pPixels = NULL;
-        int pitch = 0;
+        writtenFrameIndex = -1;
+    }
+
+    // If the decoder is already past the frame we want, then we've looped or been reset,
+    // so we need to go back to the start.
+    if (decoderFrameIndex > (int)curFrameIndex)
+    {
+        av_seek_frame(pFormatContext, videoStream, 0, AVSEEK_FLAG_ANY);
+        avcodec_flush_buffers(pCodecContext);
+        decoderFrameIndex = 0;
+    }
+
+    // If we've fallen a long way behind, such as when a video is drawn again after going a while without being drawn,
+    // then we'll seek to the last keyframe before the frame we want rather than decoding every frame in between.
+    if ((int)curFrameIndex - decoderFrameIndex > MaxFramesDecodedToCatchUp && SeekToFrame(curFrameIndex))
+    {
+        WriteDecodedFrame();
+        writtenFrameIndex = curFrameIndex;
+        return true;
+    }
+
+    // Frames that went by while we weren't being drawn still have to go through the decoder,
+    // but there's no need to convert them or upload them to the texture.
+    while (decoderFrameIndex < (int)curFrameIndex && DecodeNextFrame())
+    {
+        decoderFrameIndex++;
+    }
+
+    if (DecodeNextFrame())
+    {
+        decoderFrameIndex++;
+        WriteDecodedFrame();
+    }
+
+    writtenFrameIndex = curFrameIndex;
+    return true;
+}
+
+bool Video::SeekToFrame(unsigned int frameIndex)
+{
+    Profiler::Zone zone("Video::SeekToFrame");
+
+    AVStream *pStream = pFormatContext->streams[videoStream];
+    AVRational frameDuration = av_inv_q(pStream->r_frame_rate);
+    int64_t startTimestamp = pStream->start_time != AV_NOPTS_VALUE ? pStream->start_time : 0;
+
+    // Without a frame rate, we have no way to tell which frame a timestamp belongs to.
+    if (frameDuration.num <= 0 || frameDuration.den <= 0)
+    {
+        return false;
+    }
+
+    int64_t targetTimestamp = startTimestamp + av_rescale_q(frameIndex, frameDuration, pStream->time_base);
+
+    if (av_seek_frame(pFormatContext, videoStream, targetTimestamp, AVSEEK_FLAG_BACKWARD) < 0)
+    {
+        return false;
+    }
+
+    avcodec_flush_buffers(pCodecContext);
+
+    // The seek leaves us at a keyframe at or before the frame we want,
+    // so we decode forward from there until we reach it.
+    while (DecodeNextFrame())
+    {
+        int64_t timestamp = av_frame_get_best_effort_timestamp(pFrame);
+
+        if (timestamp == AV_NOPTS_VALUE)
+        {
+            break;
+        }
+
+        int decodedFrameIndex = (int)av_rescale_q(timestamp - startTimestamp, pStream->time_base, frameDuration);
 
-        SDL_LockTexture(pTexture, NULL, reinterpret_cast<void **>(&pPixels), &pitch);
-        memcpy(pPixels, pCachedTexturePixels, pitch * height);
-        SDL_UnlockTexture(pTexture);
+        if (decodedFrameIndex >= (int)frameIndex)
+        {
+            decoderFrameIndex = frameIndex + 1;
+            return true;
+        }
     }
 
+    // If we couldn't tell where we ended up, then we'll go back to the start,
+    // and let the caller decode its way forward from there.
+    av_seek_frame(pFormatContext, videoStream, 0, AVSEEK_FLAG_ANY);
+    avcodec_flush_buffers(pCodecContext);
+    decoderFrameIndex = 0;
+    return false;
+}
+
+unsigned int Video::GetTextureByteCount() const
+{
+    // YV12 has a full-size luma plane and two quarter-size chroma planes.
+    return isYUVFormat ? width * height * 3 / 2 : width * height * 4;
+}
+
+bool Video::DecodeNextFrame()
+{
+    Profiler::Zone zone("Video::DecodeNextFrame");
+
+    int frameFinished = 0;
+    AVPacket packet;
+
     while (!frameFinished)
     {
         if (av_read_frame(pFormatContext, &packet) != 0)
@@ -493,79 +688,84 @@ void Video::WriteNextFrame()
             break;
         }
 
-        if (packet.stream_index == videoStream && avcodec_decode_video2(pCodecContext, pFrame, &frameFinished, &packet) >= 0)
+        if (packet.stream_index == videoStream)
         {
-            if (frameFinished)
-            {
-                AVPicture picture;
-                unsigned char *pPixels = NULL;
-                int pitch = 0;
-
-                SDL_LockTexture(pTexture, NULL, reinterpret_cast<void **>(&pPixels), &pitch);
-
-                if (IsYUVFormat(pCodecContext->pix_fmt))
-                {
-                    picture.data[0] = pFrame->data[0];
-                    picture.data[1] = pFrame->data[1];
-                    picture.data[2] = pFrame->data[2];
-                    picture.linesize[0] = pFrame->linesize[0];
-                    picture.linesize[1] = pFrame->linesize[1];
-                    picture.linesize[2] = pFrame->linesize[2];
-                }
-                else
-                {
-                    picture.data[0] = pPixels;
-                    picture.linesize[0] = pitch;
-                }
-
-                sws_scale(pImageConvertContext, pFrame->data, pFrame->linesize, 0, pFrame->height, picture.data, picture.linesize);
-
-                if (IsYUVFormat(pCodecContext->pix_fmt))
-                {
-                    if (pitch == picture.linesize[0])
-                    {
-                        int size = pitch * pFrame->height;
-
-                        memcpy(pPixels, picture.data[0], size);
-                        memcpy(pPixels + size, picture.data[2], size / 4);
-                        memcpy(pPixels + size * 5 / 4, picture.data[1], size / 4);
-                    }
-                    else
-                    {
-                        unsigned char *y1, *y2, *y3, *i1, *i2, *i3;
-                        y1 = pPixels;
-                        y3 = pPixels + pitch * pFrame->height;
-                        y2 = pPixels + pitch * pFrame->height * 5 / 4;
-
-                        i1 = picture.data[0];
-                        i2 = picture.data[1];
-                        i3 = picture.data[2];
-
-                        for (int i = 0; i < pFrame->height / 2; i++)
-                        {
-                            memcpy(y1, i1, pitch);
-                            i1 += picture.linesize[0];
-                            y1 += pitch;
-                            memcpy(y1, i1, pitch);
-
-                            memcpy(y2, i2, pitch / 2);
-                            memcpy(y3, i3, pitch / 2);
-
-                            y1 += pitch;
-                            y2 += pitch / 2;
-                            y3 += pitch / 2;
-                            i1 += picture.linesize[0];
-                            i2 += picture.linesize[1];
-                            i3 += picture.linesize[2];
-                        }
-                    }
-                }
-
-                memcpy(pCachedTexturePixels, pPixels, pitch * height);
-                SDL_UnlockTexture(pTexture);
-            }
+            avcodec_decode_video2(pCodecContext, pFrame, &frameFinished, &packet);
         }
 
         av_free_packet(&packet);
     }
+
+    return frameFinished != 0;
+}
+
+void Video::WriteDecodedFrame()
+{
+    Profiler::Zone zone("Video::WriteDecodedFrame");
+
+    AVPicture picture;
+    unsigned char *pPixels = NULL;
+    int pitch = 0;
+
+    SDL_LockTexture(pTexture, NULL, reinterpret_cast<void **>(&pPixels), &pitch);
+
+    if (isYUVFormat)
+    {
+        picture.data[0] = pFrame->data[0];
+        picture.data[1] = pFrame->data[1];
+        picture.data[2] = pFrame->data[2];
+        picture.linesize[0] = pFrame->linesize[0];
+        picture.linesize[1] = pFrame->linesize[1];
+        picture.linesize[2] = pFrame->linesize[2];
+    }
+    else
+    {
+        picture.data[0] = pPixels;
+        picture.linesize[0] = pitch;
+    }
+
+    sws_scale(pImageConvertContext, pFrame->data, pFrame->linesize, 0, pFrame->height, picture.data, picture.linesize);
+
+    if (isYUVFormat)
+    {
+        if (pitch == picture.linesize[0])
+        {
+            int size = pitch * pFrame->height;
+
+            memcpy(pPixels, picture.data[0], size);
+            memcpy(pPixels + size, picture.data[2], size / 4);
+            memcpy(pPixels + size * 5 / 4, picture.data[1], size / 4);
+        }
+        else
+        {
+            unsigned char *y1, *y2, *y3, *i1, *i2, *i3;
+            y1 = pPixels;
+            y3 = pPixels + pitch * pFrame->height;
+            y2 = pPixels + pitch * pFrame->height * 5 / 4;
+
+            i1 = picture.data[0];
+            i2 = picture.data[1];
+            i3 = picture.data[2];
+
+            for (int i = 0; i < pFrame->height / 2; i++)
+            {
+                memcpy(y1, i1, pitch);
+                i1 += picture.linesize[0];
+                y1 += pitch;
+                memcpy(y1, i1, pitch);
+
+                memcpy(y2, i2, pitch / 2);
+                memcpy(y3, i3, pitch / 2);
+
+                y1 += pitch;
+                y2 += pitch / 2;
+                y3 += pitch / 2;
+                i1 += picture.linesize[0];
+                i2 += picture.linesize[1];
+                i3 += picture.linesize[2];
+            }
+        }
+    }
+
+    SDL_UnlockTexture(pTexture);
 }
@@ -77,9 +77,24 @@ public:
     bool IsReady();
     bool IsFinished() const;
 
-    void UpdateReadiness(const string &newLocationId, bool *pLoadFile, bool *pDeleteFile);
     bool IsAnimationReady();
 
+    // Called once per frame.  Videos that haven't been drawn in a while give up their textures,
+    // which will be created again the next time they're drawn.
+    static void ReleaseIdleTextures();
+
+    class Statistics
+    {
+    public:
+        string name;
+        unsigned int width;
+        unsigned int height;
+        unsigned int textureByteCount;
+        bool hasDecoder;
+    };
+
+    static void GetStatisticsList(vector<Statistics> *pStatisticsList);
+
     class Frame
     {
         friend class Video;
@@ -113,7 +128,19 @@ public:
 
 private:
     void MoveToNextFrame();
-    void WriteNextFrame();
+
+    bool OpenDecoder();
+    void CloseDecoder();
+    static void CloseIdleDecoders(unsigned int maxOpenDecoderCount, Video *pVideoToKeep);
+    bool EnsureCurrentFrameWritten();
+    bool SeekToFrame(unsigned int frameIndex);
+    bool DecodeNextFrame();
+    void WriteDecodedFrame();
+    unsigned int GetTextureByteCount() const;
+
+    static vector<Video *> loadedVideoList;
+    static SDL_sem *pLoadedVideoListSemaphore;
+    static Uint32 currentFrame;
 
     string id;
     string videoRelativeFilePath;
@@ -135,11 +162,15 @@ private:
     AVFrame *pFrame;
     void *pMemToFree;
     SwsContext *pImageConvertContext;
+    bool isYUVFormat;
 
-    unsigned char *pCachedTexturePixels;
-    SDL_Texture *pTexture;
+    // These are indexes into the frame list - the frame that's currently in the texture,
+    // and the frame that the decoder will give us next.
+    int writtenFrameIndex;
+    int decoderFrameIndex;
 
-    int texturesRecreatedCount;
+    SDL_Texture *pTexture;
+    Uint32 lastDrawnFrame;
 };
 
 #endif
@@ -130,6 +130,22 @@ void XmlReader::ParseXmlContent(const XmlString &xmlContent)
     Init(pDocument);
 }
 
+void XmlReader::ParseXmlFragment(const XmlString &xmlFragment, int formattingVersion)
+{
+    // Fragments saved off by GetCurrentElementXml() don't carry the formatting version
+    // of the document they came from, so the caller supplies it.
+    ParseXmlContent(xmlFragment);
+    this->formattingVersion = formattingVersion;
+}
+
+XmlString XmlReader::GetCurrentElementXml()
+{
+    XMLPrinter printer(NULL, true /* compact */);
+    pCurrentNode->Accept(&printer);
+
+    return XmlString(printer.CStr());
+}
+
 void XmlReader::Init(XMLDocument *pDocument)
 {
     pCurrentNode = dynamic_cast<XMLNode *>(pDocument);
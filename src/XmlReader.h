@@ -50,6 +50,9 @@ public:
 
     void ParseXmlFile(const XmlString &filePath);
     void ParseXmlContent(const XmlString &xmlContent);
+    void ParseXmlFragment(const XmlString &xmlFragment, int formattingVersion);
+
+    XmlString GetCurrentElementXml();
 
 private:
     void Init(tinyxml2::XMLDocument *pDocument);
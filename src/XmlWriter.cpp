@@ -31,6 +31,11 @@
 #include "Utils.h"
 
 #include <fstream>
+#include <stdio.h>
+
+#ifdef __WINDOWS
+#include <windows.h>
+#endif
 
 #ifndef CASE_CREATOR
 #include <cryptopp/base64.h>
@@ -45,7 +50,11 @@
 
 XmlWriter::XmlWriter(const char *pFilePath, const char *pFilePathExtension, bool makeHumanReadable, int formattingVersion)
 {
-    filePath = string(pFilePath);
+    // A writer without a file path just builds up its contents in memory.
+    if (pFilePath != NULL)
+    {
+        filePath = string(pFilePath);
+    }
 
     if (pFilePathExtension != NULL)
     {
@@ -68,6 +77,19 @@ XmlWriter::XmlWriter(const char *pFilePath, const char *pFilePathExtension, bool
 
 XmlWriter::~XmlWriter()
 {
+    if (filePath.length() > 0)
+    {
+        WriteToFile();
+    }
+}
+
+bool XmlWriter::WriteToFile()
+{
+    if (filePath.length() == 0)
+    {
+        return false;
+    }
+
     string fileContents = stringStream.str();
     string fullFilePath = filePath;
 
@@ -83,10 +105,48 @@ XmlWriter::~XmlWriter()
     }
 #endif
 
+#ifndef CASE_CREATOR
+    // We write to a temporary file first and then move it into place,
+    // so a crash or power loss partway through a write never leaves behind a truncated file.
+    string tempFilePath = fullFilePath + ".tmp";
+
+    // We only write the file once, regardless of whether we succeed.
+    filePath = "";
+
+    ofstream fileStream;
+    fileStream.open(tempFilePath.c_str(), ios_base::out | ios_base::trunc);
+    fileStream << fileContents;
+    fileStream.close();
+
+    if (fileStream.fail())
+    {
+        remove(tempFilePath.c_str());
+        return false;
+    }
+
+#ifdef __WINDOWS
+    bool moveSucceeded = MoveFileExA(tempFilePath.c_str(), fullFilePath.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    bool moveSucceeded = rename(tempFilePath.c_str(), fullFilePath.c_str()) == 0;
+#endif
+
+    // If we couldn't move the file into place, we don't want to leave the temporary file lying around.
+    if (!moveSucceeded)
+    {
+        remove(tempFilePath.c_str());
+    }
+
+    return moveSucceeded;
+#else
+    filePath = "";
+
     ofstream fileStream;
     fileStream.open(fullFilePath.c_str(), ios_base::out | ios_base::trunc);
     fileStream << fileContents;
     fileStream.close();
+
+    return !fileStream.fail();
+#endif
 }
 
 void XmlWriter::StartElement(const XmlString &elementName)
@@ -218,8 +278,16 @@ void XmlWriter::WriteFilePathElement(const XmlString &elementName, const XmlStri
     // so convert this to a relative path before returning it.
     WriteTextElement(elementName, CaseContent::GetInstance()->AbsolutePathToRelativePath(elementValue));
 }
+#endif
 
+XmlString XmlWriter::GetXmlString()
+{
+#ifdef CASE_CREATOR
+    return QString::fromStdString(stringStream.str());
+#else
+    return stringStream.str();
 #endif
+}
 
 #ifndef CASE_CREATOR
 void XmlWriter::WritePngElement(const XmlString &elementName, void *pElementValue, size_t elementSize)
@@ -41,6 +41,10 @@ public:
     XmlWriter(const char *pFilePath, const char *pFilePathExtension = NULL, bool makeHumanReadable = false, int formattingVersion = 1);
     ~XmlWriter();
 
+    // Writes the contents to the file path, if there is one. Returns whether the write succeeded.
+    // If this isn't called explicitly, the contents are written when the writer is destroyed.
+    bool WriteToFile();
+
     void StartElement(const XmlString &elementName);
     void VerifyCurrentElement(const XmlString &expectedElementName);
     void EndElement();
@@ -56,6 +60,8 @@ public:
     void WriteFilePathElement(const XmlString &elementName, const XmlString &elementValue);
 #endif
 
+    XmlString GetXmlString();
+
 private:
     void StartElement(const XmlString &elementName, bool addCarriageReturn);
 
@@ -52,14 +52,17 @@ double gScreenScale = 0.0;
 Uint16 gHorizontalOffset = 0;
 Uint16 gVerticalOffset = 0;
 
-int gTexturesRecreatedCount = 0;
-
 bool gIsSavingScreenshot = false;
 Uint16 gScreenshotWidth = 0;
 Uint16 gScreenshotHeight = 0;
 #endif
 
 double gFramerate = 0.0;
+bool gIsVsyncEnabled = false;
+
+double gUpdateInterpolation = 1.0;
+Uint32 gUpdateStepCount = 0;
+Uint32 gSimulationTimeMs = 0;
 string gTitle = "";
 
 #ifdef GAME_EXECUTABLE
@@ -78,6 +81,9 @@ bool gEnableDebugMode = false;
 double gBackgroundMusicVolume = 0.2;
 double gSoundEffectsVolume = 0.67;
 double gVoiceVolume = 0.5;
+
+int gPrefetchBudgetMegabytes = 64;
+bool gEnableVsync = true;
 #endif
 
 string gLocalizedResourcesFileName = "common_en-US.dat";
@@ -96,7 +102,7 @@ double gVoiceVolumeDefault = gVoiceVolume;
 
 vector<string> gCompletedCaseGuidList;
 map<string, bool> gCaseIsSignedByFilePathMap;
-vector<string> gDialogsSeenList;
+unordered_set<IdHandle> gDialogsSeenSet;
 
 bool gToggleFullscreen = false;
 #else
@@ -45,6 +45,12 @@ extern "C"
 #include <vector>
 #include <map>
 
+#ifdef GAME_EXECUTABLE
+#include "SymbolTable.h"
+
+#include <unordered_set>
+#endif
+
 using namespace std;
 
 extern SDL_Window *gpWindow;
@@ -61,14 +67,22 @@ extern double gScreenScale;
 extern Uint16 gHorizontalOffset;
 extern Uint16 gVerticalOffset;
 
-extern int gTexturesRecreatedCount;
-
 extern bool gIsSavingScreenshot;
 extern Uint16 gScreenshotWidth;
 extern Uint16 gScreenshotHeight;
 #endif
 
 extern double gFramerate;
+extern bool gIsVsyncEnabled;
+
+// How far we are into the next fixed-length update, from 0 to 1, at the time we're drawing.
+// Things that move smoothly can use this to draw themselves between their last two updated positions.
+extern double gUpdateInterpolation;
+extern Uint32 gUpdateStepCount;
+
+// Total milliseconds of game time simulated so far.  Anything that measures time inside an update
+// should use this rather than the wall clock, so that headless runs play out the same every time.
+extern Uint32 gSimulationTimeMs;
 extern string gTitle;
 
 #ifdef GAME_EXECUTABLE
@@ -88,6 +102,10 @@ extern bool gEnableDebugMode;
 extern double gBackgroundMusicVolume;
 extern double gSoundEffectsVolume;
 extern double gVoiceVolume;
+
+// Configuration file items.
+extern int gPrefetchBudgetMegabytes;
+extern bool gEnableVsync;
 #endif
 
 extern string gLocalizedResourcesFileName;
@@ -106,7 +124,7 @@ extern double gVoiceVolumeDefault;
 
 extern vector<string> gCompletedCaseGuidList;
 extern map<string, bool> gCaseIsSignedByFilePathMap;
-extern vector<string> gDialogsSeenList;
+extern unordered_set<IdHandle> gDialogsSeenSet;
 
 extern bool gToggleFullscreen;
 #else
@@ -37,13 +37,20 @@
 #include "KeyboardHelper.h"
 #include "CaseInformation/Case.h"
 #include "CaseInformation/CommonCaseResources.h"
+#include "CaseInformation/DialogCharacterManager.h"
 #endif
 
 #ifdef GAME_EXECUTABLE
+#include "Profiler.h"
 #include "TextInputHelper.h"
+#include "Screens/MLIScreen.h"
 #include <cryptopp/sha.h>
 #endif
 
+#ifdef HEADLESS
+#include "HeadlessRunner.h"
+#endif
+
 #include "ResourceLoader.h"
 
 #ifdef LAUNCHER
@@ -80,6 +87,11 @@ string title = "My Little Investigations Launcher";
 bool ValidateCaseFile(const string &caseFileName, string *pCaseUuid);
 #endif
 
+const double UpdatesPerSecond = 60.0;
+const double FixedUpdateDuration = 1000.0 / UpdatesPerSecond; // ms
+const int MaxUpdatesPerFrame = 5;
+const double FramePacingSleepMargin = 2.0; // ms
+
 int main(int argc, char * argv[])
 {
 #ifdef __OSX
@@ -192,6 +204,15 @@ int main(int argc, char * argv[])
         return 1;
     }
 
+#ifdef HEADLESS
+    // In headless mode, the first argument is the input script to play back
+    // rather than a case file to install.
+    if (!HeadlessRunner::Init(argc > 1 ? string(argv[1]) : ""))
+    {
+        cout << "Couldn't load headless input script " << argv[1] << "." << endl;
+        return 1;
+    }
+#else
     if (argc > 1)
     {
         string caseFileName = string(argv[1]);
@@ -223,6 +244,7 @@ int main(int argc, char * argv[])
         return 0;
     }
 #endif
+#endif
 
 #ifdef GAME_EXECUTABLE
     {
@@ -257,7 +279,24 @@ int main(int argc, char * argv[])
     double now = -1.0f; // Used to temporarily store the current time, for timing-related calculations.
     double lastSecond = 0; // Updated once per second, used to keep track of how long a second actually is. (If now>=(lastSecond+1000), new second.) Used for FPS.
     Uint32 frame = 0; // Keeps track of the number of frames rendered during the current second. Used for FPS calculation later.
-    double remainder = 0.0f; // Keeps track of amount of milliseconds lost to whole number rounding, to ensure a smooth and perfectly-accurate framerate.
+    double updateAccumulator = 0.0; // Milliseconds of real time that the simulation hasn't caught up with yet.
+#ifndef HEADLESS
+    double simulatedTime = 0.0; // Total milliseconds simulated so far. Used to turn our fractional update duration into whole-millisecond deltas that still add up correctly.
+#endif
+    Uint64 performanceFrequency = SDL_GetPerformanceFrequency();
+    Uint64 lastFrameTime = SDL_GetPerformanceCounter(); // Used to measure how long each frame took, using the high-resolution timer.
+    Uint64 nextFrameTime = lastFrameTime; // When we want the next frame to start, if we're pacing frames ourselves.
+
+    // Vsync holds us to the display's refresh rate, so we only need to pace frames ourselves
+    // if we didn't get it, or if we've been asked to run slower than the display refreshes.
+    SDL_DisplayMode displayMode;
+    bool shouldPaceFrames =
+        gFramerate > 0.0 &&
+        (!gIsVsyncEnabled ||
+            SDL_GetWindowDisplayMode(gpWindow, &displayMode) != 0 ||
+            displayMode.refresh_rate <= 0 ||
+            gFramerate < displayMode.refresh_rate);
+
     // Define event handler. Used later to poll the event queue.
     SDL_Event event;
 
@@ -268,22 +307,52 @@ int main(int argc, char * argv[])
     int mouseX = -1;
     int mouseY = -1;
     bool drawCursor = false;
-    bool isReloadingSprites = false;
 #endif
 
     while (!gIsQuitting)
     {
-        int delta = 0;
-        double oldNow = now;
-
         now = (double)SDL_GetTicks();
 
-        // First we calculate how much time has elapsed since the last time through this loop -
-        // this is the value we'll pass into the update pass.
-        if (oldNow >= 0)
+        Uint64 frameTime = SDL_GetPerformanceCounter();
+        double elapsedTime = (frameTime - lastFrameTime) * 1000.0 / performanceFrequency;
+        lastFrameTime = frameTime;
+
+        // The simulation always moves forward in fixed-length updates, regardless of how long frames take,
+        // so that the game plays out the same way at any frame rate.  We'll run however many updates
+        // it takes to catch up with real time, and carry the leftover time into the next frame.
+        updateAccumulator += elapsedTime;
+
+        int updateCount = (int)(updateAccumulator / FixedUpdateDuration);
+
+        // If we've fallen too far behind, then we'll give up on catching up completely -
+        // otherwise, a long stall would be followed by a burst of updates that would just make us fall further behind.
+        if (updateCount > MaxUpdatesPerFrame)
+        {
+            updateCount = MaxUpdatesPerFrame;
+            updateAccumulator = fmod(updateAccumulator, FixedUpdateDuration) + updateCount * FixedUpdateDuration;
+        }
+
+        updateAccumulator -= updateCount * FixedUpdateDuration;
+
+        // We'll draw the state of things at the point partway through the next update that real time has reached.
+        gUpdateInterpolation = updateAccumulator / FixedUpdateDuration;
+
+    #ifdef GAME_EXECUTABLE
+        Profiler::BeginFrame();
+    #endif
+
+    #ifdef HEADLESS
+        // Headless runs advance by exactly one update of a fixed length each frame regardless of how long
+        // the frame actually took, so that the same script always plays out the same way.
+        updateCount = 1;
+        gUpdateInterpolation = 1.0;
+        HeadlessRunner::BeginFrame();
+
+        if (HeadlessRunner::GetIsFinished())
         {
-            delta = (int)(now - oldNow);
+            gIsQuitting = true;
         }
+    #endif
 
     #ifdef GAME_EXECUTABLE
         // If we want to toggle fullscreen, we'll want to do that now -
@@ -345,6 +414,33 @@ int main(int argc, char * argv[])
 
                 case SDL_KEYDOWN:
                 case SDL_KEYUP:
+                    // F5 quick saves while in the game, and F9 quick loads
+                    // (or with shift held, steps back to the quick save before that).
+                    // In debug builds, F3 also toggles the profiler overlay, and F4 dumps what it's recorded
+                    // to a file that can be loaded into chrome://tracing.
+                    if (event.type == SDL_KEYDOWN && event.key.repeat == 0)
+                    {
+                    #ifdef MLI_DEBUG
+                        if (event.key.keysym.sym == SDLK_F3)
+                        {
+                            Profiler::ToggleOverlay();
+                        }
+                        else if (event.key.keysym.sym == SDLK_F4)
+                        {
+                            Profiler::ExportChromeTrace(GetProfilerTraceFilePath());
+                        }
+                    #endif
+
+                        if (event.key.keysym.sym == SDLK_F5 && MLIScreen::GetCurrentScreenId() == GAME_SCREEN_ID && Case::HasInstance())
+                        {
+                            Case::GetInstance()->RequestQuickSave();
+                        }
+                        else if (event.key.keysym.sym == SDLK_F9 && MLIScreen::GetCurrentScreenId() == GAME_SCREEN_ID && Case::HasInstance())
+                        {
+                            Case::GetInstance()->RequestQuickLoad((event.key.keysym.mod & KMOD_SHIFT) != 0);
+                        }
+                    }
+
                     if(TextInputHelper::GetInSession())
                     {
                         TextInputHelper::NotifyKeyState(event.key.keysym.sym, event.key.state);
@@ -386,6 +482,21 @@ int main(int argc, char * argv[])
                 case SDL_TEXTINPUT:
                     TextInputHelper::NotifyTextInput(event.text.text);
                     break;
+
+                case SDL_RENDER_TARGETS_RESET:
+                case SDL_RENDER_DEVICE_RESET:
+                    // The contents of render targets are lost when this happens,
+                    // so we'll need to composite dialog portraits again.
+                    DialogCharacter::ClearPortraitCache();
+
+                    // If the whole device was reset, then we've lost every other texture as well.
+                    // They'll be reloaded in the background as they're drawn,
+                    // so we won't stall while everything comes back.
+                    if (event.type == SDL_RENDER_DEVICE_RESET)
+                    {
+                        Image::ReloadImages();
+                    }
+                    break;
             #endif
 
                 case SDL_QUIT:
@@ -397,6 +508,10 @@ int main(int argc, char * argv[])
         }
 
     #ifdef GAME_EXECUTABLE
+    #ifdef HEADLESS
+        HeadlessRunner::BeginSection(HeadlessSectionResourceLoading);
+    #endif
+
         // If we have any textures that we need to load or delete, let's do so now.
         if (ResourceLoader::GetInstance()->HasImageTexturesToLoad())
         {
@@ -407,52 +522,71 @@ int main(int argc, char * argv[])
             ResourceLoader::GetInstance()->TryRunOneLoadStep();
         }
 
-        // Check if we're still in the process of reloading sprites after a change either to or from fullscreen.
-        // If we are, then we'll just keep going until we're done.
-        if (isReloadingSprites)
+        // Any images that have finished being reloaded in the background just need their textures created.
+        ResourceLoader::GetInstance()->FinishImageReloads();
+
+    #ifdef HEADLESS
+        HeadlessRunner::EndSection(HeadlessSectionResourceLoading);
+    #endif
+
+    #ifdef HEADLESS
+        HeadlessRunner::BeginSection(HeadlessSectionUpdate);
+    #endif
+    #endif
+
+        for (int updateIndex = 0; updateIndex < updateCount && !gIsQuitting; updateIndex++)
         {
-            if (!ResourceLoader::GetInstance()->HasImageTexturesToLoad())
-            {
-                isReloadingSprites = false;
-            }
-            else
-            {
-                continue;
-            }
-        }
+        #ifdef HEADLESS
+            int delta = HeadlessRunner::GetFrameDuration();
+        #else
+            int delta = (int)(simulatedTime + FixedUpdateDuration) - (int)simulatedTime;
+            simulatedTime += FixedUpdateDuration;
+        #endif
 
-        // Update anything having to do with common audio.
-        CommonCaseResources::GetInstance()->GetAudioManager()->Update(delta);
+            gUpdateStepCount++;
+            gSimulationTimeMs += delta;
 
-        // Update the state of the game based on how much time has elapsed since this loop was last executed.
-        MouseHelper::SetCursorType(CursorTypeNormal);
-        MouseHelper::SetMouseOverText("");
+        #ifdef GAME_EXECUTABLE
+            Profiler::NotifyUpdateStep();
 
-        MouseHelper::UpdateTiming();
-        TextInputHelper::Update(delta);
-    #endif
+            // Update anything having to do with common audio.
+            CommonCaseResources::GetInstance()->GetAudioManager()->Update(delta);
 
-        Game::GetInstance()->Update(delta);
+            // Update the state of the game based on how much time has elapsed since this loop was last executed.
+            MouseHelper::SetCursorType(CursorTypeNormal);
+            MouseHelper::SetMouseOverText("");
 
-    #ifdef GAME_EXECUTABLE
-        // Call AppleCursorUpdate and UpdateCursor after updating the game, as otherwise this won't properly take into account
-        // changes to the mouse-over text.
-        MouseHelper::ApplyCursorUpdate();
-        MouseHelper::UpdateCursor(delta);
-    #endif
+            MouseHelper::UpdateTiming();
+            TextInputHelper::Update(delta);
+        #endif
 
-        // If the game is over now, then we should quit.
-        if (Game::GetInstance()->GetIsFinished())
-        {
-            gIsQuitting = true;
+            Game::GetInstance()->Update(delta);
+
+        #ifdef GAME_EXECUTABLE
+            // Call AppleCursorUpdate and UpdateCursor after updating the game, as otherwise this won't properly take into account
+            // changes to the mouse-over text.
+            MouseHelper::ApplyCursorUpdate();
+            MouseHelper::UpdateCursor(delta);
+        #endif
+
+            // If the game is over now, then we should quit.
+            if (Game::GetInstance()->GetIsFinished())
+            {
+                gIsQuitting = true;
+            }
+
+        #ifdef GAME_EXECUTABLE
+            // We should handle any clicks at this point in case we have any.
+            // Anyone who cares will have responded to it by now.
+            MouseHelper::HandleClick();
+            MouseHelper::HandleDoubleClick();
+            KeyboardHelper::UpdateKeyState();
+        #endif
         }
 
-    #ifdef GAME_EXECUTABLE
-        // We should handle any clicks at this point in case we have any.
-        // Anyone who cares will have responded to it by now.
-        MouseHelper::HandleClick();
-        MouseHelper::HandleDoubleClick();
-        KeyboardHelper::UpdateKeyState();
+    #ifdef HEADLESS
+        HeadlessRunner::EndSection(HeadlessSectionUpdate);
+        HeadlessRunner::BeginSection(HeadlessSectionDraw);
     #endif
 
         // Blank the screen before drawing the new frame.
@@ -462,6 +596,10 @@ int main(int argc, char * argv[])
         // Draw the current state of the game to the screen.
         Game::GetInstance()->Draw();
 
+    #ifdef GAME_EXECUTABLE
+        Profiler::Draw();
+    #endif
+
     #ifdef GAME_EXECUTABLE
         if (Game::GetInstance()->GetShowCursor())
         {
@@ -469,6 +607,10 @@ int main(int argc, char * argv[])
         }
     #endif
 
+    #ifdef HEADLESS
+        HeadlessRunner::EndSection(HeadlessSectionDraw);
+    #endif
+
         // Handle FPS calculation every second. (Only in Debug build target, with MLI_DEBUG_NO_FPS not defined.)
         if (now - 1000 >= lastSecond)
         {
@@ -486,41 +628,88 @@ int main(int argc, char * argv[])
             lastSecond = now;
         }
 
+    #ifdef HEADLESS
+        HeadlessRunner::BeginSection(HeadlessSectionPresent);
+    #endif
+
         // Swap the double buffer to display the new frame.
         SDL_RenderPresent(gpRenderer);
 
+    #ifdef HEADLESS
+        HeadlessRunner::EndSection(HeadlessSectionPresent);
+    #endif
+
         // Increment the frame counter (for FPS).
         frame++;
 
-        // Calculate how long it took to execute all of the above, to compensate for the additional delay for framerate regulation.
-        double executionTime = (double)SDL_GetTicks() - now;
+    #ifdef GAME_EXECUTABLE
+        // Now that the frame is out, we'll free up any textures we haven't needed in a while
+        // if we've gone over our texture budget.
+        Image::EnforceTextureBudget();
+        Video::ReleaseIdleTextures();
+
+        // If a save failed in the background, now's when we can tell the player.
+        Case::ReportFailedSaves();
+    #endif
+
+    #ifdef HEADLESS
+        // Headless runs go as fast as they can - there's nobody watching.
+        HeadlessRunner::EndFrame();
+        continue;
+    #endif
 
-        // If we should wait to enforce the desired framerate, do so now.
-        if (gFramerate > 0.0 && executionTime < 1000.0 / gFramerate)
+        if (shouldPaceFrames)
         {
-            double wait = 1000.0 / gFramerate - executionTime;
-            remainder += fmod(wait, 1.0);
+            nextFrameTime += (Uint64)(performanceFrequency / gFramerate);
+
+            Uint64 currentTime = SDL_GetPerformanceCounter();
 
-            if (remainder >= 1.0)
+            if (currentTime >= nextFrameTime)
             {
-                wait += remainder - fmod(remainder, 1.0);
-                remainder = fmod(remainder, 1.0);
-            }
+                // We're running behind, so we'll pace from here on rather than trying to make up for lost time.
+                nextFrameTime = currentTime;
 
-            SDL_Delay((int)wait);
+                // Always wait at least 1 ms - this defers to other threads as needed.
+                SDL_Delay(1);
+            }
+            else
+            {
+                // SDL_Delay() only has millisecond precision and tends to oversleep,
+                // so we'll sleep through most of the wait and then spin on the high-resolution timer for the rest.
+                double waitTime = (nextFrameTime - currentTime) * 1000.0 / performanceFrequency;
+
+                if (waitTime > FramePacingSleepMargin)
+                {
+                    SDL_Delay((Uint32)(waitTime - FramePacingSleepMargin));
+                }
+
+                while (SDL_GetPerformanceCounter() < nextFrameTime)
+                {
+                    SDL_Delay(0);
+                }
+            }
         }
         else
         {
-            // Always wait at least 1 ms - this defers to other threads as needed.
+            // Presenting can return immediately while the window is minimized or hidden, even with vsync,
+            // so we'll still always wait at least 1 ms rather than spin.
             SDL_Delay(1);
         }
     }
 
 #ifdef GAME_EXECUTABLE
+    // Don't exit out from under a save that's still being written.
+    Case::WaitForPendingSaves();
+    Case::ReportFailedSaves();
+
     // The game's done now, so finish it up.
     CommonCaseResources::Close();
 #endif
 
+#ifdef HEADLESS
+    HeadlessRunner::PrintReport();
+#endif
+
     Game::Finish();
     ResourceLoader::Close();
 
@@ -28,13 +28,19 @@
  */
 
 #include "mli_audio.h"
+#include "SymbolTable.h"
 #include <iostream>
 #include <map>
+#include <unordered_map>
 
 using namespace std;
 
-map<string, Mix_Music*> music;
-map<string, Mix_Chunk*> sfx;
+// Music and sound effects come from a fixed set of IDs that are looked up every time one plays,
+// so they're keyed by interned handle. Dialog IDs are unique to each line,
+// so we leave those as strings rather than filling the symbol table with them.
+unordered_map<IdHandle, Mix_Music*> musicPartA;
+unordered_map<IdHandle, Mix_Music*> musicPartB;
+unordered_map<IdHandle, Mix_Chunk*> sfx;
 map<string, Mix_Chunk*> dialog;
 string currentMusic = "";
 string currentMusicToReport = "";
@@ -65,6 +71,13 @@ volatile double ambianceVol = 1.0;
 volatile double ambianceDialogReductionPercentage = 1.0;
 volatile double dialogVol = 1.0;
 
+template <class T>
+T * getAudioFromId(unordered_map<IdHandle, T *> &audioByIdMap, const string &id)
+{
+    typename unordered_map<IdHandle, T *>::iterator iter = audioByIdMap.find(SymbolTable::Find(id));
+    return iter != audioByIdMap.end() ? iter->second : NULL;
+}
+
 void initAudio()
 {
     if (Mix_OpenAudio(44100, AUDIO_S16SYS, 2, 4096) != 0)
@@ -100,7 +113,7 @@ void channelDone(int channel)
 void musicToPartB()
 {
     Mix_HookMusicFinished(NULL);
-    Mix_PlayMusic(music[currentMusic + "_B"], -1);
+    Mix_PlayMusic(getAudioFromId(musicPartB, currentMusic), -1);
 }
 
 bool preloadMusic(const string &id, SDL_RWops *pFileOpsA, SDL_RWops *pFileOpsB)
@@ -114,15 +127,16 @@ bool preloadMusic(const string &id, SDL_RWops *pFileOpsA, SDL_RWops *pFileOpsB)
         Mix_FreeMusic(pMusicA);
         return false;
     }
-    music[id+"_A"] = pMusicA;
-    music[id+"_B"] = pMusicB;
+    IdHandle idHandle = SymbolTable::Intern(id);
+    musicPartA[idHandle] = pMusicA;
+    musicPartB[idHandle] = pMusicB;
     return true;
 }
 
 void unloadMusic(const string &id)
 {
-    Mix_Music *pMusicA = music[id + "_A"];
-    Mix_Music *pMusicB = music[id + "_B"];
+    Mix_Music *pMusicA = getAudioFromId(musicPartA, id);
+    Mix_Music *pMusicB = getAudioFromId(musicPartB, id);
 
     if (pMusicA != NULL)
     {
@@ -134,8 +148,8 @@ void unloadMusic(const string &id)
         Mix_FreeMusic(pMusicB);
     }
 
-    music.erase(id + "_A");
-    music.erase(id + "_B");
+    musicPartA.erase(SymbolTable::Find(id));
+    musicPartB.erase(SymbolTable::Find(id));
 }
 
 bool preloadSound(const string &id, SDL_RWops *pFileOps)
@@ -144,20 +158,20 @@ bool preloadSound(const string &id, SDL_RWops *pFileOps)
     Mix_Chunk *pSound = Mix_LoadWAV_RW(pFileOps, 1);
     if(pSound == NULL) return false;
     Mix_VolumeChunk(pSound, (int)(soundVol * MIX_MAX_VOLUME));
-    sfx[id] = pSound;
+    sfx[SymbolTable::Intern(id)] = pSound;
     return true;
 }
 
 void unloadSound(const string &id)
 {
-    Mix_Chunk *pSound = sfx[id];
+    Mix_Chunk *pSound = getAudioFromId(sfx, id);
 
     if (pSound != NULL)
     {
         Mix_FreeChunk(pSound);
     }
 
-    sfx.erase(id);
+    sfx.erase(SymbolTable::Find(id));
 }
 
 bool preloadDialog(const string &id,SDL_RWops *pFileOps)
@@ -184,9 +198,9 @@ void unloadDialog(const string &id)
 bool playMusic(const string &id)
 {
     if (!audioEnabled) return false;
-    Mix_Music *pMusicA = music[id + "_A"];
+    Mix_Music *pMusicA = getAudioFromId(musicPartA, id);
     if (!pMusicA) return false;
-    Mix_Music *pMusicB = music[id + "_B"];
+    Mix_Music *pMusicB = getAudioFromId(musicPartB, id);
     if (!pMusicB) return false;
     if (currentMusic.length() > 0)
     {
@@ -248,7 +262,7 @@ bool playSound(const string &id)
 bool playSound(const string &id, double volume)
 {
     if (!audioEnabled) return false;
-    Mix_Chunk *pSound = sfx[id];
+    Mix_Chunk *pSound = getAudioFromId(sfx, id);
     if (!pSound) return false;
 
     int setVol = (int)(soundVol * volume * MIX_MAX_VOLUME);
@@ -260,7 +274,7 @@ bool playSound(const string &id, double volume)
 bool playAmbiance(const string &id)
 {
     if (!audioEnabled) return false;
-    Mix_Chunk *pSound = sfx[id];
+    Mix_Chunk *pSound = getAudioFromId(sfx, id);
     if (!pSound) return false;
 
     currentAmbiance = id;
@@ -300,7 +314,7 @@ bool playPartnerAbilityLoop(const string &id)
         return false;
     }
 
-    Mix_Chunk *pSound = sfx[id];
+    Mix_Chunk *pSound = getAudioFromId(sfx, id);
     if (!pSound) return false;
 
     Mix_HaltChannel(PARTNER_ABILITY_LOOP_CHANNEL);
@@ -333,7 +347,7 @@ bool playLoopingSound(const string &id, int relativeChannel)
         return false;
     }
 
-    Mix_Chunk *pSound = sfx[id];
+    Mix_Chunk *pSound = getAudioFromId(sfx, id);
     if (!pSound) return false;
 
     Mix_HaltChannel(SOUND_LOOP_CHANNEL_START + relativeChannel);
@@ -469,11 +483,13 @@ void quitAudio()
         stopAmbiance();
         stopDialog();
         Mix_HaltChannel(-1);
-        for(map<string,Mix_Music*>::const_iterator iter = music.begin(); iter != music.end(); ++iter) Mix_FreeMusic(iter->second);
-        music.clear();
+        for(unordered_map<IdHandle,Mix_Music*>::const_iterator iter = musicPartA.begin(); iter != musicPartA.end(); ++iter) Mix_FreeMusic(iter->second);
+        musicPartA.clear();
+        for(unordered_map<IdHandle,Mix_Music*>::const_iterator iter = musicPartB.begin(); iter != musicPartB.end(); ++iter) Mix_FreeMusic(iter->second);
+        musicPartB.clear();
         for(map<string,Mix_Chunk*>::const_iterator iter = dialog.begin(); iter != dialog.end(); ++iter) Mix_FreeChunk(iter->second);
         dialog.clear();
-        for(map<string,Mix_Chunk*>::const_iterator iter = sfx.begin(); iter != sfx.end(); ++iter) Mix_FreeChunk(iter->second);
+        for(unordered_map<IdHandle,Mix_Chunk*>::const_iterator iter = sfx.begin(); iter != sfx.end(); ++iter) Mix_FreeChunk(iter->second);
         sfx.clear();
         Mix_CloseAudio();
     }